@@ -0,0 +1,204 @@
+extends SceneTree
+
+# Binding overhead benchmark
+#
+# Times the hot TorrentSession/TorrentHandle/TorrentInfo calls through the
+# GDExtension bindings. Result names match tools/micro_benchmark.cpp
+# (`scons micro_benchmark`), which measures the same libtorrent work
+# natively; subtracting the two gives the cost of the binding layer.
+#
+# Usage:
+#   godot --headless --path . -s benchmark/binding_overhead.gd -- [--iterations N] [--files N]
+
+var _iterations := 200
+var _files := 100000
+var _results := []
+var _work_dir := ""
+
+
+func _initialize():
+	var args := OS.get_cmdline_user_args()
+	for i in range(0, args.size() - 1, 2):
+		if args[i] == "--iterations":
+			_iterations = maxi(1, args[i + 1].to_int())
+		elif args[i] == "--files":
+			_files = maxi(1, args[i + 1].to_int())
+
+	_work_dir = OS.get_user_data_dir().path_join("binding_benchmark")
+	DirAccess.make_dir_recursive_absolute(_work_dir)
+
+	var session := TorrentSession.new()
+	session.start_session_with_settings({
+		"listen_interfaces": "127.0.0.1:0",
+		"enable_dht": false,
+		"enable_lsd": false,
+		"enable_upnp": false,
+		"enable_natpmp": false,
+		# error | status | stats
+		"alert_mask": 0x1 | 0x40 | 0x800,
+	})
+
+	printerr("generating torrents...")
+	var handles: Array[TorrentHandle] = []
+	for i in range(100):
+		var torrent := _make_torrent("torrent_%d" % i, 4, 256 * 1024)
+		var handle := session.add_torrent_file(torrent, _work_dir)
+		handle.pause()
+		handles.append(handle)
+
+	_bench_alerts(session, handles)
+	_bench_status(handles[0])
+	_bench_peers(handles[0])
+	_bench_files(session)
+	_bench_parse(session)
+
+	for handle in handles:
+		session.remove_torrent(handle)
+	session.stop_session()
+
+	print(JSON.stringify({
+		"benchmark": "binding",
+		"godot": Engine.get_version_info().string,
+		"iterations": _iterations,
+		"files": _files,
+		"results": _results,
+	}))
+	quit(0)
+
+
+# Times `body` per iteration; `setup` runs first and is not timed.
+# `body` returns the number of items it handled.
+func _measure(name: String, iterations: int, setup: Callable, body: Callable):
+	var samples: Array[float] = []
+	var items := 0
+
+	for i in range(iterations):
+		if setup.is_valid():
+			setup.call()
+		var start := Time.get_ticks_usec()
+		items += body.call()
+		samples.append(float(Time.get_ticks_usec() - start))
+
+	samples.sort()
+	var total := 0.0
+	for sample in samples:
+		total += sample
+
+	var mean := total / iterations
+	var per_call_items := items / iterations
+	_results.append({
+		"name": name,
+		"iterations": iterations,
+		"items": per_call_items,
+		"mean_us": snappedf(mean, 0.001),
+		"median_us": snappedf(samples[samples.size() / 2], 0.001),
+		"p99_us": snappedf(samples[mini(samples.size() - 1, samples.size() * 99 / 100)], 0.001),
+		"per_item_ns": snappedf(mean * 1000.0 / per_call_items, 0.1) if per_call_items > 0 else 0.0,
+	})
+	printerr("%-28s %10.2f us/call" % [name, mean])
+
+
+func _settle():
+	OS.delay_msec(20)
+
+
+func _bench_alerts(session: TorrentSession, handles: Array[TorrentHandle]):
+	var paused := [true]
+	var toggle := func():
+		for handle in handles:
+			if paused[0]:
+				handle.resume()
+			else:
+				handle.pause()
+		paused[0] = not paused[0]
+
+	# get_session_stats() posts a session_stats_alert
+	var post_stats := func():
+		session.get_session_stats()
+		_settle()
+	var post_updates := func():
+		toggle.call()
+		session.post_torrent_updates()
+		_settle()
+	var post_mixed := func():
+		toggle.call()
+		session.post_torrent_updates()
+		session.get_session_stats()
+		_settle()
+	var pop := func():
+		return session.get_alerts().size()
+
+	_settle()
+	session.get_alerts()
+
+	_measure("get_alerts_session_stats", _iterations, post_stats, pop)
+	_measure("get_alerts_state_updates", _iterations, post_updates, pop)
+	_measure("get_alerts_mixed", _iterations, post_mixed, pop)
+	_measure("get_alerts_empty", _iterations * 10, Callable(), pop)
+
+
+func _bench_status(handle: TorrentHandle):
+	_measure("torrent_status", _iterations * 10, Callable(),
+		func(): return 1 if handle.get_status() else 0)
+
+
+func _bench_peers(handle: TorrentHandle):
+	# No peers are connected; this is the call round trip only. The native
+	# get_peer_info_200 result covers the per-peer part.
+	_measure("get_peer_info_call", _iterations * 10, Callable(),
+		func(): return handle.get_peer_info().size())
+
+
+func _bench_files(session: TorrentSession):
+	var handle := session.add_torrent_file(_make_torrent("large", _files, 1024), _work_dir)
+	handle.pause()
+	var info := handle.get_torrent_info()
+
+	_measure("get_files_100k", maxi(1, _iterations / 20), Callable(),
+		func(): return info.get_files().size())
+
+	session.remove_torrent(handle)
+
+
+func _bench_parse(session: TorrentSession):
+	var small := _make_torrent("small", 1, 16 * 1024 * 1024)
+	var added := [null]
+
+	var remove_previous := func():
+		if added[0]:
+			session.remove_torrent(added[0])
+			added[0] = null
+	var add := func():
+		added[0] = session.add_torrent_file(small, _work_dir)
+		return 1 if added[0] else 0
+
+	_measure("add_torrent_file_small", _iterations, remove_previous, add)
+
+	if added[0]:
+		session.remove_torrent(added[0])
+
+
+# v1 torrent with zeroed piece hashes, matching make_torrent() in the native
+# benchmark: 64 KiB pieces, files under <name>/dir_<n>/file_<i>.dat
+func _make_torrent(name: String, num_files: int, file_size: int) -> PackedByteArray:
+	var piece_size := 64 * 1024
+	var total := num_files * file_size
+	var num_pieces := (total + piece_size - 1) / piece_size
+
+	var entries := PackedStringArray()
+	for i in range(num_files):
+		var dir := "dir_%d" % (i / 1000)
+		var file := "file_%d.dat" % i
+		entries.append("d6:lengthi%de4:pathl%d:%s%d:%see" % [file_size, dir.length(), dir, file.length(), file])
+
+	var info := ("d5:filesl%se4:name%d:%s12:piece lengthi%de6:pieces%d:" % [
+		"".join(entries), name.length(), name, piece_size, num_pieces * 20]).to_utf8_buffer()
+	var pieces := PackedByteArray()
+	pieces.resize(num_pieces * 20)
+	info.append_array(pieces)
+	info.append_array("e".to_ascii_buffer())
+
+	var torrent := "d4:info".to_ascii_buffer()
+	torrent.append_array(info)
+	torrent.append_array("e".to_ascii_buffer())
+	return torrent
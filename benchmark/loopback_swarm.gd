@@ -0,0 +1,342 @@
+extends SceneTree
+
+# Loopback swarm benchmark
+#
+# One seeder and N leecher TorrentSessions exchange a synthetic payload over
+# 127.0.0.1 with DHT, LSD, UPnP and NAT-PMP off. Peers are connected
+# directly, so no internet access is needed. Payload, ports and torrent are
+# derived from --seed, so runs are comparable release to release.
+#
+# Usage:
+#   godot --headless --path . -s benchmark/loopback_swarm.gd -- [options]
+#
+# Options:
+#   --leechers N     Number of leecher sessions (default: 4)
+#   --size-mb N      Payload size (default: 64)
+#   --piece-kb N     Piece size, power of two >= 16 (default: 256)
+#   --seed N         Random seed for payload and torrent (default: 1)
+#   --base-port N    Seeder listens here, leechers on the following ports (default: 47100)
+#   --timeout N      Give up after N seconds (default: 300)
+#   --output PATH    Also append the JSON result line to PATH
+
+const BLOCK := 16384
+
+var _options := {
+	"leechers": 4,
+	"size_mb": 64,
+	"piece_kb": 256,
+	"seed": 1,
+	"base_port": 47100,
+	"timeout": 300,
+	"output": "",
+}
+
+var _work_dir := ""
+var _torrent_data: PackedByteArray
+var _seeder: TorrentSession
+var _seeder_handle: TorrentHandle
+var _leechers: Array[TorrentSession] = []
+var _leecher_handles: Array[TorrentHandle] = []
+var _finish_usec: Array[int] = []
+
+var _stage := "seeding"
+var _start_usec := 0
+var _swarm_start_usec := 0
+var _swarm_start_cpu := 0.0
+var _alert_count := 0
+var _payload_size := 0
+
+
+func _initialize():
+	if not _parse_args(OS.get_cmdline_user_args()):
+		_stage = "done"
+		return
+
+	_work_dir = OS.get_user_data_dir().path_join("loopback_swarm")
+	_remove_dir(_work_dir)
+	DirAccess.make_dir_recursive_absolute(_work_dir.path_join("seed"))
+
+	var rng := RandomNumberGenerator.new()
+	rng.seed = _options.seed
+
+	var payload := _make_payload(rng, _options.size_mb * 1024 * 1024)
+	_payload_size = payload.size()
+	var name := "payload_%d.bin" % _options.seed
+
+	var file := FileAccess.open(_work_dir.path_join("seed").path_join(name), FileAccess.WRITE)
+	file.store_buffer(payload)
+	file.close()
+
+	var torrent_data := _make_torrent(payload, name, _options.piece_kb * 1024)
+	payload.clear()
+
+	_seeder = _start_session(_options.base_port)
+	if not _seeder:
+		_fail("seeder session failed to start")
+		return
+
+	_seeder_handle = _seeder.add_torrent_file(torrent_data, _work_dir.path_join("seed"))
+	if not _seeder_handle or not _seeder_handle.is_valid():
+		_fail("seeder could not add torrent")
+		return
+
+	for i in range(_options.leechers):
+		var session := _start_session(_options.base_port + 1 + i)
+		if not session:
+			_fail("leecher %d session failed to start" % i)
+			return
+		_leechers.append(session)
+
+	_torrent_data = torrent_data
+	_start_usec = Time.get_ticks_usec()
+
+
+func _process(_delta: float) -> bool:
+	if _stage == "done":
+		return true
+
+	var now := Time.get_ticks_usec()
+	if (now - _start_usec) / 1000000.0 > _options.timeout:
+		_fail("timed out in stage '%s'" % _stage)
+		return true
+
+	_drain_alerts()
+
+	if _stage == "seeding":
+		# Wait for the seeder to finish checking its files
+		var status := _seeder_handle.get_status()
+		if status and status.is_seeding():
+			_add_leechers()
+			_stage = "swarming"
+	elif _stage == "swarming":
+		var all_done := true
+		for i in range(_leecher_handles.size()):
+			if _finish_usec[i] == 0:
+				var status := _leecher_handles[i].get_status()
+				if status and status.is_finished():
+					_finish_usec[i] = now
+				else:
+					all_done = false
+		if all_done:
+			_report()
+			_shutdown()
+			_stage = "done"
+
+	return _stage == "done"
+
+
+func _add_leechers():
+	_swarm_start_cpu = _cpu_seconds()
+	_swarm_start_usec = Time.get_ticks_usec()
+	_alert_count = 0
+
+	for i in range(_leechers.size()):
+		var save_path := _work_dir.path_join("leecher_%d" % i)
+		DirAccess.make_dir_recursive_absolute(save_path)
+
+		var handle := _leechers[i].add_torrent_file(_torrent_data, save_path)
+		_leecher_handles.append(handle)
+		_finish_usec.append(0)
+
+		# Everyone connects to the seeder and to the leechers before them
+		handle.connect_peer("127.0.0.1", _options.base_port)
+		for j in range(i):
+			handle.connect_peer("127.0.0.1", _options.base_port + 1 + j)
+
+
+func _start_session(port: int) -> TorrentSession:
+	var session := TorrentSession.new()
+	var ok := session.start_session_with_settings({
+		"listen_interfaces": "127.0.0.1:%d" % port,
+		"enable_dht": false,
+		"enable_lsd": false,
+		"enable_upnp": false,
+		"enable_natpmp": false,
+		# All peers share 127.0.0.1
+		"allow_multiple_connections_per_ip": true,
+		# error | storage | status, so alerts/sec reflects a typical app
+		"alert_mask": 0x1 | 0x8 | 0x40,
+	})
+	return session if ok else null
+
+
+func _drain_alerts():
+	if _seeder:
+		_seeder.post_torrent_updates()
+		_alert_count += _seeder.get_alerts().size()
+	for session in _leechers:
+		session.post_torrent_updates()
+		_alert_count += session.get_alerts().size()
+
+
+func _report():
+	var end_usec := Time.get_ticks_usec()
+	var seconds := (end_usec - _swarm_start_usec) / 1000000.0
+	var cpu := -1.0
+	if _swarm_start_cpu >= 0:
+		cpu = _cpu_seconds() - _swarm_start_cpu
+	var total_mb := _payload_size * _leechers.size() / (1024.0 * 1024.0)
+
+	var per_leecher := []
+	for i in range(_finish_usec.size()):
+		per_leecher.append(snappedf((_finish_usec[i] - _swarm_start_usec) / 1000000.0, 0.001))
+
+	var result := {
+		"benchmark": "loopback_swarm",
+		"godot": Engine.get_version_info().string,
+		"leechers": _leechers.size(),
+		"size_bytes": _payload_size,
+		"piece_size": _options.piece_kb * 1024,
+		"seed": _options.seed,
+		"time_to_complete_sec": snappedf(seconds, 0.001),
+		"leecher_complete_sec": per_leecher,
+		"mb_per_sec": snappedf(total_mb / seconds, 0.01) if seconds > 0 else 0.0,
+		"cpu_sec": snappedf(cpu, 0.001) if cpu >= 0 else -1,
+		"cpu_ms_per_mb": snappedf(cpu * 1000.0 / total_mb, 0.01) if cpu >= 0 and total_mb > 0 else -1,
+		"alerts_per_sec": snappedf(_alert_count / seconds, 0.1) if seconds > 0 else 0.0,
+	}
+
+	var line := JSON.stringify(result)
+	print(line)
+
+	if _options.output != "":
+		var out := FileAccess.open(_options.output, FileAccess.READ_WRITE)
+		if not out:
+			out = FileAccess.open(_options.output, FileAccess.WRITE)
+		if out:
+			out.seek_end()
+			out.store_line(line)
+			out.close()
+
+
+func _fail(reason: String):
+	printerr("loopback_swarm: " + reason)
+	_shutdown()
+	_stage = "done"
+	quit(1)
+
+
+func _shutdown():
+	for session in _leechers:
+		session.stop_session()
+	if _seeder:
+		_seeder.stop_session()
+	_leechers.clear()
+	_leecher_handles.clear()
+	_seeder = null
+	_remove_dir(_work_dir)
+
+
+# Payload: one random 1 MiB block, with every 16 KiB block restamped per
+# MiB so pieces differ while generation stays fast in GDScript
+func _make_payload(rng: RandomNumberGenerator, size: int) -> PackedByteArray:
+	var base := PackedByteArray()
+	base.resize(1024 * 1024)
+	for offset in range(0, base.size(), 4):
+		base.encode_u32(offset, rng.randi())
+
+	var payload := PackedByteArray()
+	while payload.size() < size:
+		for offset in range(0, base.size(), BLOCK):
+			base.encode_u32(offset, rng.randi())
+		payload.append_array(base.slice(0, mini(base.size(), size - payload.size())))
+	return payload
+
+
+# Single-file v1 torrent, no trackers (peers are connected directly)
+func _make_torrent(payload: PackedByteArray, name: String, piece_size: int) -> PackedByteArray:
+	var pieces := PackedByteArray()
+	for start in range(0, payload.size(), piece_size):
+		var ctx := HashingContext.new()
+		ctx.start(HashingContext.HASH_SHA1)
+		ctx.update(payload.slice(start, mini(start + piece_size, payload.size())))
+		pieces.append_array(ctx.finish())
+
+	# Keys in sorted order, as bencoding requires
+	var info := PackedByteArray()
+	info.append_array("d".to_ascii_buffer())
+	info.append_array(_bencode_string("length".to_utf8_buffer()))
+	info.append_array(("i%de" % payload.size()).to_ascii_buffer())
+	info.append_array(_bencode_string("name".to_utf8_buffer()))
+	info.append_array(_bencode_string(name.to_utf8_buffer()))
+	info.append_array(_bencode_string("piece length".to_utf8_buffer()))
+	info.append_array(("i%de" % piece_size).to_ascii_buffer())
+	info.append_array(_bencode_string("pieces".to_utf8_buffer()))
+	info.append_array(_bencode_string(pieces))
+	info.append_array("e".to_ascii_buffer())
+
+	var torrent := PackedByteArray()
+	torrent.append_array("d".to_ascii_buffer())
+	torrent.append_array(_bencode_string("info".to_utf8_buffer()))
+	torrent.append_array(info)
+	torrent.append_array("e".to_ascii_buffer())
+	return torrent
+
+
+func _bencode_string(bytes: PackedByteArray) -> PackedByteArray:
+	var out := ("%d:" % bytes.size()).to_ascii_buffer()
+	out.append_array(bytes)
+	return out
+
+
+# Process CPU time (user + system) from /proc; -1 where unavailable
+func _cpu_seconds() -> float:
+	var stat := FileAccess.open("/proc/self/stat", FileAccess.READ)
+	if not stat:
+		return -1.0
+	var text := stat.get_as_text()
+	# Fields after the parenthesised command name; utime and stime are 14 and 15
+	var fields := text.substr(text.rfind(")") + 2).split(" ")
+	if fields.size() < 13:
+		return -1.0
+	return (fields[11].to_int() + fields[12].to_int()) / 100.0
+
+
+func _parse_args(args: PackedStringArray) -> bool:
+	var i := 0
+	while i < args.size():
+		var arg := args[i]
+		if arg == "--help":
+			print("Usage: godot --headless --path . -s benchmark/loopback_swarm.gd -- [--leechers N] [--size-mb N]")
+			print("       [--piece-kb N] [--seed N] [--base-port N] [--timeout N] [--output PATH]")
+			quit(0)
+			return false
+		if i + 1 >= args.size():
+			printerr("loopback_swarm: %s needs a value" % arg)
+			quit(2)
+			return false
+
+		var key := arg.trim_prefix("--").replace("-", "_")
+		if not _options.has(key):
+			printerr("loopback_swarm: unknown option %s" % arg)
+			quit(2)
+			return false
+
+		var value := args[i + 1]
+		if _options[key] is int:
+			if not value.is_valid_int() or value.to_int() <= 0:
+				printerr("loopback_swarm: %s expects a positive number" % arg)
+				quit(2)
+				return false
+			_options[key] = value.to_int()
+		else:
+			_options[key] = value
+		i += 2
+
+	var piece_kb: int = _options.piece_kb
+	if piece_kb < 16 or (piece_kb & (piece_kb - 1)) != 0:
+		printerr("loopback_swarm: --piece-kb must be a power of two >= 16")
+		quit(2)
+		return false
+	return true
+
+
+func _remove_dir(path: String):
+	var dir := DirAccess.open(path)
+	if not dir:
+		return
+	for sub in dir.get_directories():
+		_remove_dir(path.path_join(sub))
+	for file_name in dir.get_files():
+		dir.remove(file_name)
+	DirAccess.remove_absolute(path)
@@ -4,7 +4,8 @@ extends Node
 # Demonstrates running a headless seeding server for content distribution
 
 var session: TorrentSession
-var seeding_torrents: Dictionary = {}  # info_hash -> handle
+var seeding_torrents: Dictionary = {}  # info_hash -> handle (magnet links)
+var pooled_seeds: int = 0  # .torrent files seeded through the session's seed pool
 var config_file_path: String = "user://seeding_server_config.json"
 
 # Server statistics
@@ -49,6 +50,11 @@ func _ready():
 
 	print("\nServer running. Press Ctrl+C to stop.\n")
 
+func _process(_delta):
+	if session:
+		# Also drives the seed pool, loading and unloading pooled torrents
+		session.get_alerts()
+
 func _load_config():
 	# Load seeding configuration
 	if not FileAccess.file_exists(config_file_path):
@@ -78,7 +84,7 @@ func _load_config():
 		for torrent_config in config["torrents"]:
 			_load_torrent(torrent_config)
 
-	print("Loaded %d torrents from config" % seeding_torrents.size())
+	print("Loaded %d torrents and %d pooled seeds from config" % [seeding_torrents.size(), pooled_seeds])
 
 func _create_default_config():
 	var default_config = {
@@ -116,12 +122,14 @@ func _load_torrent(config: Dictionary):
 	if config["type"] == "magnet":
 		handle = session.add_magnet_uri(config["uri"], config["path"])
 	elif config["type"] == "file":
-		if FileAccess.file_exists(config["path"]):
-			var torrent_data = FileAccess.get_file_as_bytes(config["path"])
-			handle = session.add_torrent_file(torrent_data, config["content_path"])
+		# Complete torrents go to the seed pool: the session loads them only
+		# while peers want them, so thousands cost little
+		if session.add_seed(config["path"], config["content_path"]) != "":
+			pooled_seeds += 1
+			print("  ✓ Pooled: " + config["path"])
 		else:
-			print("Warning: Torrent file not found: " + config["path"])
-			return
+			print("  ✗ Failed to pool: " + config["path"])
+		return
 
 	if handle and handle.is_valid():
 		var info_hash = handle.get_info_hash()
@@ -172,6 +180,12 @@ func _update_statistics():
 		print("  Connected peers: %d" % num_peers)
 		print("  Total uploaded: %.2f MB" % (uploaded / 1024.0 / 1024.0))
 
+	var pool = session.get_seed_pool_stats()
+	print("\nSeed pool: %d registered, %d loaded" % [pool["registered"], pool["loaded"]])
+	total_upload_rate += pool["upload_rate"] / 1024.0 / 1024.0
+	total_peers += pool["peers"]
+	total_uploaded_session += pool["total_uploaded"]
+
 	print("\n--- Totals ---")
 	print("Total upload rate: %.2f MB/s" % total_upload_rate)
 	print("Total connected peers: %d" % total_peers)
@@ -0,0 +1,131 @@
+#include "bandwidth_governor.h"
+
+#include <algorithm>
+
+namespace bandwidth_governor {
+
+namespace {
+
+// Weight of the newest frame in the smoothed frame time
+constexpr double SMOOTHING = 0.2;
+
+int scale_rate(int baseline, int reference, int floor, int level) {
+    int base = baseline > 0 ? baseline : reference;
+    int rate = std::max(floor, base >> level);
+    return baseline > 0 ? std::min(rate, baseline) : rate;
+}
+
+} // namespace
+
+Governor::Governor()
+    : _gameplay_active(false)
+    , _level(0)
+    , _smoothed_ms(0.0)
+    , _over_frames(0)
+    , _under_frames(0) {
+}
+
+void Governor::set_config(const Config& config) {
+    _config = config;
+    _config.max_level = std::max(0, std::min(config.max_level, 16));
+    _config.escalate_frames = std::max(1, config.escalate_frames);
+    _config.relax_frames = std::max(1, config.relax_frames);
+    _config.menu_relax_frames = std::max(1, config.menu_relax_frames);
+    _level = std::min(_level, _config.max_level);
+}
+
+const Config& Governor::get_config() const {
+    return _config;
+}
+
+void Governor::set_baseline(const Limits& baseline) {
+    _baseline = baseline;
+}
+
+const Limits& Governor::get_baseline() const {
+    return _baseline;
+}
+
+void Governor::set_gameplay_active(bool active) {
+    if (_gameplay_active != active) {
+        _over_frames = 0;
+        _under_frames = 0;
+    }
+    _gameplay_active = active;
+}
+
+bool Governor::is_gameplay_active() const {
+    return _gameplay_active;
+}
+
+bool Governor::update(double frame_time_ms) {
+    if (frame_time_ms < 0.0) {
+        return false;
+    }
+
+    _smoothed_ms = _smoothed_ms <= 0.0 ? frame_time_ms
+                                       : _smoothed_ms + SMOOTHING * (frame_time_ms - _smoothed_ms);
+
+    int previous = _level;
+
+    if (!_gameplay_active) {
+        _over_frames = 0;
+        if (_level > 0 && ++_under_frames >= _config.menu_relax_frames) {
+            _level--;
+            _under_frames = 0;
+        }
+        return _level != previous;
+    }
+
+    if (_smoothed_ms > _config.frame_budget_ms * _config.high_ratio) {
+        _under_frames = 0;
+        if (++_over_frames >= _config.escalate_frames && _level < _config.max_level) {
+            _level++;
+            _over_frames = 0;
+        }
+    } else if (_smoothed_ms < _config.frame_budget_ms * _config.low_ratio) {
+        _over_frames = 0;
+        if (++_under_frames >= _config.relax_frames && _level > 0) {
+            _level--;
+            _under_frames = 0;
+        }
+    } else {
+        // Inside the band: hold the current level
+        _over_frames = 0;
+        _under_frames = 0;
+    }
+
+    return _level != previous;
+}
+
+void Governor::reset() {
+    _level = 0;
+    _smoothed_ms = 0.0;
+    _over_frames = 0;
+    _under_frames = 0;
+}
+
+int Governor::get_level() const {
+    return _level;
+}
+
+double Governor::get_smoothed_frame_ms() const {
+    return _smoothed_ms;
+}
+
+Limits Governor::limits_for_level(int level) const {
+    if (level <= 0) {
+        return _baseline;
+    }
+
+    Limits limits;
+    limits.download_limit = scale_rate(_baseline.download_limit, _config.reference_rate, _config.min_download_limit, level);
+    limits.upload_limit = scale_rate(_baseline.upload_limit, _config.reference_rate, _config.min_upload_limit, level);
+    limits.connections_limit = std::min(_baseline.connections_limit,
+        std::max(_config.min_connections, _baseline.connections_limit >> level));
+    limits.aio_threads = std::max(1, _baseline.aio_threads >> level);
+    limits.hashing_threads = std::max(1, _baseline.hashing_threads >> level);
+    return limits;
+}
+
+} // namespace bandwidth_governor
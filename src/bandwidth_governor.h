@@ -0,0 +1,81 @@
+#ifndef BANDWIDTH_GOVERNOR_H
+#define BANDWIDTH_GOVERNOR_H
+
+#include <cstdint>
+
+/**
+ * Frame-time driven throttle for downloads running during gameplay.
+ *
+ * Fed one frame time per frame, it keeps a smoothed frame time and moves
+ * between throttle levels with hysteresis: a level is added after the
+ * smoothed time stays over budget for `escalate_frames`, and removed after
+ * it stays comfortably under budget for `relax_frames`. Outside gameplay
+ * (menus, loading screens) it relaxes quickly back to level 0.
+ *
+ * Level 0 is the baseline captured from the session; every further level
+ * halves rate limits, connections and disk/hashing threads, down to the
+ * configured floors.
+ *
+ * Not thread safe; driven from the main loop.
+ */
+
+namespace bandwidth_governor {
+
+struct Config {
+    double frame_budget_ms = 16.7;
+    double high_ratio = 1.0;        // over budget above budget * high_ratio
+    double low_ratio = 0.8;         // under budget below budget * low_ratio
+    int escalate_frames = 8;
+    int relax_frames = 120;
+    int menu_relax_frames = 10;
+    int max_level = 4;
+    int reference_rate = 4 * 1024 * 1024;  // throttle base when the baseline is unlimited
+    int min_download_limit = 64 * 1024;
+    int min_upload_limit = 16 * 1024;
+    int min_connections = 20;
+};
+
+// Session values the governor scales; 0 rate limit means unlimited
+struct Limits {
+    int download_limit = 0;
+    int upload_limit = 0;
+    int connections_limit = 200;
+    int aio_threads = 4;
+    int hashing_threads = 1;
+};
+
+class Governor {
+public:
+    Governor();
+
+    void set_config(const Config& config);
+    const Config& get_config() const;
+
+    void set_baseline(const Limits& baseline);
+    const Limits& get_baseline() const;
+
+    void set_gameplay_active(bool active);
+    bool is_gameplay_active() const;
+
+    // Returns true when the throttle level changed
+    bool update(double frame_time_ms);
+    // Back to level 0 with no frame history
+    void reset();
+
+    int get_level() const;
+    double get_smoothed_frame_ms() const;
+    Limits limits_for_level(int level) const;
+
+private:
+    Config _config;
+    Limits _baseline;
+    bool _gameplay_active;
+    int _level;
+    double _smoothed_ms;
+    int _over_frames;
+    int _under_frames;
+};
+
+} // namespace bandwidth_governor
+
+#endif // BANDWIDTH_GOVERNOR_H
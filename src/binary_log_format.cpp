@@ -0,0 +1,332 @@
+#include "binary_log_format.h"
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+namespace binary_log {
+
+void append_varint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+bool read_varint(const uint8_t*& cursor, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    int shift = 0;
+
+    while (cursor < end && shift < 64) {
+        uint8_t byte = *cursor++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+        shift += 7;
+    }
+
+    return false;
+}
+
+uint64_t zigzag_encode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t zigzag_decode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// ArgEncoder
+
+ArgEncoder::ArgEncoder(uint8_t* buffer, size_t capacity)
+    : _buffer(buffer), _capacity(capacity), _size(0), _count(0), _truncated(false) {
+}
+
+bool ArgEncoder::reserve(size_t bytes) {
+    if (_truncated || _count == 255 || _size + bytes > _capacity) {
+        _truncated = true;
+        return false;
+    }
+    return true;
+}
+
+void ArgEncoder::put_varint(uint64_t value) {
+    while (value >= 0x80) {
+        _buffer[_size++] = static_cast<uint8_t>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    _buffer[_size++] = static_cast<uint8_t>(value);
+}
+
+bool ArgEncoder::add_nil() {
+    if (!reserve(1)) {
+        return false;
+    }
+    _buffer[_size++] = ARG_NIL;
+    _count++;
+    return true;
+}
+
+bool ArgEncoder::add_bool(bool value) {
+    if (!reserve(1)) {
+        return false;
+    }
+    _buffer[_size++] = value ? ARG_TRUE : ARG_FALSE;
+    _count++;
+    return true;
+}
+
+bool ArgEncoder::add_int(int64_t value) {
+    if (!reserve(11)) {
+        return false;
+    }
+    _buffer[_size++] = ARG_INT;
+    put_varint(zigzag_encode(value));
+    _count++;
+    return true;
+}
+
+bool ArgEncoder::add_float(double value) {
+    if (!reserve(9)) {
+        return false;
+    }
+
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    _buffer[_size++] = ARG_FLOAT;
+    for (int i = 0; i < 8; i++) {
+        _buffer[_size++] = static_cast<uint8_t>(bits >> (i * 8));
+    }
+    _count++;
+    return true;
+}
+
+bool ArgEncoder::add_string(const char* data, size_t length) {
+    size_t room = 0;
+    char* dest = begin_string(room);
+    if (!dest) {
+        return false;
+    }
+
+    bool cut = length > room;
+    size_t copy = cut ? room : length;
+
+    // Never split a multi-byte UTF-8 sequence
+    if (cut) {
+        while (copy > 0 && (static_cast<uint8_t>(data[copy]) & 0xC0) == 0x80) {
+            copy--;
+        }
+    }
+
+    std::memcpy(dest, data, copy);
+    commit_string(copy, cut);
+    return true;
+}
+
+char* ArgEncoder::begin_string(size_t& room) {
+    // Tag plus a two byte length prefix (payloads are far below 16 KiB)
+    if (!reserve(3)) {
+        room = 0;
+        return nullptr;
+    }
+
+    room = _capacity - _size - 3;
+    return reinterpret_cast<char*>(_buffer + _size + 3);
+}
+
+void ArgEncoder::commit_string(size_t length, bool truncated) {
+    uint8_t* start = _buffer + _size;
+    start[0] = ARG_STRING;
+
+    if (length < 0x80) {
+        // One byte prefix: slide the data down by one
+        start[1] = static_cast<uint8_t>(length);
+        std::memmove(start + 2, start + 3, length);
+        _size += 2 + length;
+    } else {
+        start[1] = static_cast<uint8_t>((length & 0x7F) | 0x80);
+        start[2] = static_cast<uint8_t>(length >> 7);
+        _size += 3 + length;
+    }
+
+    _count++;
+    if (truncated) {
+        _truncated = true;
+    }
+}
+
+// Decoding
+
+bool decode_args(const uint8_t* payload, size_t length, uint8_t argc, std::vector<DecodedArg>& out) {
+    const uint8_t* cursor = payload;
+    const uint8_t* end = payload + length;
+    out.clear();
+    out.reserve(argc);
+
+    for (uint8_t i = 0; i < argc; i++) {
+        if (cursor >= end) {
+            return false;
+        }
+
+        DecodedArg arg;
+        arg.type = static_cast<ArgType>(*cursor++);
+
+        switch (arg.type) {
+            case ARG_NIL:
+            case ARG_FALSE:
+            case ARG_TRUE:
+                break;
+            case ARG_INT: {
+                uint64_t raw;
+                if (!read_varint(cursor, end, raw)) {
+                    return false;
+                }
+                arg.int_value = zigzag_decode(raw);
+                break;
+            }
+            case ARG_FLOAT: {
+                if (end - cursor < 8) {
+                    return false;
+                }
+                uint64_t bits = 0;
+                for (int b = 0; b < 8; b++) {
+                    bits |= static_cast<uint64_t>(cursor[b]) << (b * 8);
+                }
+                std::memcpy(&arg.float_value, &bits, sizeof(bits));
+                cursor += 8;
+                break;
+            }
+            case ARG_STRING: {
+                uint64_t string_length;
+                if (!read_varint(cursor, end, string_length) ||
+                        string_length > static_cast<uint64_t>(end - cursor)) {
+                    return false;
+                }
+                arg.string_value.assign(reinterpret_cast<const char*>(cursor), string_length);
+                cursor += string_length;
+                break;
+            }
+            default:
+                return false;
+        }
+
+        out.push_back(std::move(arg));
+    }
+
+    return true;
+}
+
+std::string arg_to_string(const DecodedArg& arg) {
+    switch (arg.type) {
+        case ARG_NIL: return "null";
+        case ARG_FALSE: return "false";
+        case ARG_TRUE: return "true";
+        case ARG_INT: return std::to_string(arg.int_value);
+        case ARG_FLOAT: {
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%g", arg.float_value);
+            return buffer;
+        }
+        case ARG_STRING: return arg.string_value;
+        default: return "?";
+    }
+}
+
+std::string format_message(const std::string& format, const std::vector<DecodedArg>& args) {
+    std::string out;
+    out.reserve(format.size() + args.size() * 8);
+
+    size_t next_arg = 0;
+    size_t pos = 0;
+    while (pos < format.size()) {
+        if (format[pos] == '{' && pos + 1 < format.size() && format[pos + 1] == '}' && next_arg < args.size()) {
+            out += arg_to_string(args[next_arg++]);
+            pos += 2;
+        } else {
+            out.push_back(format[pos++]);
+        }
+    }
+
+    // Arguments without a placeholder are still shown
+    for (; next_arg < args.size(); next_arg++) {
+        out.push_back(' ');
+        out += arg_to_string(args[next_arg]);
+    }
+
+    return out;
+}
+
+// Entries
+
+void append_file_header(std::string& out, uint64_t base_time_usec) {
+    out.append(MAGIC, sizeof(MAGIC));
+    out.push_back(static_cast<char>(VERSION));
+    out.push_back(0);
+    out.push_back(0);
+    for (int i = 0; i < 8; i++) {
+        out.push_back(static_cast<char>(base_time_usec >> (i * 8)));
+    }
+}
+
+void append_string_entry(std::string& out, uint32_t id, const std::string& value) {
+    out.push_back(static_cast<char>(TAG_STRING));
+    append_varint(out, id);
+    append_varint(out, value.size());
+    out += value;
+}
+
+void append_record_entry(std::string& out, int64_t delta_usec, uint8_t level_flags,
+        uint32_t category_id, uint32_t format_id, uint8_t argc,
+        const uint8_t* payload, size_t payload_length) {
+    out.push_back(static_cast<char>(TAG_RECORD));
+    append_varint(out, zigzag_encode(delta_usec));
+    out.push_back(static_cast<char>(level_flags));
+    append_varint(out, category_id);
+    append_varint(out, format_id);
+    out.push_back(static_cast<char>(argc));
+    append_varint(out, payload_length);
+    out.append(reinterpret_cast<const char*>(payload), payload_length);
+}
+
+bool read_file_header(const uint8_t* data, size_t length, uint64_t& base_time_usec) {
+    if (length < HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0 || data[5] != VERSION) {
+        return false;
+    }
+
+    base_time_usec = 0;
+    for (int i = 0; i < 8; i++) {
+        base_time_usec |= static_cast<uint64_t>(data[8 + i]) << (i * 8);
+    }
+    return true;
+}
+
+std::string format_timestamp(uint64_t timestamp_usec) {
+    std::time_t seconds = static_cast<std::time_t>(timestamp_usec / 1000000);
+    std::tm local_time;
+#ifdef _WIN32
+    localtime_s(&local_time, &seconds);
+#else
+    localtime_r(&seconds, &local_time);
+#endif
+
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local_time);
+    return buffer;
+}
+
+const char* level_name(uint8_t level) {
+    switch (level & LEVEL_MASK) {
+        case 0: return "NONE";
+        case 1: return "ERROR";
+        case 2: return "WARN";
+        case 3: return "INFO";
+        case 4: return "DEBUG";
+        case 5: return "TRACE";
+        default: return "UNKNOWN";
+    }
+}
+
+} // namespace binary_log
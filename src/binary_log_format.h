@@ -0,0 +1,125 @@
+#ifndef BINARY_LOG_FORMAT_H
+#define BINARY_LOG_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Binary structured log format shared by TorrentLogger and the offline
+ * decoder tool (tools/log_decoder.cpp). Deliberately free of Godot types so
+ * the decoder builds without godot-cpp.
+ *
+ * File layout:
+ *   header  "GTLOG" | version u8 | reserved u16 | base_time_usec u64 (LE)
+ *   entries tag u8 followed by:
+ *     TAG_STRING  varint id | varint length | UTF-8 bytes
+ *     TAG_RECORD  zigzag varint delta_usec | level_flags u8 | varint category_id |
+ *                 varint format_id | argc u8 | varint payload_length | payload
+ *
+ * Strings (formats and category names) are interned: each file defines an id
+ * once, before the first record that references it, so every file (including
+ * rotated ones) decodes on its own. Record timestamps are deltas from the
+ * previous record, starting at the header's base time.
+ *
+ * Payload arguments are a type tag followed by the value. Formats use "{}"
+ * placeholders which are substituted with the arguments in order.
+ */
+namespace binary_log {
+
+constexpr char MAGIC[5] = { 'G', 'T', 'L', 'O', 'G' };
+constexpr uint8_t VERSION = 1;
+constexpr size_t HEADER_SIZE = 16;
+
+enum EntryTag : uint8_t {
+    TAG_STRING = 0x01,
+    TAG_RECORD = 0x02
+};
+
+enum ArgType : uint8_t {
+    ARG_NIL = 0,
+    ARG_FALSE = 1,
+    ARG_TRUE = 2,
+    ARG_INT = 3,    // zigzag varint
+    ARG_FLOAT = 4,  // IEEE 754 double, little endian
+    ARG_STRING = 5  // varint length + UTF-8 bytes
+};
+
+// level_flags: level in the low nibble, flags in the high bits
+constexpr uint8_t LEVEL_MASK = 0x0F;
+constexpr uint8_t FLAG_TRUNCATED = 0x80;
+
+// Varint / zigzag primitives
+void append_varint(std::string& out, uint64_t value);
+bool read_varint(const uint8_t*& cursor, const uint8_t* end, uint64_t& value);
+uint64_t zigzag_encode(int64_t value);
+int64_t zigzag_decode(uint64_t value);
+
+/**
+ * ArgEncoder - Writes typed arguments into a fixed-size payload buffer
+ *
+ * Never allocates. Arguments that do not fit are dropped and the encoder is
+ * marked truncated; the final string argument is cut at a UTF-8 boundary
+ * instead so a long message still keeps its prefix.
+ */
+class ArgEncoder {
+public:
+    ArgEncoder(uint8_t* buffer, size_t capacity);
+
+    bool add_nil();
+    bool add_bool(bool value);
+    bool add_int(int64_t value);
+    bool add_float(double value);
+    bool add_string(const char* data, size_t length);
+
+    // Two-step string encoding for callers that convert in place:
+    // begin_string() returns the destination and room, commit_string()
+    // finalises the length prefix.
+    char* begin_string(size_t& room);
+    void commit_string(size_t length, bool truncated);
+
+    size_t size() const { return _size; }
+    uint8_t count() const { return _count; }
+    bool truncated() const { return _truncated; }
+
+private:
+    uint8_t* _buffer;
+    size_t _capacity;
+    size_t _size;
+    uint8_t _count;
+    bool _truncated;
+
+    bool reserve(size_t bytes);
+    void put_varint(uint64_t value);
+};
+
+struct DecodedArg {
+    ArgType type = ARG_NIL;
+    int64_t int_value = 0;
+    double float_value = 0.0;
+    std::string string_value;
+};
+
+bool decode_args(const uint8_t* payload, size_t length, uint8_t argc, std::vector<DecodedArg>& out);
+std::string arg_to_string(const DecodedArg& arg);
+
+// Substitute "{}" placeholders in order; leftover arguments are appended
+std::string format_message(const std::string& format, const std::vector<DecodedArg>& args);
+
+// Entry encoders
+void append_file_header(std::string& out, uint64_t base_time_usec);
+void append_string_entry(std::string& out, uint32_t id, const std::string& value);
+void append_record_entry(std::string& out, int64_t delta_usec, uint8_t level_flags,
+        uint32_t category_id, uint32_t format_id, uint8_t argc,
+        const uint8_t* payload, size_t payload_length);
+
+bool read_file_header(const uint8_t* data, size_t length, uint64_t& base_time_usec);
+
+// Shared text rendering helpers ("2024-01-31 12:00:00", "WARN")
+std::string format_timestamp(uint64_t timestamp_usec);
+const char* level_name(uint8_t level);
+
+} // namespace binary_log
+
+#endif // BINARY_LOG_FORMAT_H
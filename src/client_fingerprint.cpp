@@ -0,0 +1,269 @@
+#include "client_fingerprint.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+namespace client_fingerprint {
+
+namespace {
+
+struct Client {
+    char code[3];
+    const char* name;
+};
+
+// Sorted by code (ASCII order) for binary search
+constexpr Client AZUREUS_CLIENTS[] = {
+    {"7T", "aTorrent"},
+    {"AG", "Ares"},
+    {"AR", "Arctic Torrent"},
+    {"AT", "Artemis"},
+    {"AV", "Avicora"},
+    {"AX", "BitPump"},
+    {"AZ", "Azureus"},
+    {"BB", "BitBuddy"},
+    {"BC", "BitComet"},
+    {"BE", "baretorrent"},
+    {"BF", "Bitflu"},
+    {"BG", "BTG"},
+    {"BL", "BitBlinder"},
+    {"BR", "BitRocket"},
+    {"BS", "BTSlave"},
+    {"BT", "BitTorrent"},
+    {"BW", "BitWombat"},
+    {"BX", "BittorrentX"},
+    {"CD", "Enhanced CTorrent"},
+    {"CT", "CTorrent"},
+    {"DE", "Deluge"},
+    {"DP", "Propagate Data Client"},
+    {"EB", "EBit"},
+    {"ES", "Electric Sheep"},
+    {"FC", "FileCroc"},
+    {"FT", "FoxTorrent"},
+    {"FW", "FrostWire"},
+    {"FX", "Freebox BitTorrent"},
+    {"GS", "GSTorrent"},
+    {"HL", "Halite"},
+    {"HN", "Hydranode"},
+    {"IL", "iLivid"},
+    {"KG", "KGet"},
+    {"KT", "KTorrent"},
+    {"LC", "LeechCraft"},
+    {"LH", "LH-ABC"},
+    {"LK", "Linkage"},
+    {"LP", "lphant"},
+    {"LT", "libtorrent"},
+    {"LW", "LimeWire"},
+    {"MO", "MonoTorrent"},
+    {"MP", "MooPolice"},
+    {"MR", "Miro"},
+    {"MT", "Moonlight Torrent"},
+    {"NX", "Net Transport"},
+    {"OS", "OneSwarm"},
+    {"OT", "OmegaTorrent"},
+    {"PD", "Pando"},
+    {"QD", "QQDownload"},
+    {"QT", "Qt 4"},
+    {"RT", "Retriever"},
+    {"RZ", "RezTorrent"},
+    {"SB", "Swiftbit"},
+    {"SD", "Xunlei"},
+    {"SK", "spark"},
+    {"SN", "ShareNet"},
+    {"SS", "SwarmScope"},
+    {"ST", "SymTorrent"},
+    {"SZ", "Shareaza"},
+    {"S~", "Shareaza beta"},
+    {"TB", "Torch"},
+    {"TL", "Tribler"},
+    {"TN", "Torrent.NET"},
+    {"TR", "Transmission"},
+    {"TS", "TorrentStorm"},
+    {"TT", "TuoTu"},
+    {"UL", "uLeecher!"},
+    {"UM", "uTorrent Mac"},
+    {"UT", "uTorrent"},
+    {"UW", "uTorrent Web"},
+    {"VG", "Vagaa"},
+    {"WT", "BitLet"},
+    {"WW", "WebTorrent"},
+    {"WY", "FireTorrent"},
+    {"XF", "Xfplay"},
+    {"XL", "Xunlei"},
+    {"XS", "XSwifter"},
+    {"XT", "XanTorrent"},
+    {"XX", "Xtorrent"},
+    {"ZT", "ZipTorrent"},
+    {"lt", "rTorrent"},
+    {"pX", "pHoeniX"},
+    {"qB", "qBittorrent"},
+    {"st", "SharkTorrent"},
+};
+
+constexpr Client SHADOW_CLIENTS[] = {
+    {"A", "ABC"},
+    {"O", "Osprey Permaseed"},
+    {"Q", "BTQueue"},
+    {"R", "Tribler"},
+    {"S", "Shadow"},
+    {"T", "BitTornado"},
+    {"U", "UPnP NAT Bit Torrent"},
+};
+
+constexpr bool code_less(const char* a, const char* b) {
+    return a[0] != b[0] ? a[0] < b[0] : a[1] < b[1];
+}
+
+template <size_t N>
+constexpr bool is_sorted_table(const Client (&table)[N]) {
+    for (size_t i = 1; i < N; i++) {
+        if (!code_less(table[i - 1].code, table[i].code)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(is_sorted_table(AZUREUS_CLIENTS), "Azureus client table must be sorted by code");
+static_assert(is_sorted_table(SHADOW_CLIENTS), "Shadow client table must be sorted by code");
+
+template <size_t N>
+const char* find_client(const Client (&table)[N], char first, char second) {
+    const char key[3] = {first, second, 0};
+    auto it = std::lower_bound(std::begin(table), std::end(table), key, [](const Client& client, const char* code) {
+        return code_less(client.code, code);
+    });
+    if (it == std::end(table) || it->code[0] != first || it->code[1] != second) {
+        return nullptr;
+    }
+    return it->name;
+}
+
+bool is_alnum(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+}
+
+// Azureus style: 0-9, then A-Z and a-z both from 10
+int azureus_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'Z') return c - 'A' + 10;
+    return c - 'a' + 10;
+}
+
+// Shadow style: 0-9, A-Z from 10, a-z from 36, '.' is 62
+int shadow_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'Z') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'z') return c - 'a' + 36;
+    return 62;
+}
+
+// "name 1.2.3", dropping trailing zero components after the second
+std::string format_version(const char* name, const int* parts, int count) {
+    while (count > 2 && parts[count - 1] == 0) {
+        count--;
+    }
+    std::string result = name;
+    for (int i = 0; i < count; i++) {
+        result += i == 0 ? ' ' : '.';
+        result += std::to_string(parts[i]);
+    }
+    return result;
+}
+
+std::string identify_azureus(const char* id) {
+    if (id[0] != '-' || id[7] != '-') {
+        return "";
+    }
+    for (int i = 1; i < 7; i++) {
+        if (!is_alnum(id[i]) && !(i == 2 && id[i] == '~')) {
+            return "";
+        }
+    }
+    const char* name = find_client(AZUREUS_CLIENTS, id[1], id[2]);
+    if (!name) {
+        return "";
+    }
+    int parts[4];
+    for (int i = 0; i < 4; i++) {
+        parts[i] = azureus_digit(id[3 + i]);
+    }
+    return format_version(name, parts, 4);
+}
+
+std::string identify_shadow(const char* id) {
+    if (id[4] != '-' || id[5] != '-') {
+        return "";
+    }
+    for (int i = 1; i < 4; i++) {
+        if (!is_alnum(id[i]) && id[i] != '.') {
+            return "";
+        }
+    }
+    const char* name = find_client(SHADOW_CLIENTS, id[0], 0);
+    if (!name) {
+        return "";
+    }
+    int parts[3];
+    for (int i = 0; i < 3; i++) {
+        parts[i] = shadow_digit(id[1 + i]);
+    }
+    return format_version(name, parts, 3);
+}
+
+constexpr size_t PREFIX_SIZE = 8;
+constexpr size_t MAX_CACHED_PREFIXES = 1024;
+
+struct Cache {
+    std::mutex mutex;
+    // Unknown prefixes are cached too (as empty names)
+    std::unordered_map<uint64_t, std::string> names;
+};
+
+Cache& cache() {
+    static Cache instance;
+    return instance;
+}
+
+} // namespace
+
+std::string identify(const char* peer_id, size_t size) {
+    if (!peer_id || size < PREFIX_SIZE) {
+        return "";
+    }
+    std::string name = identify_azureus(peer_id);
+    if (name.empty()) {
+        name = identify_shadow(peer_id);
+    }
+    return name;
+}
+
+std::string client_name(const libtorrent::peer_info& peer) {
+    const char* id = reinterpret_cast<const char*>(peer.pid.data());
+    uint64_t prefix = 0;
+    std::memcpy(&prefix, id, PREFIX_SIZE);
+
+    std::string name;
+    if (prefix != 0) {
+        Cache& shared = cache();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        auto it = shared.names.find(prefix);
+        if (it != shared.names.end()) {
+            name = it->second;
+        } else {
+            name = identify(id, peer.pid.size());
+            // Random-looking ids would grow it without bound; start over instead
+            if (shared.names.size() >= MAX_CACHED_PREFIXES) {
+                shared.names.clear();
+            }
+            shared.names.emplace(prefix, name);
+        }
+    }
+    return name.empty() ? peer.client : name;
+}
+
+} // namespace client_fingerprint
@@ -0,0 +1,35 @@
+#ifndef CLIENT_FINGERPRINT_H
+#define CLIENT_FINGERPRINT_H
+
+#include <libtorrent/peer_info.hpp>
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Client names from peer ids.
+ *
+ * Recognizes the two common peer id conventions from static tables:
+ * - Azureus style: "-XXnnnn-", a two-letter client code and four version
+ *   characters, e.g. "-qB4520-" is "qBittorrent 4.5.2"
+ * - Shadow style: one client letter and three version characters followed
+ *   by "--", e.g. "S58B--" is "Shadow 5.8.11"
+ *
+ * Peer lists are refreshed many times a second and clients rarely change
+ * between refreshes, so client_name() caches results by the 8-byte id
+ * prefix in a small shared cache (safe from any thread).
+ */
+
+namespace client_fingerprint {
+
+// Name and version, or empty if the id follows neither convention or the
+// client is not in the tables
+std::string identify(const char* peer_id, size_t size);
+
+// identify() through the cache, falling back to the client libtorrent
+// reported (handshake version string) for unrecognized ids
+std::string client_name(const libtorrent::peer_info& peer);
+
+} // namespace client_fingerprint
+
+#endif // CLIENT_FINGERPRINT_H
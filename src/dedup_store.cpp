@@ -0,0 +1,136 @@
+#include "dedup_store.h"
+
+#include <libtorrent/torrent_info.hpp>
+#include <libtorrent/file_storage.hpp>
+
+#include <filesystem>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace dedup {
+
+namespace {
+
+bool is_present(const std::string& path, int64_t size) {
+    std::error_code ec;
+    fs::path file = fs::u8path(path);
+    return fs::is_regular_file(file, ec) && static_cast<int64_t>(fs::file_size(file, ec)) == size && !ec;
+}
+
+} // namespace
+
+DedupStore::DedupStore() : _linked_files(0), _linked_bytes(0) {
+}
+
+int DedupStore::register_torrent(const libtorrent::torrent_info& info, const std::string& save_path,
+                                 const std::vector<bool>& complete) {
+    const libtorrent::file_storage& files = info.files();
+    std::vector<std::vector<std::string>> keys = delta_patch::file_content_keys(info);
+    int registered = 0;
+
+    for (int i = 0; i < files.num_files(); i++) {
+        if (keys[i].empty() || (!complete.empty() && !complete[i])) {
+            continue;
+        }
+
+        libtorrent::file_index_t index(i);
+        Content content;
+        content.path = files.file_path(index, save_path);
+        content.size = files.file_size(index);
+        if (!is_present(content.path, content.size)) {
+            continue;
+        }
+
+        for (const auto& key : keys[i]) {
+            Content existing;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                auto it = _content.find(key);
+                if (it == _content.end()) {
+                    _content[key] = content;
+                    continue;
+                }
+                existing = it->second;
+            }
+
+            // Keep the first copy so later links share one physical file,
+            // unless it is gone
+            if (existing.path != content.path && !is_present(existing.path, existing.size)) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                auto it = _content.find(key);
+                if (it != _content.end() && it->second.path == existing.path) {
+                    it->second = content;
+                }
+            }
+        }
+        registered++;
+    }
+
+    return registered;
+}
+
+std::vector<bool> DedupStore::link_known_files(const libtorrent::torrent_info& info, const std::string& save_path,
+                                               delta_patch::LinkMode mode) {
+    const libtorrent::file_storage& files = info.files();
+    std::vector<std::vector<std::string>> keys = delta_patch::file_content_keys(info);
+    std::vector<bool> ready(files.num_files(), false);
+
+    for (int i = 0; i < files.num_files(); i++) {
+        libtorrent::file_index_t index(i);
+        std::string target = files.file_path(index, save_path);
+
+        for (const auto& key : keys[i]) {
+            Content source;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                auto it = _content.find(key);
+                if (it == _content.end()) {
+                    continue;
+                }
+                source = it->second;
+            }
+
+            if (!is_present(source.path, source.size)) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                auto it = _content.find(key);
+                if (it != _content.end() && it->second.path == source.path) {
+                    _content.erase(it);
+                }
+                continue;
+            }
+
+            std::string method;
+            std::string error;
+            if (delta_patch::link_file(source.path, target, source.size, mode, method, error)) {
+                ready[i] = true;
+                if (method != "existing") {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _linked_files++;
+                    _linked_bytes += source.size;
+                }
+                break;
+            }
+        }
+    }
+
+    return ready;
+}
+
+void DedupStore::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _content.clear();
+    _linked_files = 0;
+    _linked_bytes = 0;
+}
+
+DedupStore::Stats DedupStore::get_stats() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Stats stats;
+    stats.entries = static_cast<int>(_content.size());
+    stats.linked_files = _linked_files;
+    stats.linked_bytes = _linked_bytes;
+    return stats;
+}
+
+} // namespace dedup
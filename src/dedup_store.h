@@ -0,0 +1,73 @@
+#ifndef DEDUP_STORE_H
+#define DEDUP_STORE_H
+
+#include "delta_patch.h"
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Content-addressed index of complete files across all torrents of a session.
+ *
+ * Files are keyed by delta_patch::file_content_keys() (v2 merkle root, or a
+ * digest of the piece hashes of piece-aligned v1 files) and map to one
+ * physical copy on disk. When a torrent is added, files already known are
+ * linked into its save path and their pieces marked as had; with hard links
+ * every torrent then uploads from the same inode and shares its page cache.
+ *
+ * Only the index lives in memory; entries whose file disappeared or changed
+ * size are dropped on lookup.
+ *
+ * Thread safe. Registering and linking touch the disk, so the session runs
+ * them on its file worker; the index lock is never held during file I/O.
+ */
+
+namespace libtorrent {
+    class torrent_info;
+}
+
+namespace dedup {
+
+class DedupStore {
+public:
+    struct Stats {
+        int entries = 0;
+        int linked_files = 0;
+        int64_t linked_bytes = 0;
+    };
+
+    DedupStore();
+
+    // Index the files of a torrent that are present under save_path;
+    // returns how many files were indexed. `complete` (one flag per file)
+    // limits indexing to files known to hold all their data; without it
+    // every file of the right size is trusted.
+    int register_torrent(const libtorrent::torrent_info& info, const std::string& save_path,
+                         const std::vector<bool>& complete = std::vector<bool>());
+
+    // Link known files into the torrent's layout under save_path; returns
+    // one flag per file telling whether it is now complete on disk
+    std::vector<bool> link_known_files(const libtorrent::torrent_info& info, const std::string& save_path,
+                                       delta_patch::LinkMode mode);
+
+    void clear();
+    Stats get_stats() const;
+
+private:
+    struct Content {
+        std::string path;
+        int64_t size = 0;
+    };
+
+    mutable std::mutex _mutex;
+    std::unordered_map<std::string, Content> _content;
+    int _linked_files;
+    int64_t _linked_bytes;
+};
+
+} // namespace dedup
+
+#endif // DEDUP_STORE_H
@@ -0,0 +1,439 @@
+#include "delta_patch.h"
+
+#include <libtorrent/torrent_info.hpp>
+#include <libtorrent/file_storage.hpp>
+#include <libtorrent/hasher.hpp>
+#include <libtorrent/version.hpp>
+
+#include <filesystem>
+#include <map>
+#include <sstream>
+#include <system_error>
+#include <unordered_set>
+#include <utility>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <linux/fs.h>
+#elif defined(__APPLE__)
+#include <sys/clonefile.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace delta_patch {
+
+namespace {
+
+using libtorrent::file_index_t;
+using libtorrent::piece_index_t;
+
+bool is_regular(const libtorrent::file_storage& files, int index) {
+    file_index_t i(index);
+    return !files.pad_file_at(i) &&
+           !(files.file_flags(i) & libtorrent::file_storage::flag_symlink) &&
+           files.file_size(i) > 0;
+}
+
+// The file starts a piece and its last piece contains no bytes of another file
+bool is_piece_isolated(const libtorrent::file_storage& files, int index) {
+    file_index_t i(index);
+    int64_t piece_length = files.piece_length();
+    int64_t offset = files.file_offset(i);
+    int64_t size = files.file_size(i);
+
+    if (offset % piece_length != 0) {
+        return false;
+    }
+    if (size % piece_length == 0 || offset + size == files.total_size()) {
+        return true;
+    }
+    return index + 1 < files.num_files() && files.pad_file_at(file_index_t(index + 1));
+}
+
+int first_piece(const libtorrent::file_storage& files, int index) {
+    return static_cast<int>(files.file_offset(file_index_t(index)) / files.piece_length());
+}
+
+int piece_count(const libtorrent::file_storage& files, int index) {
+    int64_t piece_length = files.piece_length();
+    return static_cast<int>((files.file_size(file_index_t(index)) + piece_length - 1) / piece_length);
+}
+
+bool has_v1_hashes(const libtorrent::torrent_info& info) {
+#if LIBTORRENT_VERSION_NUM >= 20000
+    return info.v1();
+#else
+    (void)info;
+    return true;
+#endif
+}
+
+void match_by_piece_hashes(const libtorrent::torrent_info& next, const libtorrent::torrent_info& previous,
+                           std::vector<bool>& matched, Plan& plan) {
+    const libtorrent::file_storage& next_files = next.files();
+    const libtorrent::file_storage& old_files = previous.files();
+
+    if (!has_v1_hashes(next) || !has_v1_hashes(previous) ||
+        next_files.piece_length() != old_files.piece_length()) {
+        return;
+    }
+
+    // Candidates keyed by size and first piece hash
+    std::map<std::pair<int64_t, libtorrent::sha1_hash>, std::vector<int>> candidates;
+    for (int i = 0; i < old_files.num_files(); i++) {
+        if (is_regular(old_files, i) && is_piece_isolated(old_files, i)) {
+            auto key = std::make_pair(old_files.file_size(file_index_t(i)),
+                                      previous.hash_for_piece(piece_index_t(first_piece(old_files, i))));
+            candidates[key].push_back(i);
+        }
+    }
+
+    for (int i = 0; i < next_files.num_files(); i++) {
+        if (matched[i] || !is_regular(next_files, i) || !is_piece_isolated(next_files, i)) {
+            continue;
+        }
+
+        int64_t size = next_files.file_size(file_index_t(i));
+        int next_first = first_piece(next_files, i);
+        auto it = candidates.find(std::make_pair(size, next.hash_for_piece(piece_index_t(next_first))));
+        if (it == candidates.end()) {
+            continue;
+        }
+
+        int count = piece_count(next_files, i);
+        for (int old_index : it->second) {
+            int old_first = first_piece(old_files, old_index);
+            bool equal = true;
+            for (int p = 1; p < count && equal; p++) {
+                equal = next.hash_for_piece(piece_index_t(next_first + p)) ==
+                        previous.hash_for_piece(piece_index_t(old_first + p));
+            }
+            if (equal) {
+                plan.matches.push_back({i, old_index, size, false});
+                matched[i] = true;
+                break;
+            }
+        }
+    }
+}
+
+#if LIBTORRENT_VERSION_NUM >= 20000
+void match_by_merkle_roots(const libtorrent::torrent_info& next, const libtorrent::torrent_info& previous,
+                           std::vector<bool>& matched, Plan& plan) {
+    if (!next.v2() || !previous.v2()) {
+        return;
+    }
+
+    const libtorrent::file_storage& next_files = next.files();
+    const libtorrent::file_storage& old_files = previous.files();
+
+    std::map<libtorrent::sha256_hash, int> roots;
+    for (int i = 0; i < old_files.num_files(); i++) {
+        if (is_regular(old_files, i)) {
+            roots.emplace(old_files.root(file_index_t(i)), i);
+        }
+    }
+
+    for (int i = 0; i < next_files.num_files(); i++) {
+        if (!is_regular(next_files, i)) {
+            continue;
+        }
+        auto it = roots.find(next_files.root(file_index_t(i)));
+        if (it != roots.end() && old_files.file_size(file_index_t(it->second)) == next_files.file_size(file_index_t(i))) {
+            plan.matches.push_back({i, it->second, next_files.file_size(file_index_t(i)), true});
+            matched[i] = true;
+        }
+    }
+}
+#endif
+
+bool reflink_file(const fs::path& source, const fs::path& target, std::string& error) {
+#if defined(__linux__) && defined(FICLONE)
+    int in = ::open(source.c_str(), O_RDONLY);
+    if (in < 0) {
+        error = "cannot open source";
+        return false;
+    }
+    int out = ::open(target.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (out < 0) {
+        ::close(in);
+        error = "cannot create target";
+        return false;
+    }
+    bool ok = ::ioctl(out, FICLONE, in) == 0;
+    ::close(in);
+    ::close(out);
+    if (!ok) {
+        std::error_code ec;
+        fs::remove(target, ec);
+        error = "filesystem does not support reflinks";
+    }
+    return ok;
+#elif defined(__APPLE__)
+    if (::clonefile(source.c_str(), target.c_str(), 0) == 0) {
+        return true;
+    }
+    error = "filesystem does not support clones";
+    return false;
+#else
+    (void)source;
+    (void)target;
+    error = "reflinks are not supported on this platform";
+    return false;
+#endif
+}
+
+bool stage_file(const fs::path& source, const fs::path& stage, LinkMode mode,
+                std::string& method, std::string& error) {
+    std::error_code ec;
+
+    if (mode == LinkMode::no_hardlink) {
+        if (reflink_file(source, stage, error)) {
+            method = "reflink";
+            return true;
+        }
+        mode = LinkMode::copy;
+    }
+
+    if (mode == LinkMode::automatic || mode == LinkMode::reflink) {
+        if (reflink_file(source, stage, error)) {
+            method = "reflink";
+            return true;
+        }
+        if (mode == LinkMode::reflink) {
+            return false;
+        }
+    }
+
+    if (mode == LinkMode::automatic || mode == LinkMode::hardlink) {
+        fs::create_hard_link(source, stage, ec);
+        if (!ec) {
+            method = "hardlink";
+            return true;
+        }
+        // Typically a different volume
+        error = ec.message();
+        if (mode == LinkMode::hardlink) {
+            return false;
+        }
+        ec.clear();
+    }
+
+    fs::copy_file(source, stage, fs::copy_options::overwrite_existing, ec);
+    if (ec) {
+        error = ec.message();
+        return false;
+    }
+    method = "copy";
+    return true;
+}
+
+} // namespace
+
+bool parse_link_mode(const std::string& name, LinkMode& mode) {
+    if (name == "auto") {
+        mode = LinkMode::automatic;
+    } else if (name == "reflink") {
+        mode = LinkMode::reflink;
+    } else if (name == "hardlink") {
+        mode = LinkMode::hardlink;
+    } else if (name == "copy") {
+        mode = LinkMode::copy;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+Plan plan_patch(const libtorrent::torrent_info& next, const libtorrent::torrent_info& previous) {
+    Plan plan;
+    plan.total_bytes = next.total_size();
+
+    std::vector<bool> matched(next.num_files(), false);
+#if LIBTORRENT_VERSION_NUM >= 20000
+    // Merkle roots identify files regardless of their position in the torrent
+    match_by_merkle_roots(next, previous, matched, plan);
+#endif
+    match_by_piece_hashes(next, previous, matched, plan);
+
+    for (const auto& match : plan.matches) {
+        plan.reused_bytes += match.size;
+    }
+    return plan;
+}
+
+std::vector<PlacedFile> place_files(const Plan& plan,
+    const libtorrent::torrent_info& next, const std::string& next_save_path,
+    const libtorrent::torrent_info& previous, const std::string& previous_save_path,
+    LinkMode mode) {
+    std::vector<PlacedFile> placed;
+    std::vector<std::pair<fs::path, fs::path>> staged;  // stage, destination
+    std::vector<size_t> staged_index;
+
+    // A previous file that is also a path of the new build (patching in
+    // place) will be written by libtorrent if that file changed. A hard link
+    // to it would receive the same writes, corrupting a file already marked
+    // as had, so such sources are reflinked or copied instead.
+    std::unordered_set<std::string> next_paths;
+    if (mode == LinkMode::automatic || mode == LinkMode::hardlink) {
+        for (int i = 0; i < next.num_files(); i++) {
+            std::error_code ec;
+            fs::path path = fs::weakly_canonical(fs::u8path(next.files().file_path(file_index_t(i), next_save_path)), ec);
+            if (!ec) {
+                next_paths.insert(path.string());
+            }
+        }
+    }
+
+    for (const auto& match : plan.matches) {
+        PlacedFile result;
+        result.new_file = match.new_file;
+
+        fs::path source = fs::u8path(previous.files().file_path(file_index_t(match.old_file), previous_save_path));
+        fs::path target = fs::u8path(next.files().file_path(file_index_t(match.new_file), next_save_path));
+
+        LinkMode file_mode = mode;
+        if (!next_paths.empty()) {
+            std::error_code ec;
+            fs::path canonical = fs::weakly_canonical(source, ec);
+            if (ec || next_paths.count(canonical.string())) {
+                file_mode = LinkMode::no_hardlink;
+            }
+        }
+
+        std::error_code ec;
+        if (!fs::is_regular_file(source, ec) || static_cast<int64_t>(fs::file_size(source, ec)) != match.size || ec) {
+            result.error = "previous file is missing or has a different size";
+            placed.push_back(result);
+            continue;
+        }
+
+        if (fs::exists(target, ec) && fs::equivalent(source, target, ec)) {
+            result.ok = true;
+            result.method = "existing";
+            placed.push_back(result);
+            continue;
+        }
+
+        fs::create_directories(target.parent_path(), ec);
+        fs::path stage = target;
+        stage += ".delta_patch";
+        fs::remove(stage, ec);
+
+        if (stage_file(source, stage, file_mode, result.method, result.error)) {
+            staged.emplace_back(stage, target);
+            staged_index.push_back(placed.size());
+        }
+        placed.push_back(result);
+    }
+
+    // Every source has been read; now it is safe to replace destinations
+    for (size_t i = 0; i < staged.size(); i++) {
+        std::error_code ec;
+        fs::rename(staged[i].first, staged[i].second, ec);
+        PlacedFile& result = placed[staged_index[i]];
+        if (ec) {
+            fs::remove(staged[i].first, ec);
+            result.error = "could not move file into place";
+        } else {
+            result.ok = true;
+            result.error.clear();
+        }
+    }
+
+    return placed;
+}
+
+bool link_file(const std::string& source, const std::string& target, int64_t size,
+    LinkMode mode, std::string& method, std::string& error) {
+    fs::path source_path = fs::u8path(source);
+    fs::path target_path = fs::u8path(target);
+
+    std::error_code ec;
+    if (!fs::is_regular_file(source_path, ec) || static_cast<int64_t>(fs::file_size(source_path, ec)) != size || ec) {
+        error = "source file is missing or has a different size";
+        return false;
+    }
+
+    if (fs::exists(target_path, ec) && fs::equivalent(source_path, target_path, ec)) {
+        method = "existing";
+        return true;
+    }
+
+    fs::create_directories(target_path.parent_path(), ec);
+    fs::path stage = target_path;
+    stage += ".delta_patch";
+    fs::remove(stage, ec);
+
+    if (!stage_file(source_path, stage, mode, method, error)) {
+        return false;
+    }
+
+    fs::rename(stage, target_path, ec);
+    if (ec) {
+        fs::remove(stage, ec);
+        error = "could not move file into place";
+        return false;
+    }
+    return true;
+}
+
+std::vector<std::vector<std::string>> file_content_keys(const libtorrent::torrent_info& info) {
+    const libtorrent::file_storage& files = info.files();
+    std::vector<std::vector<std::string>> keys(files.num_files());
+
+    for (int i = 0; i < files.num_files(); i++) {
+        if (!is_regular(files, i)) {
+            continue;
+        }
+        int64_t size = files.file_size(file_index_t(i));
+
+#if LIBTORRENT_VERSION_NUM >= 20000
+        if (info.v2()) {
+            std::stringstream ss;
+            ss << "v2:" << size << ":" << files.root(file_index_t(i));
+            keys[i].push_back(ss.str());
+        }
+#endif
+
+        if (has_v1_hashes(info) && is_piece_isolated(files, i)) {
+            libtorrent::hasher digest;
+            int first = first_piece(files, i);
+            int count = piece_count(files, i);
+            for (int p = 0; p < count; p++) {
+                libtorrent::sha1_hash hash = info.hash_for_piece(piece_index_t(first + p));
+                digest.update(hash.data(), static_cast<int>(hash.size()));
+            }
+
+            std::stringstream ss;
+            ss << "v1:" << files.piece_length() << ":" << size << ":" << digest.final();
+            keys[i].push_back(ss.str());
+        }
+    }
+
+    return keys;
+}
+
+std::vector<bool> covered_pieces(const libtorrent::file_storage& files, const std::vector<bool>& file_ready) {
+    std::vector<bool> pieces(files.num_pieces(), false);
+
+    for (int p = 0; p < files.num_pieces(); p++) {
+        piece_index_t piece(p);
+        bool covered = true;
+        for (const auto& slice : files.map_block(piece, 0, files.piece_size(piece))) {
+            int index = static_cast<int>(slice.file_index);
+            if (slice.size > 0 && !files.pad_file_at(slice.file_index) && !file_ready[index]) {
+                covered = false;
+                break;
+            }
+        }
+        pieces[p] = covered;
+    }
+
+    return pieces;
+}
+
+} // namespace delta_patch
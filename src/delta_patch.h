@@ -0,0 +1,86 @@
+#ifndef DELTA_PATCH_H
+#define DELTA_PATCH_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Delta patching between two builds of the same content.
+ *
+ * Files of the new torrent that are byte-identical to files of the previous
+ * one are found from the torrents alone, without reading any data:
+ * - v2 (libtorrent 2.0): equal per-file merkle roots
+ * - v1: equal piece hashes, when both files start on a piece boundary, use
+ *   the same piece size and their last piece holds no bytes of another file
+ *
+ * Matched files are placed at their new location by reflink, hard link or
+ * copy, and every piece made up only of matched files (or padding) can be
+ * marked as had, so only changed data is downloaded.
+ */
+
+namespace libtorrent {
+    class torrent_info;
+    class file_storage;
+}
+
+namespace delta_patch {
+
+struct FileMatch {
+    int new_file = 0;
+    int old_file = 0;
+    int64_t size = 0;
+    bool by_merkle_root = false;
+};
+
+struct Plan {
+    std::vector<FileMatch> matches;
+    int64_t total_bytes = 0;
+    int64_t reused_bytes = 0;
+};
+
+enum class LinkMode {
+    automatic,  // reflink, then hard link, then copy
+    reflink,
+    hardlink,
+    copy,
+    no_hardlink // reflink, then copy
+};
+
+// Parses "auto", "reflink", "hardlink" or "copy"; false for anything else
+bool parse_link_mode(const std::string& name, LinkMode& mode);
+
+Plan plan_patch(const libtorrent::torrent_info& next, const libtorrent::torrent_info& previous);
+
+struct PlacedFile {
+    int new_file = 0;
+    bool ok = false;
+    std::string method;  // "existing", "reflink", "hardlink" or "copy"
+    std::string error;
+};
+
+// Puts every matched file at its path under next_save_path. All files are
+// first staged next to their destination and only then renamed into place,
+// so patching in place works even when files swap names. Sources that are
+// also paths of the new build are never hard linked. Reads and copies whole
+// files; keep it off the main thread.
+std::vector<PlacedFile> place_files(const Plan& plan,
+    const libtorrent::torrent_info& next, const std::string& next_save_path,
+    const libtorrent::torrent_info& previous, const std::string& previous_save_path,
+    LinkMode mode);
+
+// Places a single file the same way; `size` guards against a changed source
+bool link_file(const std::string& source, const std::string& target, int64_t size,
+    LinkMode mode, std::string& method, std::string& error);
+
+// Content identities of every file: "v2:<size>:<merkle root>" and/or
+// "v1:<piece size>:<size>:<digest of its piece hashes>". Files that cannot be
+// identified without reading them get no keys.
+std::vector<std::vector<std::string>> file_content_keys(const libtorrent::torrent_info& info);
+
+// Pieces of `files` covered entirely by ready files and pad files
+std::vector<bool> covered_pieces(const libtorrent::file_storage& files, const std::vector<bool>& file_ready);
+
+} // namespace delta_patch
+
+#endif // DELTA_PATCH_H
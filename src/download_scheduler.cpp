@@ -0,0 +1,406 @@
+#include "download_scheduler.h"
+
+#include <libtorrent/torrent_info.hpp>
+#include <libtorrent/torrent_status.hpp>
+#include <libtorrent/torrent_flags.hpp>
+#include <libtorrent/version.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+
+namespace scheduler {
+
+namespace {
+
+constexpr int64_t REFRESH_INTERVAL_USEC = 1000000;
+
+// Wishes this close to the front of the plan get top file priority
+constexpr int TOP_PRIORITY_WISHES = 8;
+
+std::string info_hash_hex(const libtorrent::torrent_handle& handle) {
+    std::stringstream ss;
+#if LIBTORRENT_VERSION_NUM >= 20000
+    ss << handle.info_hashes().get_best();
+#else
+    ss << handle.info_hash();
+#endif
+    return ss.str();
+}
+
+} // namespace
+
+const char* state_name(DownloadScheduler::State state) {
+    switch (state) {
+        case DownloadScheduler::State::waiting: return "waiting";
+        case DownloadScheduler::State::active: return "active";
+        case DownloadScheduler::State::done: return "done";
+    }
+    return "unknown";
+}
+
+DownloadScheduler::DownloadScheduler()
+    : _max_active(3)
+    , _max_deadline_pieces(256)
+    , _last_refresh_usec(0) {
+}
+
+void DownloadScheduler::set_wishlist(const std::vector<Wish>& wishes, int64_t now_usec) {
+    _entries.clear();
+    _entries.reserve(wishes.size());
+
+    for (size_t i = 0; i < wishes.size(); i++) {
+        if (!wishes[i].handle.is_valid()) {
+            continue;
+        }
+        Entry entry;
+        entry.wish = wishes[i];
+        entry.order = i;
+        entry.info_hash = info_hash_hex(wishes[i].handle);
+        _entries.push_back(entry);
+    }
+
+    // Earliest need first; list order breaks ties and orders untimed wishes
+    std::stable_sort(_entries.begin(), _entries.end(), [](const Entry& a, const Entry& b) {
+        return a.wish.needed_by_usec < b.wish.needed_by_usec;
+    });
+
+    refresh_progress(nullptr);
+    plan(now_usec);
+    _last_refresh_usec = now_usec;
+}
+
+void DownloadScheduler::clear() {
+    for (auto& scheduled : _scheduled) {
+        release(scheduled);
+    }
+    _scheduled.clear();
+    _entries.clear();
+}
+
+void DownloadScheduler::reset() {
+    _scheduled.clear();
+    _entries.clear();
+    _last_refresh_usec = 0;
+}
+
+void DownloadScheduler::set_max_active(int max_active) {
+    _max_active = std::max(1, max_active);
+}
+
+int DownloadScheduler::get_max_active() const {
+    return _max_active;
+}
+
+void DownloadScheduler::set_max_deadline_pieces(int pieces) {
+    _max_deadline_pieces = std::max(0, pieces);
+}
+
+int DownloadScheduler::get_max_deadline_pieces() const {
+    return _max_deadline_pieces;
+}
+
+std::vector<DownloadScheduler::Completed> DownloadScheduler::update(int64_t now_usec) {
+    std::vector<Completed> completed;
+
+    if (_entries.empty() || now_usec - _last_refresh_usec < REFRESH_INTERVAL_USEC) {
+        return completed;
+    }
+    _last_refresh_usec = now_usec;
+
+    if (refresh_progress(&completed)) {
+        plan(now_usec);
+    }
+    return completed;
+}
+
+void DownloadScheduler::replan(int64_t now_usec) {
+    plan(now_usec);
+}
+
+void DownloadScheduler::on_metadata_received(const libtorrent::torrent_handle& handle, int64_t now_usec) {
+    for (const auto& entry : _entries) {
+        if (!entry.done && entry.wish.handle == handle) {
+            plan(now_usec);
+            return;
+        }
+    }
+}
+
+std::vector<DownloadScheduler::WishStatus> DownloadScheduler::get_status(int64_t now_usec) const {
+    std::vector<WishStatus> status;
+    status.reserve(_entries.size());
+
+    for (const auto& entry : _entries) {
+        WishStatus wish;
+        wish.info_hash = entry.info_hash;
+        wish.file_index = entry.wish.file_index;
+        wish.needed_in_usec = entry.wish.needed_by_usec == NO_DEADLINE
+            ? NO_DEADLINE : entry.wish.needed_by_usec - now_usec;
+        wish.progress = entry.progress;
+        wish.state = entry.done ? State::done : (entry.active ? State::active : State::waiting);
+        wish.deadline_pieces = entry.deadline_pieces;
+        status.push_back(wish);
+    }
+
+    return status;
+}
+
+DownloadScheduler::Scheduled* DownloadScheduler::find_scheduled(const libtorrent::torrent_handle& handle) {
+    for (auto& scheduled : _scheduled) {
+        if (scheduled.handle == handle) {
+            return &scheduled;
+        }
+    }
+    return nullptr;
+}
+
+DownloadScheduler::Scheduled& DownloadScheduler::schedule(const libtorrent::torrent_handle& handle) {
+    Scheduled* existing = find_scheduled(handle);
+    if (existing) {
+        return *existing;
+    }
+
+    Scheduled scheduled;
+    scheduled.handle = handle;
+    scheduled.was_auto_managed = static_cast<bool>(handle.flags() & libtorrent::torrent_flags::auto_managed);
+    _scheduled.push_back(scheduled);
+    return _scheduled.back();
+}
+
+void DownloadScheduler::release(Scheduled& scheduled) {
+    if (!scheduled.handle.is_valid()) {
+        return;
+    }
+
+    try {
+        if (scheduled.has_deadlines) {
+            scheduled.handle.clear_piece_deadlines();
+        }
+        if (scheduled.has_priorities) {
+            scheduled.handle.prioritize_files(scheduled.original_priorities);
+        }
+        if (scheduled.was_auto_managed) {
+            scheduled.handle.set_flags(libtorrent::torrent_flags::auto_managed);
+        } else {
+            scheduled.handle.unset_flags(libtorrent::torrent_flags::auto_managed);
+        }
+    } catch (const std::exception&) {
+        // The torrent is being removed; nothing left to restore
+    }
+}
+
+bool DownloadScheduler::refresh_progress(std::vector<Completed>* completed) {
+    bool changed = false;
+
+    // file_progress() is a round trip to the network thread; once per torrent
+    std::vector<std::pair<libtorrent::torrent_handle, std::vector<int64_t>>> file_progress;
+
+    for (auto& entry : _entries) {
+        if (entry.done) {
+            continue;
+        }
+
+        const libtorrent::torrent_handle& handle = entry.wish.handle;
+        if (!handle.is_valid()) {
+            // Removed torrents leave the plan without completing
+            entry.done = true;
+            changed = true;
+            continue;
+        }
+
+        try {
+            if (entry.wish.file_index < 0) {
+                libtorrent::torrent_status st = handle.status();
+                entry.progress = st.progress;
+                entry.done = st.is_finished;
+            } else {
+                auto info = handle.torrent_file();
+                if (!info || entry.wish.file_index >= info->num_files()) {
+                    continue;
+                }
+
+                auto it = std::find_if(file_progress.begin(), file_progress.end(),
+                    [&](const auto& item) { return item.first == handle; });
+                if (it == file_progress.end()) {
+                    std::vector<int64_t> progress;
+                    handle.file_progress(progress, libtorrent::torrent_handle::piece_granularity);
+                    file_progress.emplace_back(handle, std::move(progress));
+                    it = std::prev(file_progress.end());
+                }
+
+                libtorrent::file_index_t file(entry.wish.file_index);
+                int64_t size = info->files().file_size(file);
+                int64_t have = static_cast<size_t>(entry.wish.file_index) < it->second.size()
+                    ? it->second[entry.wish.file_index] : 0;
+                entry.progress = size > 0 ? static_cast<double>(have) / size : 1.0;
+                entry.done = have >= size;
+            }
+        } catch (const std::exception&) {
+            continue;
+        }
+
+        if (entry.done) {
+            changed = true;
+            entry.active = false;
+            entry.deadline_pieces = 0;
+            if (completed) {
+                completed->push_back({entry.info_hash, entry.wish.file_index});
+            }
+        }
+    }
+
+    return changed;
+}
+
+void DownloadScheduler::plan(int64_t now_usec) {
+    std::vector<Entry*> pending;
+    for (auto& entry : _entries) {
+        entry.active = false;
+        entry.deadline_pieces = 0;
+        if (!entry.done && entry.wish.handle.is_valid()) {
+            pending.push_back(&entry);
+        }
+    }
+
+    // Torrents in the order their first pending wish is needed
+    std::vector<libtorrent::torrent_handle> order;
+    for (Entry* entry : pending) {
+        if (std::find(order.begin(), order.end(), entry->wish.handle) == order.end()) {
+            order.push_back(entry->wish.handle);
+        }
+    }
+
+    // Torrents that left the plan go back to how they were
+    for (auto& scheduled : _scheduled) {
+        if (std::find(order.begin(), order.end(), scheduled.handle) == order.end()) {
+            release(scheduled);
+        }
+    }
+    _scheduled.erase(std::remove_if(_scheduled.begin(), _scheduled.end(), [&](const Scheduled& scheduled) {
+        return std::find(order.begin(), order.end(), scheduled.handle) == order.end();
+    }), _scheduled.end());
+
+    for (size_t i = 0; i < order.size(); i++) {
+        const libtorrent::torrent_handle& handle = order[i];
+
+        try {
+            Scheduled& scheduled = schedule(handle);
+
+            if (scheduled.has_deadlines) {
+                handle.clear_piece_deadlines();
+                scheduled.has_deadlines = false;
+            }
+
+            scheduled.forced = static_cast<int>(i) < _max_active;
+            if (scheduled.forced) {
+                // Paused outside of auto-management means the user paused it
+                libtorrent::torrent_flags_t flags = handle.flags();
+                bool user_paused = (flags & libtorrent::torrent_flags::paused)
+                    && !(flags & libtorrent::torrent_flags::auto_managed);
+                handle.unset_flags(libtorrent::torrent_flags::auto_managed);
+                if (!user_paused) {
+                    handle.resume();
+                }
+            } else {
+                handle.set_flags(libtorrent::torrent_flags::auto_managed);
+            }
+
+            auto info = handle.torrent_file();
+            if (!info) {
+                continue;
+            }
+
+            if (!scheduled.has_priorities) {
+                scheduled.original_priorities = handle.get_file_priorities();
+                scheduled.has_priorities = true;
+            }
+
+            // Unwished files keep trickling in at low priority, skipped ones stay skipped
+            std::vector<libtorrent::download_priority_t> priorities = scheduled.original_priorities;
+            priorities.resize(info->num_files(), libtorrent::default_priority);
+            bool whole_torrent = false;
+            for (size_t rank = 0; rank < pending.size(); rank++) {
+                if (pending[rank]->wish.handle == handle && pending[rank]->wish.file_index < 0) {
+                    whole_torrent = true;
+                }
+            }
+            for (auto& priority : priorities) {
+                if (priority != libtorrent::dont_download) {
+                    priority = whole_torrent ? libtorrent::default_priority : libtorrent::low_priority;
+                }
+            }
+            for (size_t rank = 0; rank < pending.size(); rank++) {
+                const Wish& wish = pending[rank]->wish;
+                if (wish.handle == handle && wish.file_index >= 0 && wish.file_index < info->num_files()) {
+                    priorities[wish.file_index] = static_cast<int>(rank) < TOP_PRIORITY_WISHES
+                        ? libtorrent::top_priority : libtorrent::download_priority_t{6};
+                }
+            }
+            handle.prioritize_files(priorities);
+        } catch (const std::exception&) {
+            // Picked up as an invalid handle on the next refresh
+        }
+    }
+
+    // Queued (not forced) torrents move to the front of the libtorrent queue in plan order
+    size_t forced_count = std::min(order.size(), static_cast<size_t>(_max_active));
+    for (size_t i = order.size(); i > forced_count; i--) {
+        try {
+            order[i - 1].queue_position_top();
+        } catch (const std::exception&) {
+            // Picked up as an invalid handle on the next refresh
+        }
+    }
+
+    int budget = _max_deadline_pieces;
+    for (Entry* entry : pending) {
+        Scheduled* scheduled = find_scheduled(entry->wish.handle);
+        entry->active = scheduled && scheduled->forced;
+        if (!entry->active || entry->wish.needed_by_usec == NO_DEADLINE || budget <= 0) {
+            continue;
+        }
+
+        try {
+            const libtorrent::torrent_handle& handle = entry->wish.handle;
+            auto info = handle.torrent_file();
+            if (!info) {
+                continue;
+            }
+
+            int first = 0;
+            int last = info->num_pieces() - 1;
+            if (entry->wish.file_index >= 0) {
+                if (entry->wish.file_index >= info->num_files()) {
+                    continue;
+                }
+                libtorrent::file_index_t file(entry->wish.file_index);
+                int64_t size = info->files().file_size(file);
+                if (size == 0) {
+                    continue;
+                }
+                first = static_cast<int>(info->files().map_file(file, 0, 1).piece);
+                last = static_cast<int>(info->files().map_file(file, size - 1, 1).piece);
+            }
+
+            libtorrent::torrent_status st = handle.status(libtorrent::torrent_handle::query_pieces);
+            int64_t deadline_ms = std::max<int64_t>(0, (entry->wish.needed_by_usec - now_usec) / 1000);
+
+            // One extra millisecond per piece keeps the file downloading front to back
+            for (int piece = first; piece <= last && budget > 0; piece++) {
+                libtorrent::piece_index_t index(piece);
+                if (!st.pieces.empty() && st.pieces.get_bit(index)) {
+                    continue;
+                }
+                handle.set_piece_deadline(index, static_cast<int>(std::min<int64_t>(deadline_ms + entry->deadline_pieces, INT32_MAX)));
+                entry->deadline_pieces++;
+                budget--;
+            }
+            scheduled->has_deadlines = scheduled->has_deadlines || entry->deadline_pieces > 0;
+        } catch (const std::exception&) {
+            continue;
+        }
+    }
+}
+
+} // namespace scheduler
@@ -0,0 +1,126 @@
+#ifndef DOWNLOAD_SCHEDULER_H
+#define DOWNLOAD_SCHEDULER_H
+
+#include <libtorrent/torrent_handle.hpp>
+#include <libtorrent/download_priority.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Session-wide download order across torrents.
+ *
+ * Takes one ordered wish list of (torrent, file, needed-by time) entries;
+ * wishes are served by needed-by time, then by list order. Each plan:
+ * - forces the torrents holding the first `max_active` unfinished wishes
+ *   active (out of auto-management) and moves the remaining wished
+ *   torrents to the top of the libtorrent queue in wish order
+ * - raises wished files to high priority and drops the other files of a
+ *   wished torrent to low priority
+ * - gives the missing pieces of timed wishes in forced torrents piece
+ *   deadlines, up to `max_deadline_pieces` in total
+ *
+ * Replacing the list re-plans immediately; otherwise the plan is refreshed
+ * whenever a wish completes or a wished magnet receives its metadata (file
+ * priorities and deadlines need the file table). Torrents that leave the
+ * plan get their file priorities and auto-managed flag back. A forced
+ * torrent the user paused stays paused.
+ *
+ * Not thread safe; the session drives it from the thread polling alerts.
+ */
+
+namespace scheduler {
+
+class DownloadScheduler {
+public:
+    static constexpr int64_t NO_DEADLINE = INT64_MAX;
+
+    struct Wish {
+        libtorrent::torrent_handle handle;
+        int file_index = -1;                    // -1 wants the whole torrent
+        int64_t needed_by_usec = NO_DEADLINE;   // same clock as update()
+    };
+
+    enum class State {
+        waiting,
+        active,
+        done
+    };
+
+    struct WishStatus {
+        std::string info_hash;
+        int file_index = -1;
+        int64_t needed_in_usec = NO_DEADLINE;
+        double progress = 0.0;
+        State state = State::waiting;
+        int deadline_pieces = 0;
+    };
+
+    struct Completed {
+        std::string info_hash;
+        int file_index = -1;
+    };
+
+    DownloadScheduler();
+
+    // Replaces the wish list and plans at once
+    void set_wishlist(const std::vector<Wish>& wishes, int64_t now_usec);
+    // Drops every wish and restores all scheduled torrents
+    void clear();
+    // Forget everything without touching the torrents (session shutdown)
+    void reset();
+
+    void set_max_active(int max_active);
+    int get_max_active() const;
+    void set_max_deadline_pieces(int pieces);
+    int get_max_deadline_pieces() const;
+
+    // Refreshes progress (at most once a second) and re-plans on completion
+    std::vector<Completed> update(int64_t now_usec);
+    // Plans again now, e.g. after changing the limits
+    void replan(int64_t now_usec);
+    // Plans again if the torrent holds a pending wish (metadata_received_alert)
+    void on_metadata_received(const libtorrent::torrent_handle& handle, int64_t now_usec);
+
+    std::vector<WishStatus> get_status(int64_t now_usec) const;
+
+private:
+    struct Entry {
+        Wish wish;
+        size_t order = 0;
+        std::string info_hash;
+        double progress = 0.0;
+        bool done = false;
+        bool active = false;
+        int deadline_pieces = 0;
+    };
+
+    struct Scheduled {
+        libtorrent::torrent_handle handle;
+        bool was_auto_managed = false;
+        bool forced = false;
+        bool has_deadlines = false;
+        bool has_priorities = false;
+        std::vector<libtorrent::download_priority_t> original_priorities;
+    };
+
+    std::vector<Entry> _entries;
+    std::vector<Scheduled> _scheduled;
+    int _max_active;
+    int _max_deadline_pieces;
+    int64_t _last_refresh_usec;
+
+    Scheduled* find_scheduled(const libtorrent::torrent_handle& handle);
+    Scheduled& schedule(const libtorrent::torrent_handle& handle);
+    void release(Scheduled& scheduled);
+    // Returns true if a wish finished since the last refresh
+    bool refresh_progress(std::vector<Completed>* completed);
+    void plan(int64_t now_usec);
+};
+
+const char* state_name(DownloadScheduler::State state);
+
+} // namespace scheduler
+
+#endif // DOWNLOAD_SCHEDULER_H
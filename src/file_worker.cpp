@@ -0,0 +1,89 @@
+#include "file_worker.h"
+
+namespace file_worker {
+
+FileWorker::FileWorker()
+    : _running(false)
+    , _busy(false) {
+}
+
+FileWorker::~FileWorker() {
+    stop();
+}
+
+void FileWorker::post(Task job, Task completion) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _queue.push_back({std::move(job), std::move(completion)});
+
+    if (!_running) {
+        // A previous stop() has already joined the old thread
+        _running = true;
+        _thread = std::thread(&FileWorker::run, this);
+    }
+    _cv.notify_one();
+}
+
+int FileWorker::poll() {
+    std::vector<Task> completed;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        completed.swap(_completed);
+    }
+
+    for (auto& completion : completed) {
+        if (completion) {
+            completion();
+        }
+    }
+    return static_cast<int>(completed.size());
+}
+
+int FileWorker::pending() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return static_cast<int>(_queue.size() + _completed.size()) + (_busy ? 1 : 0);
+}
+
+void FileWorker::stop() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _running = false;
+        _queue.clear();
+    }
+    _cv.notify_one();
+
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _completed.clear();
+}
+
+void FileWorker::run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _cv.wait(lock, [this] { return !_running || !_queue.empty(); });
+        if (!_running) {
+            break;
+        }
+
+        Item item = std::move(_queue.front());
+        _queue.pop_front();
+        _busy = true;
+
+        lock.unlock();
+        try {
+            if (item.job) {
+                item.job();
+            }
+        } catch (...) {
+            // Jobs report their own errors; never let one end the thread
+        }
+        lock.lock();
+
+        _busy = false;
+        _completed.push_back(std::move(item.completion));
+    }
+}
+
+} // namespace file_worker
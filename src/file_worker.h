@@ -0,0 +1,61 @@
+#ifndef FILE_WORKER_H
+#define FILE_WORKER_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Background thread for file work the main thread must not wait on, such
+ * as copying or linking whole files and stat()ing every file of a torrent.
+ *
+ * Jobs run one at a time in the order they were posted. Each job comes with
+ * a completion that runs on the thread calling poll() once the job is done,
+ * so results are handed back where the session lives; job and completion
+ * share state through whatever they capture.
+ *
+ * post() and poll() may be called from any thread; completions run on the
+ * polling thread only.
+ */
+
+namespace file_worker {
+
+class FileWorker {
+public:
+    using Task = std::function<void()>;
+
+    FileWorker();
+    ~FileWorker();
+
+    // Queues a job; the thread is started on first use
+    void post(Task job, Task completion);
+    // Runs the completions of finished jobs; returns how many ran
+    int poll();
+    // Jobs queued or running, and finished jobs not yet polled
+    int pending() const;
+    // Drops queued jobs and undelivered completions and waits for the running job
+    void stop();
+
+private:
+    struct Item {
+        Task job;
+        Task completion;
+    };
+
+    mutable std::mutex _mutex;
+    std::condition_variable _cv;
+    std::thread _thread;
+    std::deque<Item> _queue;
+    std::vector<Task> _completed;
+    bool _running;
+    bool _busy;
+
+    void run();
+};
+
+} // namespace file_worker
+
+#endif // FILE_WORKER_H
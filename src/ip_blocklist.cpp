@@ -0,0 +1,287 @@
+#include "ip_blocklist.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+
+namespace ip_blocklist {
+
+namespace {
+
+bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+std::string trim(const std::string& text, size_t begin, size_t end) {
+    while (begin < end && is_space(text[begin])) {
+        begin++;
+    }
+    while (end > begin && is_space(text[end - 1])) {
+        end--;
+    }
+    return text.substr(begin, end - begin);
+}
+
+// Dotted quad with optional leading zeros, which inet_pton rejects but DAT
+// lists use throughout
+bool parse_v4(const std::string& text, libtorrent::address& address) {
+    uint32_t value = 0;
+    int parts = 0;
+    size_t i = 0;
+
+    while (parts < 4) {
+        if (i >= text.size() || text[i] < '0' || text[i] > '9') {
+            return false;
+        }
+        uint32_t octet = 0;
+        int digits = 0;
+        while (i < text.size() && text[i] >= '0' && text[i] <= '9') {
+            octet = octet * 10 + (text[i] - '0');
+            if (++digits > 3 || octet > 255) {
+                return false;
+            }
+            i++;
+        }
+        value = (value << 8) | octet;
+        parts++;
+
+        if (parts < 4) {
+            if (i >= text.size() || text[i] != '.') {
+                return false;
+            }
+            i++;
+        }
+    }
+
+    if (i != text.size()) {
+        return false;
+    }
+    address = libtorrent::address_v4(value);
+    return true;
+}
+
+bool parse_address(const std::string& text, libtorrent::address& address) {
+    if (parse_v4(text, address)) {
+        return true;
+    }
+    if (text.find(':') == std::string::npos) {
+        return false;
+    }
+
+    libtorrent::error_code ec;
+    address = libtorrent::make_address(text, ec);
+    return !ec;
+}
+
+bool parse_range(const std::string& text, Range& range) {
+    size_t dash = text.find('-');
+    if (dash == std::string::npos) {
+        if (!parse_address(text, range.first)) {
+            return false;
+        }
+        range.last = range.first;
+        return true;
+    }
+
+    if (!parse_address(trim(text, 0, dash), range.first) ||
+        !parse_address(trim(text, dash + 1, text.size()), range.last)) {
+        return false;
+    }
+    return range.first.is_v4() == range.last.is_v4() && !(range.last < range.first);
+}
+
+bool parse_cidr(const std::string& text, Range& range) {
+    size_t slash = text.find('/');
+    libtorrent::address base;
+    if (!parse_address(trim(text, 0, slash), base)) {
+        return false;
+    }
+
+    std::string bits_text = trim(text, slash + 1, text.size());
+    if (bits_text.empty() || bits_text.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    int bits = std::atoi(bits_text.c_str());
+
+    if (base.is_v4()) {
+        if (bits > 32) {
+            return false;
+        }
+        uint32_t mask = bits == 0 ? 0 : ~uint32_t(0) << (32 - bits);
+        uint32_t value = base.to_v4().to_uint();
+        range.first = libtorrent::address_v4(value & mask);
+        range.last = libtorrent::address_v4(value | ~mask);
+        return true;
+    }
+
+    if (bits > 128) {
+        return false;
+    }
+    libtorrent::address_v6::bytes_type first = base.to_v6().to_bytes();
+    libtorrent::address_v6::bytes_type last = first;
+    for (int i = 0; i < 16; i++) {
+        int keep = std::min(8, std::max(0, bits - i * 8));
+        uint8_t mask = keep == 0 ? 0 : static_cast<uint8_t>(0xff << (8 - keep));
+        first[i] = first[i] & mask;
+        last[i] = first[i] | static_cast<uint8_t>(~mask);
+    }
+    range.first = libtorrent::address_v6(first);
+    range.last = libtorrent::address_v6(last);
+    return true;
+}
+
+} // namespace
+
+LineResult parse_line(const std::string& line, Range& range) {
+    std::string text = trim(line, 0, line.size());
+    if (text.empty() || text[0] == '#' || text[0] == ';' || text.compare(0, 2, "//") == 0) {
+        return LineResult::skip;
+    }
+
+    range.blocked = true;
+
+    // P2P: the description may itself contain colons, commas or slashes, the
+    // IPv4 range never does, so it is checked before the other formats. An
+    // IPv6 range or a DAT/CIDR line never leaves a valid IPv4 range after
+    // its last colon.
+    size_t colon = text.rfind(':');
+    if (colon != std::string::npos && parse_range(trim(text, colon + 1, text.size()), range) && range.first.is_v4()) {
+        return LineResult::range;
+    }
+
+    // DAT: range , access level , description
+    size_t comma = text.find(',');
+    if (comma != std::string::npos && parse_range(trim(text, 0, comma), range)) {
+        size_t level_end = text.find(',', comma + 1);
+        std::string level = trim(text, comma + 1, level_end == std::string::npos ? text.size() : level_end);
+        if (!level.empty() && level.find_first_not_of("0123456789") == std::string::npos) {
+            range.blocked = std::atoi(level.c_str()) < 128;
+        }
+        return LineResult::range;
+    }
+
+    if (text.find('/') != std::string::npos) {
+        return parse_cidr(text, range) ? LineResult::range : LineResult::invalid;
+    }
+
+    return parse_range(text, range) ? LineResult::range : LineResult::invalid;
+}
+
+void add_to_filter(libtorrent::ip_filter& filter, const std::vector<Range>& ranges) {
+    for (const auto& range : ranges) {
+        filter.add_rule(range.first, range.last, range.blocked ? libtorrent::ip_filter::blocked : 0);
+    }
+}
+
+Loader::Loader()
+    : _cancelled(false)
+    , _loading(false)
+    , _finished(false) {
+}
+
+Loader::~Loader() {
+    cancel();
+}
+
+bool Loader::start(const std::string& path, std::string& error) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_loading) {
+        error = "A blocklist is already loading";
+        return false;
+    }
+
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+
+    _cancelled = false;
+    _loading = true;
+    _finished = false;
+    _result = Result();
+    _thread = std::thread(&Loader::run, this, path);
+    return true;
+}
+
+bool Loader::is_loading() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _loading;
+}
+
+bool Loader::take_result(Result& result) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_finished) {
+        return false;
+    }
+    result = std::move(_result);
+    _result = Result();
+    _finished = false;
+    return true;
+}
+
+void Loader::cancel() {
+    _cancelled = true;
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _loading = false;
+    _finished = false;
+    _result = Result();
+}
+
+void Loader::run(std::string path) {
+    auto started = std::chrono::steady_clock::now();
+
+    Result result;
+    result.path = path;
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        result.error = "Cannot open " + path;
+    } else {
+        std::vector<Range> ranges;
+        std::string line;
+        Range range;
+
+        while (!_cancelled && std::getline(in, line)) {
+            result.lines++;
+            switch (parse_line(line, range)) {
+                case LineResult::range: ranges.push_back(range); break;
+                case LineResult::invalid: result.invalid_lines++; break;
+                case LineResult::skip: break;
+            }
+        }
+
+        // Sorted input keeps ip_filter insertion cheap. Allowed ranges go
+        // last so they carve exceptions out of blocked ones in any file order.
+        std::sort(ranges.begin(), ranges.end(), [](const Range& a, const Range& b) {
+            if (a.blocked != b.blocked) {
+                return a.blocked;
+            }
+            if (a.first.is_v4() != b.first.is_v4()) {
+                return a.first.is_v4();
+            }
+            return a.first < b.first;
+        });
+
+        if (!_cancelled) {
+            add_to_filter(result.filter, ranges);
+            result.ranges = static_cast<int64_t>(ranges.size());
+            result.ok = true;
+        }
+    }
+
+    result.elapsed_usec = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started).count();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _loading = false;
+    if (!_cancelled) {
+        _result = std::move(result);
+        _finished = true;
+    }
+}
+
+} // namespace ip_blocklist
@@ -0,0 +1,86 @@
+#ifndef IP_BLOCKLIST_H
+#define IP_BLOCKLIST_H
+
+#include <libtorrent/address.hpp>
+#include <libtorrent/ip_filter.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * IP blocklist parsing and background loading.
+ *
+ * Understands the common list formats, one range per line:
+ * - P2P:  `description:1.2.3.0-1.2.3.255`
+ * - DAT:  `001.002.003.000 - 001.002.003.255 , 000 , description`
+ *         (access levels below 128 block, as in eMule)
+ * - CIDR: `1.2.3.0/24`, `2001:db8::/32`
+ * - plain addresses and `first-last` ranges, IPv4 or IPv6
+ * Blank lines and lines starting with `#`, `//` or `;` are skipped.
+ *
+ * The loader parses on its own thread, sorts the ranges (blocked first,
+ * then allowed, each by start address) and builds a complete ip_filter,
+ * which the session then installs with a single set_ip_filter() call.
+ */
+
+namespace ip_blocklist {
+
+struct Range {
+    libtorrent::address first;
+    libtorrent::address last;
+    bool blocked = true;
+};
+
+enum class LineResult {
+    range,
+    skip,
+    invalid
+};
+
+LineResult parse_line(const std::string& line, Range& range);
+
+// Adds ranges in order; later ranges override earlier ones where they overlap
+void add_to_filter(libtorrent::ip_filter& filter, const std::vector<Range>& ranges);
+
+class Loader {
+public:
+    struct Result {
+        bool ok = false;
+        std::string path;
+        std::string error;
+        libtorrent::ip_filter filter;
+        int64_t lines = 0;
+        int64_t ranges = 0;
+        int64_t invalid_lines = 0;
+        int64_t elapsed_usec = 0;
+    };
+
+    Loader();
+    ~Loader();
+
+    // Starts loading in the background; false if a load is already running
+    bool start(const std::string& path, std::string& error);
+    bool is_loading() const;
+    // Hands over a finished load exactly once
+    bool take_result(Result& result);
+    // Abandons a running load and waits for the thread
+    void cancel();
+
+private:
+    mutable std::mutex _mutex;
+    std::thread _thread;
+    std::atomic<bool> _cancelled;
+    bool _loading;
+    bool _finished;
+    Result _result;
+
+    void run(std::string path);
+};
+
+} // namespace ip_blocklist
+
+#endif // IP_BLOCKLIST_H
@@ -0,0 +1,79 @@
+#include "log_ring_buffer.h"
+
+LogRingBuffer::LogRingBuffer(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    _slots.reset(new Slot[size]);
+    _mask = size - 1;
+
+    for (size_t i = 0; i < size; i++) {
+        _slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    _enqueue_pos.store(0, std::memory_order_relaxed);
+    _dequeue_pos.store(0, std::memory_order_relaxed);
+    _dropped.store(0, std::memory_order_relaxed);
+}
+
+bool LogRingBuffer::try_push(const LogRecord& record) {
+    size_t pos = _enqueue_pos.load(std::memory_order_relaxed);
+
+    for (;;) {
+        Slot& slot = _slots[pos & _mask];
+        size_t seq = slot.sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+        if (diff == 0) {
+            // Slot is free for this position, try to claim it
+            if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.record = record;
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            // Consumer has not released this slot yet: ring is full
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            // Another producer claimed it, reload and retry
+            pos = _enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool LogRingBuffer::try_pop(LogRecord& record) {
+    // Single consumer: no CAS required on the dequeue side
+    size_t pos = _dequeue_pos.load(std::memory_order_relaxed);
+    Slot& slot = _slots[pos & _mask];
+    size_t seq = slot.sequence.load(std::memory_order_acquire);
+
+    if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0) {
+        return false;
+    }
+
+    record = slot.record;
+    slot.sequence.store(pos + _mask + 1, std::memory_order_release);
+    _dequeue_pos.store(pos + 1, std::memory_order_relaxed);
+    return true;
+}
+
+size_t LogRingBuffer::capacity() const {
+    return _mask + 1;
+}
+
+size_t LogRingBuffer::size_approx() const {
+    size_t head = _enqueue_pos.load(std::memory_order_relaxed);
+    size_t tail = _dequeue_pos.load(std::memory_order_relaxed);
+    return head >= tail ? head - tail : 0;
+}
+
+uint64_t LogRingBuffer::dropped_count() const {
+    return _dropped.load(std::memory_order_relaxed);
+}
+
+void LogRingBuffer::reset_dropped_count() {
+    _dropped.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,65 @@
+#ifndef LOG_RING_BUFFER_H
+#define LOG_RING_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * LogRecord - Fixed-size log entry captured on the calling thread
+ *
+ * Holds interned category/format ids and the arguments pre-encoded with
+ * binary_log::ArgEncoder. Timestamp formatting and message rendering happen
+ * later on the writer thread (or are skipped entirely in binary mode).
+ */
+struct LogRecord {
+    static constexpr size_t MAX_PAYLOAD = 232;
+
+    uint64_t timestamp_usec;
+    uint32_t category_id;
+    uint32_t format_id;
+    uint8_t level;
+    uint8_t flags;
+    uint8_t argc;
+    uint16_t length;
+    uint8_t payload[MAX_PAYLOAD];
+};
+
+/**
+ * LogRingBuffer - Bounded lock-free multi-producer/single-consumer queue
+ *
+ * Every slot carries a sequence number so producers claim a slot with a
+ * single CAS and never block. When the ring is full the record is dropped
+ * and counted instead of stalling the caller.
+ */
+class LogRingBuffer {
+public:
+    // Capacity is rounded up to the next power of two
+    explicit LogRingBuffer(size_t capacity);
+
+    bool try_push(const LogRecord& record);
+    bool try_pop(LogRecord& record);
+
+    size_t capacity() const;
+    size_t size_approx() const;
+
+    uint64_t dropped_count() const;
+    void reset_dropped_count();
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        LogRecord record;
+    };
+
+    std::unique_ptr<Slot[]> _slots;
+    size_t _mask;
+
+    // Producers and the consumer touch different cache lines
+    alignas(64) std::atomic<size_t> _enqueue_pos;
+    alignas(64) std::atomic<size_t> _dequeue_pos;
+    alignas(64) std::atomic<uint64_t> _dropped;
+};
+
+#endif // LOG_RING_BUFFER_H
@@ -0,0 +1,847 @@
+#include "memory_disk_io.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+
+#if LIBTORRENT_VERSION_NUM >= 20000
+#include <libtorrent/session.hpp>
+#include <libtorrent/disk_interface.hpp>
+#include <libtorrent/disk_buffer_holder.hpp>
+#include <libtorrent/storage_defs.hpp>
+#include <libtorrent/file_storage.hpp>
+#include <libtorrent/add_torrent_params.hpp>
+#include <libtorrent/torrent_flags.hpp>
+#include <libtorrent/performance_counters.hpp>
+#include <libtorrent/hasher.hpp>
+#include <libtorrent/hex.hpp>
+#include <libtorrent/io_context.hpp>
+#include <libtorrent/error_code.hpp>
+#include <libtorrent/aux_/vector.hpp>
+#include <libtorrent/posix_disk_io.hpp>
+#include <libtorrent/mmap_disk_io.hpp>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/error.hpp>
+#endif
+
+namespace memory_storage {
+
+// MemoryStore
+
+MemoryStore::MemoryStore()
+    : _limit_bytes(0), _memory_default(false), _blocks_in_use(0), _spilled_bytes(0) {
+}
+
+MemoryStore::~MemoryStore() {
+}
+
+void MemoryStore::set_limit(int64_t bytes) {
+    _limit_bytes = bytes > 0 ? bytes : 0;
+}
+
+int64_t MemoryStore::get_limit() const {
+    return _limit_bytes;
+}
+
+void MemoryStore::set_spill_path(const std::string& path) {
+    std::lock_guard<std::mutex> lock(_config_mutex);
+    _spill_path = path;
+}
+
+std::string MemoryStore::get_spill_path() const {
+    std::lock_guard<std::mutex> lock(_config_mutex);
+    return _spill_path;
+}
+
+void MemoryStore::set_memory_default(bool enabled) {
+    std::lock_guard<std::mutex> lock(_config_mutex);
+    _memory_default = enabled;
+}
+
+bool MemoryStore::is_memory_default() const {
+    std::lock_guard<std::mutex> lock(_config_mutex);
+    return _memory_default;
+}
+
+void MemoryStore::register_torrent(const std::string& info_hash) {
+    std::lock_guard<std::mutex> lock(_config_mutex);
+    _registered.insert(info_hash);
+}
+
+void MemoryStore::unregister_torrent(const std::string& info_hash) {
+    std::lock_guard<std::mutex> lock(_config_mutex);
+    _registered.erase(info_hash);
+}
+
+bool MemoryStore::wants_memory(const std::string& info_hash) const {
+    std::lock_guard<std::mutex> lock(_config_mutex);
+    return _memory_default || _registered.count(info_hash) > 0;
+}
+
+std::shared_ptr<MemoryTorrent> MemoryStore::find_torrent(const std::string& info_hash) const {
+    std::lock_guard<std::mutex> lock(_config_mutex);
+    auto it = _torrents.find(info_hash);
+    if (it == _torrents.end()) {
+        return nullptr;
+    }
+    return it->second.lock();
+}
+
+MemoryStore::Stats MemoryStore::get_stats() const {
+    Stats stats;
+    stats.limit_bytes = _limit_bytes;
+
+    {
+        std::lock_guard<std::mutex> lock(_arena_mutex);
+        stats.used_bytes = _blocks_in_use * BLOCK_SIZE;
+        stats.reserved_bytes = static_cast<int64_t>(_slabs.size()) * SLAB_BLOCKS * BLOCK_SIZE;
+        stats.spilled_bytes = _spilled_bytes;
+    }
+
+    std::lock_guard<std::mutex> lock(_config_mutex);
+    for (const auto& entry : _torrents) {
+        if (!entry.second.expired()) {
+            stats.torrents++;
+        }
+    }
+    return stats;
+}
+
+char* MemoryStore::allocate_block() {
+    std::lock_guard<std::mutex> lock(_arena_mutex);
+
+    int64_t limit = _limit_bytes;
+    if (limit > 0 && (_blocks_in_use + 1) * BLOCK_SIZE > limit) {
+        return nullptr;
+    }
+
+    if (_free_blocks.empty()) {
+        // Grow the arena by one slab instead of one allocation per block
+        std::unique_ptr<char[]> slab(new char[static_cast<size_t>(SLAB_BLOCKS) * BLOCK_SIZE]);
+        for (int i = SLAB_BLOCKS - 1; i >= 0; i--) {
+            _free_blocks.push_back(slab.get() + static_cast<size_t>(i) * BLOCK_SIZE);
+        }
+        _slabs.push_back(std::move(slab));
+    }
+
+    char* block = _free_blocks.back();
+    _free_blocks.pop_back();
+    _blocks_in_use++;
+    return block;
+}
+
+void MemoryStore::release_block(char* block) {
+    std::lock_guard<std::mutex> lock(_arena_mutex);
+    _free_blocks.push_back(block);
+    _blocks_in_use--;
+}
+
+void MemoryStore::add_spilled(int64_t bytes) {
+    std::lock_guard<std::mutex> lock(_arena_mutex);
+    _spilled_bytes += bytes;
+}
+
+void MemoryStore::release_unused_slabs() {
+    std::lock_guard<std::mutex> lock(_arena_mutex);
+    if (_free_blocks.size() < static_cast<size_t>(SLAB_BLOCKS)) {
+        return;
+    }
+
+    // Count free blocks per slab; slabs are found by address
+    std::vector<std::pair<char*, size_t>> starts;
+    starts.reserve(_slabs.size());
+    for (size_t i = 0; i < _slabs.size(); i++) {
+        starts.emplace_back(_slabs[i].get(), i);
+    }
+    std::sort(starts.begin(), starts.end());
+
+    auto slab_of = [&](char* block) {
+        auto it = std::upper_bound(starts.begin(), starts.end(), std::make_pair(block, _slabs.size()));
+        return std::prev(it)->second;
+    };
+
+    std::vector<int> free_count(_slabs.size(), 0);
+    for (char* block : _free_blocks) {
+        free_count[slab_of(block)]++;
+    }
+
+    std::vector<bool> unused(_slabs.size(), false);
+    bool any = false;
+    for (size_t i = 0; i < _slabs.size(); i++) {
+        unused[i] = free_count[i] == SLAB_BLOCKS;
+        any = any || unused[i];
+    }
+    if (!any) {
+        return;
+    }
+
+    _free_blocks.erase(std::remove_if(_free_blocks.begin(), _free_blocks.end(), [&](char* block) {
+        return unused[slab_of(block)];
+    }), _free_blocks.end());
+
+    size_t kept = 0;
+    for (size_t i = 0; i < _slabs.size(); i++) {
+        if (!unused[i]) {
+            _slabs[kept++] = std::move(_slabs[i]);
+        }
+    }
+    _slabs.resize(kept);
+}
+
+#if LIBTORRENT_VERSION_NUM >= 20000
+
+std::shared_ptr<MemoryTorrent> MemoryStore::attach(const std::string& info_hash, const libtorrent::file_storage& files) {
+    std::string spill_path = get_spill_path();
+    std::string spill_file = spill_path.empty() ? std::string() : spill_path + "/" + info_hash + ".spill";
+
+    auto torrent = std::make_shared<MemoryTorrent>(shared_from_this(), files, spill_file);
+
+    std::lock_guard<std::mutex> lock(_config_mutex);
+    _torrents[info_hash] = torrent;
+    return torrent;
+}
+
+void MemoryStore::detach(const std::string& info_hash, const MemoryTorrent* torrent) {
+    std::lock_guard<std::mutex> lock(_config_mutex);
+    _registered.erase(info_hash);
+
+    // The same torrent may already have been added again
+    auto it = _torrents.find(info_hash);
+    if (it != _torrents.end()) {
+        auto current = it->second.lock();
+        if (!current || current.get() == torrent) {
+            _torrents.erase(it);
+        }
+    }
+}
+
+bool MemoryStore::has_torrent(const std::string& info_hash) const {
+    return find_torrent(info_hash) != nullptr;
+}
+
+int64_t MemoryStore::get_file_size(const std::string& info_hash, int file_index) const {
+    auto torrent = find_torrent(info_hash);
+    if (!torrent || file_index < 0 || file_index >= torrent->get_file_count()) {
+        return -1;
+    }
+    return torrent->get_file_size(file_index);
+}
+
+bool MemoryStore::read_file(const std::string& info_hash, int file_index, char* dest, std::string& error) const {
+    auto torrent = find_torrent(info_hash);
+    if (!torrent) {
+        error = "torrent is not stored in memory";
+        return false;
+    }
+
+    if (file_index < 0 || file_index >= torrent->get_file_count()) {
+        error = "file index out of range";
+        return false;
+    }
+
+    if (!torrent->read_range(torrent->get_file_offset(file_index), dest, torrent->get_file_size(file_index))) {
+        error = "file has not been completely downloaded";
+        return false;
+    }
+
+    return true;
+}
+
+// MemoryTorrent
+
+MemoryTorrent::MemoryTorrent(std::shared_ptr<MemoryStore> store, const libtorrent::file_storage& files, std::string spill_file)
+    : _store(std::move(store)), _written_blocks(0), _spill_file_path(std::move(spill_file)) {
+    _piece_length = files.piece_length();
+    _num_pieces = files.num_pieces();
+    _total_size = files.total_size();
+    _blocks_per_piece = (_piece_length + MemoryStore::BLOCK_SIZE - 1) / MemoryStore::BLOCK_SIZE;
+
+    _file_offsets.reserve(files.num_files());
+    _file_sizes.reserve(files.num_files());
+    for (libtorrent::file_index_t i : files.file_range()) {
+        _file_offsets.push_back(files.file_offset(i));
+        _file_sizes.push_back(files.file_size(i));
+    }
+
+    size_t block_count = static_cast<size_t>(_num_pieces) * _blocks_per_piece;
+    _blocks.assign(block_count, nullptr);
+    _spilled.assign(block_count, false);
+
+    // Blocks entirely inside pad files are zeros that nobody ever writes
+    _pad.assign(block_count, false);
+    for (libtorrent::file_index_t i : files.file_range()) {
+        if (!files.pad_file_at(i) || files.file_size(i) == 0) {
+            continue;
+        }
+        int64_t begin = files.file_offset(i);
+        int64_t end = begin + files.file_size(i);
+        for (int piece = static_cast<int>(begin / _piece_length); piece < _num_pieces; piece++) {
+            int64_t piece_start = static_cast<int64_t>(piece) * _piece_length;
+            if (piece_start >= end) {
+                break;
+            }
+            for (int block = 0; block < _blocks_per_piece; block++) {
+                int64_t block_start = piece_start + static_cast<int64_t>(block) * MemoryStore::BLOCK_SIZE;
+                int64_t block_end = std::min<int64_t>(block_start + MemoryStore::BLOCK_SIZE, piece_start + piece_size(piece));
+                if (block_start < block_end && block_start >= begin && block_end <= end) {
+                    _pad[static_cast<size_t>(piece) * _blocks_per_piece + block] = true;
+                }
+            }
+        }
+    }
+}
+
+MemoryTorrent::~MemoryTorrent() {
+    clear();
+}
+
+int MemoryTorrent::piece_size(int piece) const {
+    if (piece < _num_pieces - 1) {
+        return _piece_length;
+    }
+    return static_cast<int>(_total_size - static_cast<int64_t>(_num_pieces - 1) * _piece_length);
+}
+
+bool MemoryTorrent::write(int piece, int offset, const char* data, int length, std::string& error) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (piece < 0 || piece >= _num_pieces || offset < 0 || offset + length > piece_size(piece)) {
+        error = "write outside of piece";
+        return false;
+    }
+
+    while (length > 0) {
+        size_t index = static_cast<size_t>(piece) * _blocks_per_piece + offset / MemoryStore::BLOCK_SIZE;
+        int block_offset = offset % MemoryStore::BLOCK_SIZE;
+        int chunk = std::min(length, MemoryStore::BLOCK_SIZE - block_offset);
+
+        if (!_blocks[index] && !_spilled[index]) {
+            _blocks[index] = _store->allocate_block();
+            _written_blocks++;
+
+            if (!_blocks[index]) {
+                if (_spill_file_path.empty()) {
+                    error = "memory storage limit reached";
+                    return false;
+                }
+                _spilled[index] = true;
+                _store->add_spilled(MemoryStore::BLOCK_SIZE);
+            }
+        }
+
+        if (_blocks[index]) {
+            std::memcpy(_blocks[index] + block_offset, data, chunk);
+        } else if (!write_spilled(static_cast<int64_t>(piece) * _piece_length + offset, data, chunk)) {
+            error = "failed to write spill file " + _spill_file_path;
+            return false;
+        }
+
+        data += chunk;
+        offset += chunk;
+        length -= chunk;
+    }
+
+    return true;
+}
+
+bool MemoryTorrent::read(int piece, int offset, char* dest, int length) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return read_locked(piece, offset, dest, length);
+}
+
+bool MemoryTorrent::has_piece(int piece) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (piece < 0 || piece >= _num_pieces) {
+        return false;
+    }
+
+    int blocks = (piece_size(piece) + MemoryStore::BLOCK_SIZE - 1) / MemoryStore::BLOCK_SIZE;
+    for (int block = 0; block < blocks; block++) {
+        size_t index = static_cast<size_t>(piece) * _blocks_per_piece + block;
+        if (!_blocks[index] && !_spilled[index] && !_pad[index]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MemoryTorrent::has_any_data() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _written_blocks > 0;
+}
+
+bool MemoryTorrent::read_locked(int piece, int offset, char* dest, int length) const {
+    if (piece < 0 || piece >= _num_pieces || offset < 0 || offset + length > piece_size(piece)) {
+        return false;
+    }
+
+    while (length > 0) {
+        size_t index = static_cast<size_t>(piece) * _blocks_per_piece + offset / MemoryStore::BLOCK_SIZE;
+        int block_offset = offset % MemoryStore::BLOCK_SIZE;
+        int chunk = std::min(length, MemoryStore::BLOCK_SIZE - block_offset);
+
+        if (_blocks[index]) {
+            std::memcpy(dest, _blocks[index] + block_offset, chunk);
+        } else if (_spilled[index]) {
+            if (!read_spilled(static_cast<int64_t>(piece) * _piece_length + offset, dest, chunk)) {
+                return false;
+            }
+        } else if (_pad[index]) {
+            std::memset(dest, 0, chunk);
+        } else {
+            return false;
+        }
+
+        dest += chunk;
+        offset += chunk;
+        length -= chunk;
+    }
+
+    return true;
+}
+
+bool MemoryTorrent::read_range(int64_t torrent_offset, char* dest, int64_t length) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    while (length > 0) {
+        int piece = static_cast<int>(torrent_offset / _piece_length);
+        int offset = static_cast<int>(torrent_offset % _piece_length);
+        int chunk = static_cast<int>(std::min<int64_t>(length, piece_size(piece) - offset));
+
+        if (!read_locked(piece, offset, dest, chunk)) {
+            return false;
+        }
+
+        dest += chunk;
+        torrent_offset += chunk;
+        length -= chunk;
+    }
+
+    return true;
+}
+
+void MemoryTorrent::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _written_blocks = 0;
+    for (size_t i = 0; i < _blocks.size(); i++) {
+        if (_blocks[i]) {
+            _store->release_block(_blocks[i]);
+            _blocks[i] = nullptr;
+        }
+        if (_spilled[i]) {
+            _store->add_spilled(-MemoryStore::BLOCK_SIZE);
+            _spilled[i] = false;
+        }
+    }
+
+    if (_spill_file.is_open()) {
+        _spill_file.close();
+        std::remove(_spill_file_path.c_str());
+    }
+
+    _store->release_unused_slabs();
+}
+
+bool MemoryTorrent::write_spilled(int64_t offset, const char* data, int length) {
+    if (!_spill_file.is_open()) {
+        _spill_file.open(_spill_file_path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!_spill_file.is_open()) {
+            return false;
+        }
+    }
+
+    _spill_file.clear();
+    _spill_file.seekp(static_cast<std::streamoff>(offset));
+    _spill_file.write(data, length);
+    return static_cast<bool>(_spill_file);
+}
+
+bool MemoryTorrent::read_spilled(int64_t offset, char* dest, int length) const {
+    if (!_spill_file.is_open()) {
+        return false;
+    }
+
+    _spill_file.clear();
+    _spill_file.seekg(static_cast<std::streamoff>(offset));
+    _spill_file.read(dest, length);
+    return _spill_file.gcount() == length;
+}
+
+// Routing disk I/O
+
+namespace {
+
+namespace lt = libtorrent;
+
+lt::storage_error make_storage_error(lt::operation_t operation, lt::error_code ec) {
+    lt::storage_error error;
+    error.ec = ec;
+    error.operation = operation;
+    return error;
+}
+
+class RoutingDiskIO final : public lt::disk_interface, public lt::buffer_allocator_interface {
+public:
+    RoutingDiskIO(lt::io_context& ioc, std::shared_ptr<MemoryStore> store, std::unique_ptr<lt::disk_interface> inner)
+        : _ioc(ioc), _store(std::move(store)), _inner(std::move(inner)) {
+    }
+
+    lt::storage_holder new_torrent(lt::storage_params const& params, std::shared_ptr<void> const& torrent) override {
+        Slot slot;
+        slot.info_hash = lt::aux::to_hex(params.info_hash);
+        slot.files = &params.files;
+
+        if (_store->wants_memory(slot.info_hash)) {
+            slot.memory = _store->attach(slot.info_hash, params.files);
+        } else {
+            slot.inner = _inner->new_torrent(params, torrent);
+        }
+
+        lt::storage_index_t index;
+        if (_free_slots.empty()) {
+            index = _slots.end_index();
+            _slots.emplace_back(std::move(slot));
+        } else {
+            index = _free_slots.back();
+            _free_slots.pop_back();
+            _slots[index] = std::move(slot);
+        }
+
+        return lt::storage_holder(index, *this);
+    }
+
+    void remove_torrent(lt::storage_index_t storage) override {
+        Slot& slot = _slots[storage];
+        if (slot.memory) {
+            _store->detach(slot.info_hash, slot.memory.get());
+        }
+
+        slot.inner.reset();
+        slot.memory.reset();
+        slot.files = nullptr;
+        _free_slots.push_back(storage);
+    }
+
+    void async_read(lt::storage_index_t storage, lt::peer_request const& r,
+            std::function<void(lt::disk_buffer_holder, lt::storage_error const&)> handler,
+            lt::disk_job_flags_t flags) override {
+        Slot& slot = _slots[storage];
+        if (!slot.memory) {
+            _inner->async_read(slot.inner, r, std::move(handler), flags);
+            return;
+        }
+
+        // Copy out so evicting or clearing blocks never invalidates a buffer
+        // libtorrent still holds
+        char* buffer = new char[r.length];
+        int length = r.length;
+        lt::storage_error error;
+        if (!slot.memory->read(static_cast<int>(r.piece), r.start, buffer, r.length)) {
+            // Never written (e.g. claimed by resume data): a disk error, not zeros
+            delete[] buffer;
+            buffer = nullptr;
+            length = 0;
+            error = make_storage_error(lt::operation_t::file_read, boost::asio::error::eof);
+        }
+
+        boost::asio::post(_ioc, [this, handler, buffer, length, error] {
+            handler(lt::disk_buffer_holder(*this, buffer, length), error);
+        });
+    }
+
+    bool async_write(lt::storage_index_t storage, lt::peer_request const& r, char const* buf,
+            std::shared_ptr<lt::disk_observer> observer, std::function<void(lt::storage_error const&)> handler,
+            lt::disk_job_flags_t flags) override {
+        Slot& slot = _slots[storage];
+        if (!slot.memory) {
+            return _inner->async_write(slot.inner, r, buf, std::move(observer), std::move(handler), flags);
+        }
+
+        lt::storage_error error;
+        std::string message;
+        if (!slot.memory->write(static_cast<int>(r.piece), r.start, buf, r.length, message)) {
+            error = make_storage_error(lt::operation_t::file_write,
+                lt::error_code(boost::system::errc::no_space_on_device, lt::generic_category()));
+        }
+
+        boost::asio::post(_ioc, [handler, error] { handler(error); });
+        return false;
+    }
+
+    void async_hash(lt::storage_index_t storage, lt::piece_index_t piece, lt::span<lt::sha256_hash> v2,
+            lt::disk_job_flags_t flags,
+            std::function<void(lt::piece_index_t, lt::sha1_hash const&, lt::storage_error const&)> handler) override {
+        Slot& slot = _slots[storage];
+        if (!slot.memory) {
+            _inner->async_hash(slot.inner, piece, v2, flags, std::move(handler));
+            return;
+        }
+
+        lt::storage_error error;
+        lt::sha1_hash hash;
+        int const size = slot.files->piece_size(piece);
+        _hash_buffer.resize(static_cast<size_t>(size));
+
+        if (!slot.memory->read(static_cast<int>(piece), 0, _hash_buffer.data(), size)) {
+            error = make_storage_error(lt::operation_t::file_read, boost::asio::error::eof);
+        } else {
+            hash = lt::hasher(_hash_buffer.data(), size).final();
+
+            if (!v2.empty()) {
+                int const size2 = slot.files->piece_size2(piece);
+                int const blocks2 = slot.files->blocks_in_piece2(piece);
+                for (int k = 0; k < blocks2 && k < static_cast<int>(v2.size()); k++) {
+                    int const offset = k * lt::default_block_size;
+                    int const length = std::min(lt::default_block_size, size2 - offset);
+                    v2[k] = lt::hasher256(_hash_buffer.data() + offset, length).final();
+                }
+            }
+        }
+
+        boost::asio::post(_ioc, [handler, piece, hash, error] { handler(piece, hash, error); });
+    }
+
+    void async_hash2(lt::storage_index_t storage, lt::piece_index_t piece, int offset, lt::disk_job_flags_t flags,
+            std::function<void(lt::piece_index_t, lt::sha256_hash const&, lt::storage_error const&)> handler) override {
+        Slot& slot = _slots[storage];
+        if (!slot.memory) {
+            _inner->async_hash2(slot.inner, piece, offset, flags, std::move(handler));
+            return;
+        }
+
+        lt::storage_error error;
+        lt::sha256_hash hash;
+        int const length = std::min(lt::default_block_size, slot.files->piece_size2(piece) - offset);
+        _hash_buffer.resize(static_cast<size_t>(length));
+
+        if (!slot.memory->read(static_cast<int>(piece), offset, _hash_buffer.data(), length)) {
+            error = make_storage_error(lt::operation_t::file_read, boost::asio::error::eof);
+        } else {
+            hash = lt::hasher256(_hash_buffer.data(), length).final();
+        }
+
+        boost::asio::post(_ioc, [handler, piece, hash, error] { handler(piece, hash, error); });
+    }
+
+    void async_move_storage(lt::storage_index_t storage, std::string path, lt::move_flags_t flags,
+            std::function<void(lt::status_t, std::string const&, lt::storage_error const&)> handler) override {
+        Slot& slot = _slots[storage];
+        if (!slot.memory) {
+            _inner->async_move_storage(slot.inner, std::move(path), flags, std::move(handler));
+            return;
+        }
+
+        // Memory torrents have no files to move
+        boost::asio::post(_ioc, [handler, path] {
+            handler(lt::status_t::fatal_disk_error, path, make_storage_error(lt::operation_t::file_rename,
+                lt::error_code(boost::system::errc::operation_not_supported, lt::generic_category())));
+        });
+    }
+
+    void async_release_files(lt::storage_index_t storage, std::function<void()> handler) override {
+        Slot& slot = _slots[storage];
+        if (!slot.memory) {
+            _inner->async_release_files(slot.inner, std::move(handler));
+            return;
+        }
+
+        if (handler) {
+            boost::asio::post(_ioc, std::move(handler));
+        }
+    }
+
+    void async_check_files(lt::storage_index_t storage, lt::add_torrent_params const* resume_data,
+            lt::aux::vector<std::string, lt::file_index_t> links,
+            std::function<void(lt::status_t, lt::storage_error const&)> handler) override {
+        Slot& slot = _slots[storage];
+        if (!slot.memory) {
+            _inner->async_check_files(slot.inner, resume_data, std::move(links), std::move(handler));
+            return;
+        }
+
+        // Resume data or seed mode may claim pieces this store does not
+        // hold (memory does not survive a re-add); have them all hashed, and
+        // the missing ones (read errors) are downloaded again
+        bool claims_pieces = false;
+        if (resume_data) {
+            claims_pieces = static_cast<bool>(resume_data->flags & lt::torrent_flags::seed_mode);
+            for (int p = 0; !claims_pieces && p < resume_data->have_pieces.size(); p++) {
+                claims_pieces = resume_data->have_pieces.get_bit(lt::piece_index_t(p));
+            }
+        }
+
+        bool complete = true;
+        if (claims_pieces && slot.memory->has_any_data()) {
+            for (int p = 0; complete && p < slot.files->num_pieces(); p++) {
+                bool claimed = (resume_data->flags & lt::torrent_flags::seed_mode) ||
+                    (p < resume_data->have_pieces.size() && resume_data->have_pieces.get_bit(lt::piece_index_t(p)));
+                complete = !claimed || slot.memory->has_piece(p);
+            }
+        } else if (claims_pieces) {
+            complete = false;
+        }
+
+        lt::status_t status = complete ? lt::status_t::no_error : lt::status_t::need_full_check;
+        boost::asio::post(_ioc, [handler, status] { handler(status, lt::storage_error()); });
+    }
+
+    void async_stop_torrent(lt::storage_index_t storage, std::function<void()> handler) override {
+        Slot& slot = _slots[storage];
+        if (!slot.memory) {
+            _inner->async_stop_torrent(slot.inner, std::move(handler));
+            return;
+        }
+
+        if (handler) {
+            boost::asio::post(_ioc, std::move(handler));
+        }
+    }
+
+    void async_rename_file(lt::storage_index_t storage, lt::file_index_t index, std::string name,
+            std::function<void(std::string const&, lt::file_index_t, lt::storage_error const&)> handler) override {
+        Slot& slot = _slots[storage];
+        if (!slot.memory) {
+            _inner->async_rename_file(slot.inner, index, std::move(name), std::move(handler));
+            return;
+        }
+
+        // Names are not used for lookups in memory
+        boost::asio::post(_ioc, [handler, name, index] { handler(name, index, lt::storage_error()); });
+    }
+
+    void async_delete_files(lt::storage_index_t storage, lt::remove_flags_t options,
+            std::function<void(lt::storage_error const&)> handler) override {
+        Slot& slot = _slots[storage];
+        if (!slot.memory) {
+            _inner->async_delete_files(slot.inner, options, std::move(handler));
+            return;
+        }
+
+        slot.memory->clear();
+        boost::asio::post(_ioc, [handler] { handler(lt::storage_error()); });
+    }
+
+    void async_set_file_priority(lt::storage_index_t storage,
+            lt::aux::vector<lt::download_priority_t, lt::file_index_t> priorities,
+            std::function<void(lt::storage_error const&, lt::aux::vector<lt::download_priority_t, lt::file_index_t>)> handler) override {
+        Slot& slot = _slots[storage];
+        if (!slot.memory) {
+            _inner->async_set_file_priority(slot.inner, std::move(priorities), std::move(handler));
+            return;
+        }
+
+        boost::asio::post(_ioc, [handler, priorities] { handler(lt::storage_error(), priorities); });
+    }
+
+    void async_clear_piece(lt::storage_index_t storage, lt::piece_index_t index,
+            std::function<void(lt::piece_index_t)> handler) override {
+        Slot& slot = _slots[storage];
+        if (!slot.memory) {
+            _inner->async_clear_piece(slot.inner, index, std::move(handler));
+            return;
+        }
+
+        // Failed pieces are simply overwritten by the next download
+        boost::asio::post(_ioc, [handler, index] { handler(index); });
+    }
+
+    void update_stats_counters(lt::counters& c) const override {
+        _inner->update_stats_counters(c);
+    }
+
+    std::vector<lt::open_file_state> get_status(lt::storage_index_t storage) const override {
+        const Slot& slot = _slots[storage];
+        if (!slot.memory) {
+            return _inner->get_status(slot.inner);
+        }
+        return {};
+    }
+
+    void abort(bool wait) override {
+        _inner->abort(wait);
+    }
+
+    void submit_jobs() override {
+        _inner->submit_jobs();
+    }
+
+    void settings_updated() override {
+        _inner->settings_updated();
+    }
+
+    // buffer_allocator_interface: only buffers from memory reads come back here
+    void free_disk_buffer(char* buffer) override {
+        delete[] buffer;
+    }
+
+private:
+    struct Slot {
+        lt::storage_holder inner;
+        std::shared_ptr<MemoryTorrent> memory;
+        const lt::file_storage* files = nullptr;
+        std::string info_hash;
+    };
+
+    lt::io_context& _ioc;
+    std::shared_ptr<MemoryStore> _store;
+    std::unique_ptr<lt::disk_interface> _inner;
+
+    // Slots are destroyed before _inner, releasing its storages first
+    lt::aux::vector<Slot, lt::storage_index_t> _slots;
+    std::vector<lt::storage_index_t> _free_slots;
+
+    // Disk jobs run on the network thread, so one scratch buffer is enough
+    std::vector<char> _hash_buffer;
+};
+
+} // namespace
+
+lt::disk_io_constructor_type make_disk_io_constructor(
+        std::shared_ptr<MemoryStore> store, lt::disk_io_constructor_type inner) {
+    if (!inner) {
+        inner = lt::default_disk_io_constructor;
+    }
+
+    return [store, inner](lt::io_context& ioc, lt::settings_interface const& settings, lt::counters& counters)
+            -> std::unique_ptr<lt::disk_interface> {
+        return std::unique_ptr<lt::disk_interface>(new RoutingDiskIO(ioc, store, inner(ioc, settings, counters)));
+    };
+}
+
+lt::disk_io_constructor_type disk_io_constructor_for(const std::string& backend) {
+    if (backend == "default") {
+        return lt::default_disk_io_constructor;
+    }
+    if (backend == "posix") {
+        return lt::posix_disk_io_constructor;
+    }
+#if TORRENT_HAVE_MMAP || TORRENT_HAVE_MAP_VIEW_OF_FILE
+    if (backend == "mmap") {
+        return lt::mmap_disk_io_constructor;
+    }
+#endif
+    return {};
+}
+
+#else
+
+// libtorrent 1.2 has no pluggable disk I/O: nothing is ever stored in memory
+
+bool MemoryStore::has_torrent(const std::string& info_hash) const {
+    return false;
+}
+
+int64_t MemoryStore::get_file_size(const std::string& info_hash, int file_index) const {
+    return -1;
+}
+
+bool MemoryStore::read_file(const std::string& info_hash, int file_index, char* dest, std::string& error) const {
+    error = "memory storage requires libtorrent 2.0";
+    return false;
+}
+
+#endif
+
+} // namespace memory_storage
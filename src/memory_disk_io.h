@@ -0,0 +1,182 @@
+#ifndef MEMORY_DISK_IO_H
+#define MEMORY_DISK_IO_H
+
+#include <libtorrent/version.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * In-memory storage backend for RAM-resident torrents.
+ *
+ * Piece data lives in 16 KiB blocks carved out of large slabs (an arena), so
+ * a torrent never needs a save path and completed files can be exported
+ * without touching the disk. A byte limit caps the arena; once it is reached
+ * further blocks either spill to a scratch file or fail the write.
+ *
+ * Torrents use the memory backend when their info hash was registered before
+ * they were added, or for every torrent when memory is the session default.
+ * All other torrents are delegated to the regular libtorrent disk I/O, so a
+ * session can mix both.
+ *
+ * Requires the libtorrent 2.0 disk_interface; on older versions only the
+ * MemoryStore bookkeeping is compiled and no torrent ever uses it.
+ */
+
+#if LIBTORRENT_VERSION_NUM >= 20000
+#include <libtorrent/session_params.hpp>
+#endif
+
+namespace libtorrent {
+    class file_storage;
+}
+
+namespace memory_storage {
+
+class MemoryTorrent;
+
+/**
+ * MemoryStore - Configuration, block arena and registry shared between the
+ * session wrapper (main thread) and the disk I/O backend (network thread).
+ */
+class MemoryStore : public std::enable_shared_from_this<MemoryStore> {
+public:
+    static constexpr int BLOCK_SIZE = 16 * 1024;
+
+    struct Stats {
+        int64_t used_bytes = 0;
+        int64_t reserved_bytes = 0;
+        int64_t limit_bytes = 0;
+        int64_t spilled_bytes = 0;
+        int torrents = 0;
+    };
+
+    MemoryStore();
+    ~MemoryStore();
+
+    // Configuration; a limit of 0 means unlimited, an empty spill path
+    // means writes fail once the limit is reached
+    void set_limit(int64_t bytes);
+    int64_t get_limit() const;
+    void set_spill_path(const std::string& path);
+    std::string get_spill_path() const;
+    void set_memory_default(bool enabled);
+    bool is_memory_default() const;
+
+    // Per-torrent selection by hex info hash (register before adding)
+    void register_torrent(const std::string& info_hash);
+    void unregister_torrent(const std::string& info_hash);
+    bool wants_memory(const std::string& info_hash) const;
+
+    // Export of stored data. read_file() fails if any byte of the file has
+    // not been downloaded yet.
+    bool has_torrent(const std::string& info_hash) const;
+    int64_t get_file_size(const std::string& info_hash, int file_index) const;
+    bool read_file(const std::string& info_hash, int file_index, char* dest, std::string& error) const;
+
+    Stats get_stats() const;
+
+    // Disk I/O side
+    std::shared_ptr<MemoryTorrent> attach(const std::string& info_hash, const libtorrent::file_storage& files);
+    void detach(const std::string& info_hash, const MemoryTorrent* torrent);
+    char* allocate_block();
+    void release_block(char* block);
+    void add_spilled(int64_t bytes);
+    // Frees slabs none of whose blocks are in use (after a torrent is dropped)
+    void release_unused_slabs();
+
+private:
+    // Blocks per slab (1 MiB slabs)
+    static constexpr int SLAB_BLOCKS = 64;
+
+    mutable std::mutex _config_mutex;
+    std::atomic<int64_t> _limit_bytes;
+    std::string _spill_path;
+    bool _memory_default;
+    std::unordered_set<std::string> _registered;
+    std::unordered_map<std::string, std::weak_ptr<MemoryTorrent>> _torrents;
+
+    // Arena: slabs are kept for the lifetime of the store and their blocks
+    // recycled through the free list
+    mutable std::mutex _arena_mutex;
+    std::vector<std::unique_ptr<char[]>> _slabs;
+    std::vector<char*> _free_blocks;
+    int64_t _blocks_in_use;
+    int64_t _spilled_bytes;
+
+    std::shared_ptr<MemoryTorrent> find_torrent(const std::string& info_hash) const;
+};
+
+#if LIBTORRENT_VERSION_NUM >= 20000
+/**
+ * MemoryTorrent - Block table for one torrent stored by MemoryStore
+ *
+ * Blocks are addressed as piece * blocks_per_piece + block. A block is either
+ * missing, resident in the arena, or spilled to the torrent's scratch file.
+ */
+class MemoryTorrent {
+public:
+    MemoryTorrent(std::shared_ptr<MemoryStore> store, const libtorrent::file_storage& files, std::string spill_file);
+    ~MemoryTorrent();
+
+    bool write(int piece, int offset, const char* data, int length, std::string& error);
+
+    // Fails if any block in the range was never written. Blocks lying wholly
+    // in pad files are never written and read as zeros.
+    bool read(int piece, int offset, char* dest, int length) const;
+    bool read_range(int64_t torrent_offset, char* dest, int64_t length) const;
+    // Every block of the piece holds data
+    bool has_piece(int piece) const;
+    bool has_any_data() const;
+    void clear();
+
+    // Layout copied from the file_storage so exports never touch libtorrent
+    // objects owned by the network thread
+    int piece_size(int piece) const;
+    int get_file_count() const { return static_cast<int>(_file_sizes.size()); }
+    int64_t get_file_offset(int file_index) const { return _file_offsets[file_index]; }
+    int64_t get_file_size(int file_index) const { return _file_sizes[file_index]; }
+
+private:
+    std::shared_ptr<MemoryStore> _store;
+    int _piece_length;
+    int _num_pieces;
+    int64_t _total_size;
+    int _blocks_per_piece;
+    std::vector<int64_t> _file_offsets;
+    std::vector<int64_t> _file_sizes;
+
+    mutable std::mutex _mutex;
+    std::vector<char*> _blocks;
+    std::vector<bool> _spilled;
+    std::vector<bool> _pad;
+    int64_t _written_blocks;
+    std::string _spill_file_path;
+    mutable std::fstream _spill_file;
+
+    bool read_locked(int piece, int offset, char* dest, int length) const;
+    bool write_spilled(int64_t offset, const char* data, int length);
+    bool read_spilled(int64_t offset, char* dest, int length) const;
+};
+
+// Disk I/O that stores registered torrents in `store` and hands every other
+// torrent to the disk I/O created by `inner`
+libtorrent::disk_io_constructor_type make_disk_io_constructor(
+    std::shared_ptr<MemoryStore> store, libtorrent::disk_io_constructor_type inner);
+
+// libtorrent's own disk I/O by name: "default", "mmap" (memory mapped files,
+// where the platform supports it) or "posix" (pread/pwrite). Returns an empty
+// constructor for unknown or unavailable backends.
+libtorrent::disk_io_constructor_type disk_io_constructor_for(const std::string& backend);
+#endif
+
+} // namespace memory_storage
+
+#endif // MEMORY_DISK_IO_H
@@ -0,0 +1,188 @@
+#include "metadata_cache.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace metadata_cache {
+
+MetadataCache::MetadataCache()
+    : _max_memory_entries(256)
+    , _memory_bytes(0)
+    , _hits(0)
+    , _misses(0) {
+}
+
+bool MetadataCache::set_directory(const std::string& path, std::string& error) {
+    if (!path.empty()) {
+        std::error_code ec;
+        fs::create_directories(fs::u8path(path), ec);
+        if (ec) {
+            error = ec.message();
+            return false;
+        }
+    }
+    _directory = path;
+    return true;
+}
+
+std::string MetadataCache::get_directory() const {
+    return _directory;
+}
+
+void MetadataCache::set_max_memory_entries(int entries) {
+    _max_memory_entries = entries < 1 ? 1 : entries;
+    evict();
+}
+
+bool MetadataCache::is_valid_key(const std::string& key) {
+    if (key.size() != 40 && key.size() != 64) {
+        return false;
+    }
+    for (char c : key) {
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void MetadataCache::put(const std::vector<std::string>& keys, const std::vector<char>& torrent) {
+    Buffer data = std::make_shared<const std::vector<char>>(torrent);
+
+    for (const auto& key : keys) {
+        if (!is_valid_key(key)) {
+            continue;
+        }
+        insert(key, data);
+
+        if (!_directory.empty()) {
+            // Write then rename so a crash never leaves a truncated entry
+            fs::path target = fs::u8path(file_path(key));
+            fs::path temp = target;
+            temp += ".tmp";
+            {
+                std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+                out.write(torrent.data(), static_cast<std::streamsize>(torrent.size()));
+            }
+            std::error_code ec;
+            fs::rename(temp, target, ec);
+            if (ec) {
+                fs::remove(temp, ec);
+            }
+        }
+    }
+}
+
+MetadataCache::Buffer MetadataCache::get(const std::string& key) {
+    auto it = _entries.find(key);
+    if (it != _entries.end()) {
+        _lru.splice(_lru.begin(), _lru, it->second.lru);
+        _hits++;
+        return it->second.data;
+    }
+
+    if (!_directory.empty() && is_valid_key(key)) {
+        std::ifstream in(fs::u8path(file_path(key)), std::ios::binary);
+        if (in) {
+            auto data = std::make_shared<std::vector<char>>(
+                std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            if (!data->empty()) {
+                insert(key, data);
+                _hits++;
+                return data;
+            }
+        }
+    }
+
+    _misses++;
+    return Buffer();
+}
+
+bool MetadataCache::contains(const std::string& key) const {
+    if (_entries.count(key) > 0) {
+        return true;
+    }
+    std::error_code ec;
+    return !_directory.empty() && is_valid_key(key) && fs::exists(fs::u8path(file_path(key)), ec);
+}
+
+bool MetadataCache::remove(const std::string& key) {
+    bool removed = false;
+
+    auto it = _entries.find(key);
+    if (it != _entries.end()) {
+        _memory_bytes -= static_cast<int64_t>(it->second.data->size());
+        _lru.erase(it->second.lru);
+        _entries.erase(it);
+        removed = true;
+    }
+
+    if (!_directory.empty() && is_valid_key(key)) {
+        std::error_code ec;
+        removed = fs::remove(fs::u8path(file_path(key)), ec) || removed;
+    }
+
+    return removed;
+}
+
+void MetadataCache::clear(bool delete_files) {
+    if (delete_files && !_directory.empty()) {
+        std::error_code ec;
+        for (const auto& entry : fs::directory_iterator(fs::u8path(_directory), ec)) {
+            if (entry.path().extension() == ".torrent" && is_valid_key(entry.path().stem().u8string())) {
+                fs::remove(entry.path(), ec);
+            }
+        }
+    }
+
+    _entries.clear();
+    _lru.clear();
+    _memory_bytes = 0;
+}
+
+MetadataCache::Stats MetadataCache::get_stats() const {
+    Stats stats;
+    stats.memory_entries = static_cast<int>(_entries.size());
+    stats.memory_bytes = _memory_bytes;
+    stats.max_memory_entries = _max_memory_entries;
+    stats.hits = _hits;
+    stats.misses = _misses;
+    stats.directory = _directory;
+    return stats;
+}
+
+std::string MetadataCache::file_path(const std::string& key) const {
+    return (fs::u8path(_directory) / (key + ".torrent")).u8string();
+}
+
+void MetadataCache::insert(const std::string& key, Buffer data) {
+    auto it = _entries.find(key);
+    if (it != _entries.end()) {
+        _memory_bytes -= static_cast<int64_t>(it->second.data->size());
+        _lru.erase(it->second.lru);
+        _entries.erase(it);
+    }
+
+    _lru.push_front(key);
+    _entries[key] = Entry{data, _lru.begin()};
+    _memory_bytes += static_cast<int64_t>(data->size());
+    evict();
+}
+
+void MetadataCache::evict() {
+    // Evicted entries remain on disk when a directory is set
+    while (static_cast<int>(_entries.size()) > _max_memory_entries && !_lru.empty()) {
+        auto it = _entries.find(_lru.back());
+        if (it != _entries.end()) {
+            _memory_bytes -= static_cast<int64_t>(it->second.data->size());
+            _entries.erase(it);
+        }
+        _lru.pop_back();
+    }
+}
+
+} // namespace metadata_cache
@@ -0,0 +1,78 @@
+#ifndef METADATA_CACHE_H
+#define METADATA_CACHE_H
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Cache of torrent metadata keyed by hex info hash.
+ *
+ * Holds complete .torrent buffers so a magnet link seen before can be added
+ * with its metadata instead of waiting for peers to send the info
+ * dictionary. Recently used entries stay in memory (LRU, bounded by entry
+ * count); with a directory set, every entry is also written there as
+ * `<info hash>.torrent` and reloaded on demand, so the cache survives
+ * restarts.
+ *
+ * Not thread safe; used from the thread that drives the session.
+ */
+
+namespace metadata_cache {
+
+class MetadataCache {
+public:
+    using Buffer = std::shared_ptr<const std::vector<char>>;
+
+    struct Stats {
+        int memory_entries = 0;
+        int64_t memory_bytes = 0;
+        int max_memory_entries = 0;
+        int64_t hits = 0;
+        int64_t misses = 0;
+        std::string directory;
+    };
+
+    MetadataCache();
+
+    // Empty path keeps the cache in memory only
+    bool set_directory(const std::string& path, std::string& error);
+    std::string get_directory() const;
+    void set_max_memory_entries(int entries);
+
+    // Keys are lower-case hex info hashes (40 or 64 characters)
+    static bool is_valid_key(const std::string& key);
+
+    void put(const std::vector<std::string>& keys, const std::vector<char>& torrent);
+    Buffer get(const std::string& key);
+    bool contains(const std::string& key) const;
+    bool remove(const std::string& key);
+    void clear(bool delete_files);
+
+    Stats get_stats() const;
+
+private:
+    struct Entry {
+        Buffer data;
+        std::list<std::string>::iterator lru;
+    };
+
+    std::unordered_map<std::string, Entry> _entries;
+    std::list<std::string> _lru;  // most recent first
+    int _max_memory_entries;
+    int64_t _memory_bytes;
+    int64_t _hits;
+    int64_t _misses;
+    std::string _directory;
+
+    std::string file_path(const std::string& key) const;
+    void insert(const std::string& key, Buffer data);
+    void evict();
+};
+
+} // namespace metadata_cache
+
+#endif // METADATA_CACHE_H
@@ -1,4 +1,5 @@
 #include "peer_info.h"
+#include "client_fingerprint.h"
 
 #include <godot_cpp/core/class_db.hpp>
 #include <libtorrent/peer_info.hpp>
@@ -38,9 +39,11 @@ void PeerInfo::_bind_methods() {
     
     ClassDB::bind_method(D_METHOD("get_country"), &PeerInfo::get_country);
     ClassDB::bind_method(D_METHOD("get_peer_dictionary"), &PeerInfo::get_peer_dictionary);
+
+    ClassDB::bind_static_method("PeerInfo", D_METHOD("identify_client", "peer_id"), &PeerInfo::identify_client);
 }
 
-PeerInfo::PeerInfo() : _peer_info(nullptr) {
+PeerInfo::PeerInfo() : _peer_info(nullptr), _dictionary_built(false) {
 }
 
 PeerInfo::~PeerInfo() {
@@ -60,8 +63,7 @@ int PeerInfo::get_port() const {
 }
 
 String PeerInfo::get_client() const {
-    if (!_peer_info) return "";
-    return String(_peer_info->client.c_str());
+    return _client;
 }
 
 String PeerInfo::get_peer_id() const {
@@ -170,9 +172,24 @@ String PeerInfo::get_country() const {
 
 void PeerInfo::_set_internal_info(std::shared_ptr<libtorrent::peer_info> info) {
     _peer_info = info;
+    _client = _peer_info ? String::utf8(client_fingerprint::client_name(*_peer_info).c_str()) : String();
+    _dictionary = Dictionary();
+    _dictionary_built = false;
 }
 
 Dictionary PeerInfo::get_peer_dictionary() const {
+    if (!_dictionary_built) {
+        build_dictionary();
+    }
+    return _dictionary;
+}
+
+String PeerInfo::identify_client(const PackedByteArray& peer_id) {
+    std::string name = client_fingerprint::identify(reinterpret_cast<const char*>(peer_id.ptr()), peer_id.size());
+    return String::utf8(name.c_str());
+}
+
+void PeerInfo::build_dictionary() const {
     Dictionary dict;
 
     dict["ip"] = get_ip();
@@ -198,7 +215,8 @@ Dictionary PeerInfo::get_peer_dictionary() const {
     dict["is_remote_choked"] = is_remote_choked();
     dict["country"] = get_country();
 
-    return dict;
+    _dictionary = dict;
+    _dictionary_built = true;
 }
 
 String PeerInfo::connection_type_to_string(int type) const {
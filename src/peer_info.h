@@ -4,6 +4,7 @@
 #include <godot_cpp/classes/ref_counted.hpp>
 #include <godot_cpp/variant/string.hpp>
 #include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
 #include <memory>
 
 using namespace godot;
@@ -60,15 +61,23 @@ public:
     // Country and location (if available)
     String get_country() const;
 
+    // Client name and version decoded from a raw peer id, empty if unknown
+    static String identify_client(const PackedByteArray& peer_id);
+
     // Internal methods for libtorrent integration
     void _set_internal_info(std::shared_ptr<libtorrent::peer_info> info);
+    // Built once per snapshot; shared, so duplicate() before modifying it
     Dictionary get_peer_dictionary() const;
 
 private:
     std::shared_ptr<libtorrent::peer_info> _peer_info;
+    String _client;
+    // Built on first use, after the snapshot is set
+    mutable Dictionary _dictionary;
+    mutable bool _dictionary_built;
 
     // Helper methods
-    String parse_client_string(const std::string& peer_id) const;
+    void build_dictionary() const;
     String connection_type_to_string(int type) const;
 };
 
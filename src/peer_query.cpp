@@ -0,0 +1,73 @@
+#include "peer_query.h"
+#include "client_fingerprint.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace peer_query {
+
+namespace {
+
+double sort_value(const libtorrent::peer_info& peer, SortKey key) {
+    switch (key) {
+        case SortKey::download_rate: return peer.down_speed;
+        case SortKey::upload_rate: return peer.up_speed;
+        case SortKey::total_download: return static_cast<double>(peer.total_download);
+        case SortKey::total_upload: return static_cast<double>(peer.total_upload);
+        case SortKey::progress: return peer.progress;
+    }
+    return 0.0;
+}
+
+bool contains_ignore_case(const std::string& haystack, const std::string& needle) {
+    auto it = std::search(haystack.begin(), haystack.end(), needle.begin(), needle.end(),
+        [](char a, char b) {
+            return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+        });
+    return it != haystack.end();
+}
+
+} // namespace
+
+int flags_of(const libtorrent::peer_info& peer) {
+    int flags = 0;
+    if (peer.flags & libtorrent::peer_info::seed) flags |= FLAG_SEED;
+    if (peer.flags & (libtorrent::peer_info::rc4_encrypted | libtorrent::peer_info::plaintext_encrypted)) flags |= FLAG_ENCRYPTED;
+    if (peer.flags & libtorrent::peer_info::local_connection) flags |= FLAG_LOCAL;
+    if (peer.flags & libtorrent::peer_info::choked) flags |= FLAG_CHOKED;
+    if (peer.flags & libtorrent::peer_info::interesting) flags |= FLAG_INTERESTING;
+    if (peer.flags & libtorrent::peer_info::remote_choked) flags |= FLAG_REMOTE_CHOKED;
+    if (peer.flags & libtorrent::peer_info::remote_interested) flags |= FLAG_REMOTE_INTERESTED;
+    return flags;
+}
+
+std::vector<int> select(const std::vector<libtorrent::peer_info>& peers, const Query& query, int& matched) {
+    std::vector<int> indices;
+    indices.reserve(peers.size());
+
+    for (size_t i = 0; i < peers.size(); i++) {
+        const libtorrent::peer_info& peer = peers[i];
+        if (query.require_flags != 0 || query.exclude_flags != 0) {
+            int flags = flags_of(peer);
+            if ((flags & query.require_flags) != query.require_flags || (flags & query.exclude_flags) != 0) {
+                continue;
+            }
+        }
+        if (!query.client.empty() && !contains_ignore_case(client_fingerprint::client_name(peer), query.client)) {
+            continue;
+        }
+        indices.push_back(static_cast<int>(i));
+    }
+    matched = static_cast<int>(indices.size());
+
+    size_t count = query.count < 0 ? indices.size() : std::min(indices.size(), static_cast<size_t>(query.count));
+    std::partial_sort(indices.begin(), indices.begin() + count, indices.end(), [&](int a, int b) {
+        double va = sort_value(peers[a], query.sort_key);
+        double vb = sort_value(peers[b], query.sort_key);
+        return va != vb ? va > vb : a < b;
+    });
+    indices.resize(count);
+    return indices;
+}
+
+} // namespace peer_query
@@ -0,0 +1,53 @@
+#ifndef PEER_QUERY_H
+#define PEER_QUERY_H
+
+#include <libtorrent/peer_info.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Filtering and top-N selection over a torrent's peer list.
+ *
+ * Works on the peer_info vector libtorrent returns, so nothing is wrapped
+ * per peer: peers are filtered by flag masks and client name, then only
+ * the best `count` are ordered (partial sort).
+ */
+
+namespace peer_query {
+
+enum class SortKey {
+    download_rate,
+    upload_rate,
+    total_download,
+    total_upload,
+    progress
+};
+
+// Peer flag bits, shared by the filters and the `flags` column
+constexpr int FLAG_SEED = 1;
+constexpr int FLAG_ENCRYPTED = 2;
+constexpr int FLAG_LOCAL = 4;
+constexpr int FLAG_CHOKED = 8;
+constexpr int FLAG_INTERESTING = 16;
+constexpr int FLAG_REMOTE_CHOKED = 32;
+constexpr int FLAG_REMOTE_INTERESTED = 64;
+
+struct Query {
+    int count = -1;               // -1 keeps every match
+    SortKey sort_key = SortKey::download_rate;
+    int require_flags = 0;        // all of these must be set
+    int exclude_flags = 0;        // none of these may be set
+    std::string client;           // case-insensitive substring; empty matches all
+};
+
+int flags_of(const libtorrent::peer_info& peer);
+
+// Indices into `peers` of the best matches, best first; `matched` receives
+// the number of peers that passed the filters
+std::vector<int> select(const std::vector<libtorrent::peer_info>& peers, const Query& query, int& matched);
+
+} // namespace peer_query
+
+#endif // PEER_QUERY_H
@@ -0,0 +1,414 @@
+#include "recheck_queue.h"
+
+#include <libtorrent/session.hpp>
+#include <libtorrent/torrent_status.hpp>
+#include <libtorrent/torrent_info.hpp>
+#include <libtorrent/torrent_flags.hpp>
+#include <libtorrent/version.hpp>
+
+#include <algorithm>
+#include <sstream>
+
+namespace recheck {
+
+namespace {
+
+constexpr int64_t RATE_WINDOW_USEC = 1000000;
+
+std::string info_hash_hex(const libtorrent::torrent_handle& handle) {
+    std::stringstream ss;
+#if LIBTORRENT_VERSION_NUM >= 20000
+    ss << handle.info_hashes().get_best();
+#else
+    ss << handle.info_hash();
+#endif
+    return ss.str();
+}
+
+bool is_checking_state(libtorrent::torrent_status::state_t state) {
+    return state == libtorrent::torrent_status::checking_files ||
+           state == libtorrent::torrent_status::checking_resume_data;
+}
+
+} // namespace
+
+const char* state_name(RecheckQueue::State state) {
+    switch (state) {
+        case RecheckQueue::State::queued: return "queued";
+        case RecheckQueue::State::checking: return "checking";
+        case RecheckQueue::State::done: return "done";
+        case RecheckQueue::State::failed: return "failed";
+    }
+    return "unknown";
+}
+
+RecheckQueue::RecheckQueue()
+    : _next_sequence(0)
+    , _max_active(1)
+    , _rate_limit(0)
+    , _paused(false)
+    , _tokens(0)
+    , _last_update_usec(0)
+    , _rate_window_bytes(0)
+    , _rate_window_start_usec(0)
+    , _bytes_per_second(0) {
+}
+
+bool RecheckQueue::enqueue(const libtorrent::torrent_handle& handle, int priority, std::string& error) {
+    if (!handle.is_valid()) {
+        error = "Invalid torrent handle";
+        return false;
+    }
+
+    auto info = handle.torrent_file();
+    if (!info) {
+        error = "Torrent has no metadata yet";
+        return false;
+    }
+
+    Entry* existing = find(handle);
+    if (existing && (existing->status.state == State::queued || existing->status.state == State::checking)) {
+        error = "Torrent is already queued for recheck";
+        return false;
+    }
+
+    Entry entry;
+    entry.handle = handle;
+    entry.sequence = _next_sequence++;
+    entry.status.info_hash = info_hash_hex(handle);
+    entry.status.name = info->name();
+    entry.status.priority = priority;
+    entry.status.total_bytes = info->total_size();
+
+    if (existing) {
+        *existing = entry;
+    } else {
+        _entries.push_back(entry);
+    }
+    return true;
+}
+
+bool RecheckQueue::cancel(const libtorrent::torrent_handle& handle) {
+    auto it = std::find_if(_entries.begin(), _entries.end(), [&](const Entry& entry) {
+        return entry.handle == handle && entry.status.state == State::queued;
+    });
+    if (it == _entries.end()) {
+        return false;
+    }
+    _entries.erase(it);
+    return true;
+}
+
+void RecheckQueue::clear_finished() {
+    _entries.erase(std::remove_if(_entries.begin(), _entries.end(), [](const Entry& entry) {
+        return entry.status.state == State::done || entry.status.state == State::failed;
+    }), _entries.end());
+}
+
+void RecheckQueue::reset() {
+    _entries.clear();
+    _tokens = 0;
+    _last_update_usec = 0;
+    _rate_window_bytes = 0;
+    _rate_window_start_usec = 0;
+    _bytes_per_second = 0;
+}
+
+void RecheckQueue::set_max_active(int max_active) {
+    _max_active = std::max(1, max_active);
+}
+
+int RecheckQueue::get_max_active() const {
+    return _max_active;
+}
+
+void RecheckQueue::set_rate_limit(int64_t bytes_per_second) {
+    _rate_limit = std::max<int64_t>(0, bytes_per_second);
+    // Start with one second of burst so the first pieces are not delayed
+    _tokens = _rate_limit;
+}
+
+int64_t RecheckQueue::get_rate_limit() const {
+    return _rate_limit;
+}
+
+void RecheckQueue::pause() {
+    _paused = true;
+    for (auto& entry : _entries) {
+        if (entry.status.state == State::checking) {
+            set_throttled(entry, true);
+        }
+    }
+}
+
+void RecheckQueue::resume() {
+    _paused = false;
+    // Throttled checks resume on the next update if the budget allows
+}
+
+bool RecheckQueue::is_paused() const {
+    return _paused;
+}
+
+void RecheckQueue::on_torrent_checked(const libtorrent::torrent_handle& handle) {
+    Entry* entry = find(handle);
+    if (entry && entry->status.state == State::checking) {
+        entry->checked_alert = true;
+    }
+}
+
+std::vector<RecheckQueue::Finished> RecheckQueue::update(libtorrent::session& session, int64_t now_usec) {
+    std::vector<Finished> finished;
+
+    if (_last_update_usec == 0) {
+        _last_update_usec = now_usec;
+        _rate_window_start_usec = now_usec;
+    }
+    int64_t elapsed = std::max<int64_t>(0, now_usec - _last_update_usec);
+    _last_update_usec = now_usec;
+
+    if (_rate_limit > 0) {
+        _tokens = std::min(_rate_limit, _tokens + _rate_limit * elapsed / 1000000);
+    }
+
+    // Checks the alert completed, and torrents removed under us
+    int64_t hashed = 0;
+    std::vector<libtorrent::torrent_handle> running;
+    for (auto& entry : _entries) {
+        if (entry.status.state != State::checking) {
+            continue;
+        }
+
+        if (!entry.handle.is_valid()) {
+            finish(entry, false, "Torrent was removed");
+            finished.push_back({entry.status.info_hash, false});
+        } else if (entry.checked_alert) {
+            hashed += entry.status.total_bytes - entry.status.checked_bytes;
+            entry.status.checked_bytes = entry.status.total_bytes;
+            finish(entry, true, "");
+            finished.push_back({entry.status.info_hash, true});
+        } else {
+            running.push_back(entry.handle);
+        }
+    }
+
+    // Progress of the others in one round trip; the predicate runs on the
+    // network thread while this thread waits, so reading `running` is safe
+    std::vector<libtorrent::torrent_status> statuses;
+    if (!running.empty()) {
+        session.get_torrent_status(&statuses, [&running](const libtorrent::torrent_status& st) {
+            return std::find(running.begin(), running.end(), st.handle) != running.end();
+        }, {});
+    }
+
+    for (const auto& st : statuses) {
+        Entry* entry = find(st.handle);
+        if (!entry || entry->status.state != State::checking) {
+            continue;
+        }
+
+        if (st.errc) {
+            finish(*entry, false, st.errc.message());
+            finished.push_back({entry->status.info_hash, false});
+            continue;
+        }
+
+        if (is_checking_state(st.state)) {
+            // While checking, progress is the fraction of pieces hashed
+            int64_t checked = static_cast<int64_t>(st.progress * entry->status.total_bytes);
+            hashed += std::max<int64_t>(0, checked - entry->status.checked_bytes);
+            entry->status.checked_bytes = std::max(entry->status.checked_bytes, checked);
+        } else if (!entry->status.throttled) {
+            // The alert was missed (masked out or never polled). force_recheck()
+            // switches the state on the network thread before this query runs,
+            // so a running check that left the checking states is done.
+            hashed += entry->status.total_bytes - entry->status.checked_bytes;
+            entry->status.checked_bytes = entry->status.total_bytes;
+            finish(*entry, true, "");
+            finished.push_back({entry->status.info_hash, true});
+        }
+    }
+
+    _rate_window_bytes += hashed;
+    if (now_usec - _rate_window_start_usec >= RATE_WINDOW_USEC) {
+        _bytes_per_second = _rate_window_bytes * 1000000 / (now_usec - _rate_window_start_usec);
+        _rate_window_bytes = 0;
+        _rate_window_start_usec = now_usec;
+    }
+
+    // Spend the budget; an empty bucket pauses checks until it refills
+    bool over_budget = false;
+    if (_rate_limit > 0) {
+        _tokens -= hashed;
+        over_budget = _tokens < 0;
+    }
+
+    bool throttle = _paused || over_budget;
+    for (auto& entry : _entries) {
+        if (entry.status.state == State::checking) {
+            set_throttled(entry, throttle);
+        }
+    }
+
+    if (!throttle) {
+        while (count_active() < _max_active) {
+            Entry* entry = next_queued();
+            if (!entry) {
+                break;
+            }
+            start(*entry);
+            if (entry->status.state == State::failed) {
+                finished.push_back({entry->status.info_hash, false});
+            }
+        }
+    }
+
+    return finished;
+}
+
+RecheckQueue::Status RecheckQueue::get_status() const {
+    Status status;
+    status.paused = _paused;
+    status.max_active = _max_active;
+    status.rate_limit = _rate_limit;
+    status.bytes_per_second = _bytes_per_second;
+
+    // Queue order: running first, then waiting by priority and arrival
+    auto rank = [](State state) {
+        switch (state) {
+            case State::checking: return 0;
+            case State::queued: return 1;
+            case State::done: return 2;
+            case State::failed: return 3;
+        }
+        return 4;
+    };
+
+    std::vector<const Entry*> order;
+    order.reserve(_entries.size());
+    for (const auto& entry : _entries) {
+        order.push_back(&entry);
+    }
+    std::sort(order.begin(), order.end(), [&](const Entry* a, const Entry* b) {
+        if (rank(a->status.state) != rank(b->status.state)) {
+            return rank(a->status.state) < rank(b->status.state);
+        }
+        if (a->status.priority != b->status.priority) {
+            return a->status.priority > b->status.priority;
+        }
+        return a->sequence < b->sequence;
+    });
+
+    for (const Entry* entry : order) {
+        switch (entry->status.state) {
+            case State::queued: status.queued++; break;
+            case State::checking: status.active++; break;
+            case State::done: status.done++; break;
+            case State::failed: status.failed++; break;
+        }
+        status.total_bytes += entry->status.total_bytes;
+        status.checked_bytes += entry->status.checked_bytes;
+        status.entries.push_back(entry->status);
+    }
+
+    return status;
+}
+
+RecheckQueue::Entry* RecheckQueue::find(const libtorrent::torrent_handle& handle) {
+    for (auto& entry : _entries) {
+        if (entry.handle == handle) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+RecheckQueue::Entry* RecheckQueue::next_queued() {
+    Entry* best = nullptr;
+    for (auto& entry : _entries) {
+        if (entry.status.state != State::queued) {
+            continue;
+        }
+        if (!best || entry.status.priority > best->status.priority ||
+            (entry.status.priority == best->status.priority && entry.sequence < best->sequence)) {
+            best = &entry;
+        }
+    }
+    return best;
+}
+
+int RecheckQueue::count_active() const {
+    int active = 0;
+    for (const auto& entry : _entries) {
+        if (entry.status.state == State::checking) {
+            active++;
+        }
+    }
+    return active;
+}
+
+void RecheckQueue::start(Entry& entry) {
+    if (!entry.handle.is_valid()) {
+        entry.status.state = State::failed;
+        entry.status.error = "Torrent was removed";
+        return;
+    }
+
+    try {
+        libtorrent::torrent_flags_t flags = entry.handle.flags();
+        entry.was_paused = static_cast<bool>(flags & libtorrent::torrent_flags::paused);
+        entry.was_auto_managed = static_cast<bool>(flags & libtorrent::torrent_flags::auto_managed);
+
+        // Keep the libtorrent queue from resuming a throttled check
+        entry.handle.unset_flags(libtorrent::torrent_flags::auto_managed);
+        entry.handle.force_recheck();
+        entry.handle.resume();
+
+        entry.status.state = State::checking;
+        entry.status.checked_bytes = 0;
+        entry.checked_alert = false;
+    } catch (const std::exception& e) {
+        entry.status.state = State::failed;
+        entry.status.error = e.what();
+    }
+}
+
+void RecheckQueue::finish(Entry& entry, bool success, const std::string& error) {
+    entry.status.state = success ? State::done : State::failed;
+    entry.status.error = error;
+    entry.status.throttled = false;
+
+    if (!entry.handle.is_valid()) {
+        return;
+    }
+
+    try {
+        if (entry.was_auto_managed) {
+            entry.handle.set_flags(libtorrent::torrent_flags::auto_managed);
+        }
+        if (entry.was_paused) {
+            entry.handle.pause();
+        }
+    } catch (const std::exception&) {
+        // The torrent is being removed; nothing left to restore
+    }
+}
+
+void RecheckQueue::set_throttled(Entry& entry, bool throttled) {
+    if (entry.status.throttled == throttled || !entry.handle.is_valid()) {
+        return;
+    }
+
+    try {
+        if (throttled) {
+            entry.handle.pause();
+        } else {
+            entry.handle.resume();
+        }
+        entry.status.throttled = throttled;
+    } catch (const std::exception&) {
+        // Picked up as an invalid handle on the next update
+    }
+}
+
+} // namespace recheck
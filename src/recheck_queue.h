@@ -0,0 +1,138 @@
+#ifndef RECHECK_QUEUE_H
+#define RECHECK_QUEUE_H
+
+#include <libtorrent/torrent_handle.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace libtorrent {
+    class session;
+}
+
+/**
+ * Session-wide scheduler for piece rechecks.
+ *
+ * force_recheck() starts hashing at once, so rechecking many torrents after
+ * a storage move saturates the disk. The queue instead runs at most
+ * `max_active` checks, highest priority first (FIFO within a priority), and
+ * keeps the aggregate hashing rate under a byte budget by pausing checking
+ * torrents while the token bucket is empty; libtorrent resumes a paused
+ * check from the last hashed piece.
+ *
+ * Queued torrents are taken out of auto-management so the libtorrent queue
+ * does not resume them behind our back; their paused and auto-managed flags
+ * are restored when the check finishes.
+ *
+ * A check completes on its torrent_checked_alert, or when the batched status
+ * query (one per update for all running checks) shows it has left the
+ * checking states, so a masked-out or dropped alert cannot stall the queue.
+ *
+ * Not thread safe; the session drives it from the thread polling alerts.
+ */
+
+namespace recheck {
+
+class RecheckQueue {
+public:
+    enum class State {
+        queued,
+        checking,
+        done,
+        failed
+    };
+
+    struct EntryStatus {
+        std::string info_hash;
+        std::string name;
+        int priority = 0;
+        State state = State::queued;
+        bool throttled = false;
+        int64_t total_bytes = 0;
+        int64_t checked_bytes = 0;
+        std::string error;
+    };
+
+    struct Status {
+        bool paused = false;
+        int max_active = 1;
+        int64_t rate_limit = 0;
+        int queued = 0;
+        int active = 0;
+        int done = 0;
+        int failed = 0;
+        int64_t total_bytes = 0;
+        int64_t checked_bytes = 0;
+        int64_t bytes_per_second = 0;
+        std::vector<EntryStatus> entries;
+    };
+
+    struct Finished {
+        std::string info_hash;
+        bool success = false;
+    };
+
+    RecheckQueue();
+
+    // Returns false (with a reason) if the handle is invalid or already queued
+    bool enqueue(const libtorrent::torrent_handle& handle, int priority, std::string& error);
+    // Drops a torrent that has not started checking yet
+    bool cancel(const libtorrent::torrent_handle& handle);
+    // Forget finished and failed entries
+    void clear_finished();
+    // Forget everything without touching the torrents (session shutdown)
+    void reset();
+
+    void set_max_active(int max_active);
+    int get_max_active() const;
+    // Bytes hashed per second across all checks; 0 means unlimited
+    void set_rate_limit(int64_t bytes_per_second);
+    int64_t get_rate_limit() const;
+    void pause();
+    void resume();
+    bool is_paused() const;
+
+    // Mark a check complete from torrent_checked_alert
+    void on_torrent_checked(const libtorrent::torrent_handle& handle);
+    // Advance the schedule; returns checks that finished during this call
+    std::vector<Finished> update(libtorrent::session& session, int64_t now_usec);
+
+    Status get_status() const;
+
+private:
+    struct Entry {
+        libtorrent::torrent_handle handle;
+        EntryStatus status;
+        uint64_t sequence = 0;
+        bool was_paused = false;
+        bool was_auto_managed = false;
+        bool checked_alert = false;
+    };
+
+    std::vector<Entry> _entries;
+    uint64_t _next_sequence;
+    int _max_active;
+    int64_t _rate_limit;
+    bool _paused;
+
+    // Token bucket for the hashing budget
+    int64_t _tokens;
+    int64_t _last_update_usec;
+    int64_t _rate_window_bytes;
+    int64_t _rate_window_start_usec;
+    int64_t _bytes_per_second;
+
+    Entry* find(const libtorrent::torrent_handle& handle);
+    Entry* next_queued();
+    int count_active() const;
+    void start(Entry& entry);
+    void finish(Entry& entry, bool success, const std::string& error);
+    void set_throttled(Entry& entry, bool throttled);
+};
+
+const char* state_name(RecheckQueue::State state);
+
+} // namespace recheck
+
+#endif // RECHECK_QUEUE_H
@@ -0,0 +1,494 @@
+#include "seed_pool.h"
+
+#include <libtorrent/session.hpp>
+#include <libtorrent/add_torrent_params.hpp>
+#include <libtorrent/torrent_info.hpp>
+#include <libtorrent/torrent_status.hpp>
+#include <libtorrent/torrent_flags.hpp>
+#include <libtorrent/extensions.hpp>
+#include <libtorrent/peer_connection_handle.hpp>
+#include <libtorrent/version.hpp>
+
+#include <algorithm>
+#include <sstream>
+
+namespace seed_pool {
+
+namespace {
+
+constexpr int64_t REFRESH_INTERVAL_USEC = 1000000;
+
+// Rotation entries looked at per update, so the cost does not grow with the pool
+constexpr size_t ROTATION_SLICE = 256;
+
+template <typename Hash>
+std::string to_hex(const Hash& hash) {
+    std::stringstream ss;
+    ss << hash;
+    return ss.str();
+}
+
+std::string info_hash_hex(const libtorrent::torrent_info& info) {
+#if LIBTORRENT_VERSION_NUM >= 20000
+    return to_hex(info.info_hashes().get_best());
+#else
+    return to_hex(info.info_hash());
+#endif
+}
+
+} // namespace
+
+// Runs on the network thread; only records the hash; the peer's connection
+// is dropped and the torrent is ready when it retries
+class SeedPool::Plugin final : public libtorrent::plugin {
+public:
+    explicit Plugin(std::shared_ptr<Inbox> inbox) : _inbox(std::move(inbox)) {}
+
+    feature_flags_t implemented_features() override {
+        return unknown_torrent_feature;
+    }
+
+#if LIBTORRENT_VERSION_NUM >= 20000
+    bool on_unknown_torrent(const libtorrent::info_hash_t& info_hash,
+        const libtorrent::peer_connection_handle&, libtorrent::client_data_t) override {
+        if (info_hash.has_v1()) {
+            record(to_hex(info_hash.v1));
+        }
+        if (info_hash.has_v2()) {
+            record(to_hex(info_hash.v2));
+        }
+        return false;
+    }
+#else
+    bool on_unknown_torrent(const libtorrent::sha1_hash& info_hash,
+        const libtorrent::peer_connection_handle&) override {
+        record(to_hex(info_hash));
+        return false;
+    }
+#endif
+
+private:
+    std::shared_ptr<Inbox> _inbox;
+
+    void record(std::string info_hash) {
+        std::lock_guard<std::mutex> lock(_inbox->mutex);
+        if (_inbox->info_hashes.size() >= _inbox->capacity) {
+            _inbox->dropped++;
+            return;
+        }
+        _inbox->info_hashes.push_back(std::move(info_hash));
+    }
+};
+
+SeedPool::SeedPool()
+    : _rotation_cursor(0)
+    , _inbox(std::make_shared<Inbox>())
+    , _loading(0)
+    , _failed(0)
+    , _peers(0)
+    , _upload_rate(0)
+    , _total_uploaded(0)
+    , _loads(0)
+    , _evictions(0)
+    , _request_count(0)
+    , _dropped_requests(0)
+    , _last_refresh_usec(0) {
+}
+
+bool SeedPool::add(const std::string& torrent_path, const std::string& save_path,
+        std::string& info_hash, std::string& error) {
+    libtorrent::error_code ec;
+    libtorrent::torrent_info info(torrent_path, ec);
+    if (ec) {
+        error = ec.message();
+        return false;
+    }
+
+    info_hash = info_hash_hex(info);
+    if (_entries.count(info_hash)) {
+        error = "Torrent is already in the seed pool";
+        return false;
+    }
+
+    Entry entry;
+    entry.torrent_path = torrent_path;
+    entry.save_path = save_path;
+    _entries.emplace(info_hash, std::move(entry));
+    _rotation.push_back(info_hash);
+    _orphans.erase(info_hash);
+
+#if LIBTORRENT_VERSION_NUM >= 20000
+    if (info.info_hashes().has_v1() && info.info_hashes().has_v2()) {
+        _aliases[to_hex(info.info_hashes().v1)] = info_hash;
+    }
+#endif
+    return true;
+}
+
+bool SeedPool::remove(libtorrent::session* session, const std::string& info_hash) {
+    auto it = _entries.find(info_hash);
+    if (it == _entries.end()) {
+        return false;
+    }
+
+    Entry& entry = it->second;
+    if (entry.state == State::loaded && session) {
+        unload(*session, entry);
+    } else if (entry.state == State::loading) {
+        _orphans.insert(info_hash);
+    }
+    set_state(entry, State::unloaded);
+    _total_uploaded -= entry.uploaded;
+
+    for (auto alias = _aliases.begin(); alias != _aliases.end();) {
+        alias = alias->second == info_hash ? _aliases.erase(alias) : std::next(alias);
+    }
+    // The rotation drops the key when it next reaches it
+    _entries.erase(it);
+    return true;
+}
+
+bool SeedPool::contains(const std::string& info_hash) const {
+    return resolve(info_hash) != nullptr;
+}
+
+bool SeedPool::request(const std::string& info_hash) {
+    const std::string* key = resolve(info_hash);
+    if (!key) {
+        return false;
+    }
+
+    Entry& entry = _entries[*key];
+    _request_count++;
+    if (entry.requested || entry.state == State::loading) {
+        return true;
+    }
+    if (static_cast<int>(_requests.size()) >= _config.max_pending_requests) {
+        _dropped_requests++;
+        return true;
+    }
+    entry.requested = true;
+    _requests.push_back(*key);
+    return true;
+}
+
+void SeedPool::set_config(const Config& config) {
+    _config = config;
+    _config.max_loaded = std::max(1, _config.max_loaded);
+    _config.loads_per_update = std::max(1, _config.loads_per_update);
+    _config.max_pending_requests = std::max(1, _config.max_pending_requests);
+
+    std::lock_guard<std::mutex> lock(_inbox->mutex);
+    _inbox->capacity = static_cast<size_t>(_config.max_pending_requests);
+}
+
+const SeedPool::Config& SeedPool::get_config() const {
+    return _config;
+}
+
+std::shared_ptr<libtorrent::plugin> SeedPool::make_plugin() {
+    return std::make_shared<Plugin>(_inbox);
+}
+
+void SeedPool::on_torrent_added(libtorrent::session& session, const libtorrent::add_torrent_params& params,
+        const libtorrent::torrent_handle& handle, const libtorrent::error_code& error) {
+    if (!params.ti) {
+        return;
+    }
+
+    std::string info_hash = info_hash_hex(*params.ti);
+    if (_orphans.erase(info_hash)) {
+        if (!error && handle.is_valid()) {
+            session.remove_torrent(handle);
+        }
+        return;
+    }
+
+    auto it = _entries.find(info_hash);
+    if (it == _entries.end() || it->second.state != State::loading) {
+        // Added by someone else
+        return;
+    }
+
+    Entry& entry = it->second;
+    if (error || !handle.is_valid()) {
+        set_state(entry, State::failed);
+        return;
+    }
+
+    entry.handle = handle;
+    set_state(entry, State::loaded);
+    _loaded[handle] = info_hash;
+}
+
+void SeedPool::update(libtorrent::session& session, int64_t now_usec) {
+    drain_inbox();
+
+    int budget = _config.loads_per_update;
+
+    // Peers waiting for a torrent come first
+    while (budget > 0 && !_requests.empty()) {
+        std::string info_hash = std::move(_requests.front());
+        _requests.pop_front();
+
+        auto it = _entries.find(info_hash);
+        if (it == _entries.end()) {
+            continue;
+        }
+
+        Entry& entry = it->second;
+        entry.requested = false;
+        entry.announcing = false;
+        if (entry.state == State::loaded || entry.state == State::loading) {
+            entry.last_active_usec = now_usec;
+            continue;
+        }
+        if (count_loaded() >= _config.max_loaded && !evict_idlest(session)) {
+            _dropped_requests++;
+            continue;
+        }
+        if (load(session, info_hash, entry, now_usec)) {
+            budget--;
+        }
+    }
+
+    // Then a slice of the announce rotation
+    if (_config.announce_interval_usec > 0) {
+        for (size_t scanned = 0; scanned < ROTATION_SLICE && budget > 0 && !_rotation.empty() &&
+                count_loaded() < _config.max_loaded; scanned++) {
+            if (_rotation_cursor >= _rotation.size()) {
+                _rotation_cursor = 0;
+            }
+
+            auto it = _entries.find(_rotation[_rotation_cursor]);
+            if (it == _entries.end()) {
+                _rotation[_rotation_cursor] = std::move(_rotation.back());
+                _rotation.pop_back();
+                continue;
+            }
+            _rotation_cursor++;
+
+            Entry& entry = it->second;
+            bool due = entry.last_announce_usec == 0 ||
+                now_usec - entry.last_announce_usec >= _config.announce_interval_usec;
+            if (entry.state == State::unloaded && due) {
+                entry.announcing = true;
+                if (load(session, it->first, entry, now_usec)) {
+                    budget--;
+                }
+            }
+        }
+    }
+
+    if (now_usec - _last_refresh_usec >= REFRESH_INTERVAL_USEC) {
+        _last_refresh_usec = now_usec;
+        refresh(session, now_usec);
+    }
+}
+
+SeedPool::Stats SeedPool::get_stats() const {
+    Stats stats;
+    stats.registered = static_cast<int>(_entries.size());
+    stats.loaded = static_cast<int>(_loaded.size());
+    stats.loading = _loading;
+    stats.failed = _failed;
+    stats.peers = _peers;
+    stats.upload_rate = _upload_rate;
+    stats.total_uploaded = _total_uploaded;
+    stats.loads = _loads;
+    stats.evictions = _evictions;
+    stats.requests = _request_count;
+    stats.dropped_requests = _dropped_requests;
+
+    std::lock_guard<std::mutex> lock(_inbox->mutex);
+    stats.dropped_requests += _inbox->dropped;
+    return stats;
+}
+
+void SeedPool::reset() {
+    for (auto& item : _entries) {
+        Entry& entry = item.second;
+        entry.handle = libtorrent::torrent_handle();
+        entry.state = State::unloaded;
+        entry.requested = false;
+        entry.announcing = false;
+        entry.peers = 0;
+        entry.upload_rate = 0;
+    }
+    _loaded.clear();
+    _orphans.clear();
+    _requests.clear();
+    _loading = 0;
+    _failed = 0;
+    _peers = 0;
+    _upload_rate = 0;
+    _last_refresh_usec = 0;
+
+    std::lock_guard<std::mutex> lock(_inbox->mutex);
+    _inbox->info_hashes.clear();
+}
+
+const std::string* SeedPool::resolve(const std::string& info_hash) const {
+    auto it = _entries.find(info_hash);
+    if (it != _entries.end()) {
+        return &it->first;
+    }
+    auto alias = _aliases.find(info_hash);
+    return alias != _aliases.end() ? &alias->second : nullptr;
+}
+
+void SeedPool::set_state(Entry& entry, State state) {
+    if (entry.state == State::loading) _loading--;
+    if (entry.state == State::failed) _failed--;
+    entry.state = state;
+    if (state == State::loading) _loading++;
+    if (state == State::failed) _failed++;
+}
+
+bool SeedPool::load(libtorrent::session& session, const std::string& info_hash, Entry& entry, int64_t now_usec) {
+    entry.last_announce_usec = now_usec;
+    entry.last_active_usec = now_usec;
+
+    libtorrent::error_code ec;
+    auto info = std::make_shared<libtorrent::torrent_info>(entry.torrent_path, ec);
+    if (ec || info_hash_hex(*info) != info_hash) {
+        // Missing or replaced since it was registered
+        set_state(entry, State::failed);
+        return false;
+    }
+
+    libtorrent::add_torrent_params params;
+    params.ti = std::move(info);
+    params.save_path = entry.save_path;
+    params.total_uploaded = entry.uploaded;
+    // Seed mode skips the initial check; pieces are verified as they are first served
+    params.flags |= libtorrent::torrent_flags::seed_mode;
+    params.flags &= ~libtorrent::torrent_flags::auto_managed;
+    params.flags &= ~libtorrent::torrent_flags::paused;
+
+    try {
+        session.async_add_torrent(std::move(params));
+    } catch (const std::exception&) {
+        set_state(entry, State::failed);
+        return false;
+    }
+
+    set_state(entry, State::loading);
+    _loads++;
+    return true;
+}
+
+void SeedPool::unload(libtorrent::session& session, Entry& entry) {
+    if (entry.handle.is_valid()) {
+        try {
+            session.remove_torrent(entry.handle);
+        } catch (const std::exception&) {
+            // Already gone
+        }
+    }
+    _loaded.erase(entry.handle);
+    _peers -= entry.peers;
+    _upload_rate -= entry.upload_rate;
+
+    entry.handle = libtorrent::torrent_handle();
+    entry.peers = 0;
+    entry.upload_rate = 0;
+    entry.announcing = false;
+    set_state(entry, State::unloaded);
+}
+
+bool SeedPool::evict_idlest(libtorrent::session& session) {
+    Entry* idlest = nullptr;
+    for (const auto& item : _loaded) {
+        auto it = _entries.find(item.second);
+        if (it == _entries.end() || it->second.peers > 0) {
+            continue;
+        }
+        if (!idlest || it->second.last_active_usec < idlest->last_active_usec) {
+            idlest = &it->second;
+        }
+    }
+
+    if (!idlest) {
+        return false;
+    }
+    unload(session, *idlest);
+    _evictions++;
+    return true;
+}
+
+void SeedPool::refresh(libtorrent::session& session, int64_t now_usec) {
+    if (_loaded.empty()) {
+        return;
+    }
+
+    // One round trip for every loaded pool torrent; the predicate runs on the
+    // network thread while this thread waits, so reading _loaded is safe
+    std::vector<libtorrent::torrent_status> statuses;
+    session.get_torrent_status(&statuses, [this](const libtorrent::torrent_status& st) {
+        return _loaded.count(st.handle) > 0;
+    }, {});
+
+    std::vector<Entry*> idle;
+    for (const auto& st : statuses) {
+        auto loaded = _loaded.find(st.handle);
+        if (loaded == _loaded.end()) {
+            continue;
+        }
+        auto it = _entries.find(loaded->second);
+        if (it == _entries.end()) {
+            continue;
+        }
+
+        Entry& entry = it->second;
+        if (st.errc) {
+            unload(session, entry);
+            set_state(entry, State::failed);
+            continue;
+        }
+
+        _peers += st.num_peers - entry.peers;
+        _upload_rate += st.upload_payload_rate - entry.upload_rate;
+        _total_uploaded += st.all_time_upload - entry.uploaded;
+        entry.peers = st.num_peers;
+        entry.upload_rate = st.upload_payload_rate;
+        entry.uploaded = st.all_time_upload;
+
+        if (entry.peers > 0) {
+            entry.last_active_usec = now_usec;
+            entry.announcing = false;
+            continue;
+        }
+
+        int64_t timeout = entry.announcing
+            ? std::min(_config.announce_hold_usec, _config.idle_timeout_usec)
+            : _config.idle_timeout_usec;
+        if (now_usec - entry.last_active_usec >= timeout) {
+            idle.push_back(&entry);
+        }
+    }
+
+    for (Entry* entry : idle) {
+        unload(session, *entry);
+        _evictions++;
+    }
+}
+
+void SeedPool::drain_inbox() {
+    std::vector<std::string> info_hashes;
+    {
+        std::lock_guard<std::mutex> lock(_inbox->mutex);
+        info_hashes.swap(_inbox->info_hashes);
+    }
+
+    for (const auto& info_hash : info_hashes) {
+        // Hashes of torrents we never had are ignored
+        request(info_hash);
+    }
+}
+
+int SeedPool::count_loaded() const {
+    return static_cast<int>(_loaded.size()) + _loading;
+}
+
+} // namespace seed_pool
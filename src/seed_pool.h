@@ -0,0 +1,166 @@
+#ifndef SEED_POOL_H
+#define SEED_POOL_H
+
+#include <libtorrent/torrent_handle.hpp>
+#include <libtorrent/error_code.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace libtorrent {
+    class session;
+    struct plugin;
+    struct add_torrent_params;
+}
+
+/**
+ * Seed-only torrents kept by the session instead of by scripts.
+ *
+ * A registered torrent costs its .torrent path, save path and a few
+ * counters; it is only loaded into libtorrent (in seed mode, so nothing is
+ * hashed up front) when it is needed:
+ * - a peer asks for it: the session plugin records unknown info hashes and
+ *   the torrent is loaded for the peer's next attempt
+ * - its announce is due: torrents are loaded in turn every
+ *   `announce_interval` so trackers and the DHT keep listing us
+ * - request() is called
+ * Loaded torrents without peers for `idle_timeout` are removed again (data
+ * stays on disk), and at most `max_loaded` are loaded at once; when full, a
+ * request evicts the torrent that has been idle longest.
+ *
+ * update() does a bounded amount of work per call (a slice of the rotation,
+ * a few loads, one status query per second) whatever the number of
+ * registered torrents, and reporting is aggregate only.
+ *
+ * Not thread safe apart from the plugin; the session drives it from the
+ * thread polling alerts.
+ */
+
+namespace seed_pool {
+
+class SeedPool {
+public:
+    struct Config {
+        int max_loaded = 500;
+        int64_t idle_timeout_usec = 120000000;
+        int64_t announce_interval_usec = 3600000000;  // 0 disables the rotation
+        int64_t announce_hold_usec = 15000000;        // idle time before a rotated torrent unloads
+        int loads_per_update = 8;
+        int max_pending_requests = 1024;
+    };
+
+    struct Stats {
+        int registered = 0;
+        int loaded = 0;
+        int loading = 0;
+        int failed = 0;
+        int peers = 0;
+        int64_t upload_rate = 0;
+        int64_t total_uploaded = 0;
+        int64_t loads = 0;
+        int64_t evictions = 0;
+        int64_t requests = 0;
+        int64_t dropped_requests = 0;
+    };
+
+    SeedPool();
+
+    // Reads the torrent once for its info hash; returns false (with a reason) on failure
+    bool add(const std::string& torrent_path, const std::string& save_path,
+        std::string& info_hash, std::string& error);
+    // Unregisters a torrent, removing it from the session if loaded (nothing
+    // is loaded without a session)
+    bool remove(libtorrent::session* session, const std::string& info_hash);
+    bool contains(const std::string& info_hash) const;
+    // Asks for a torrent to be loaded; false if it is not registered
+    bool request(const std::string& info_hash);
+
+    void set_config(const Config& config);
+    const Config& get_config() const;
+
+    // Session plugin reporting peers that ask for torrents we have not loaded
+    std::shared_ptr<libtorrent::plugin> make_plugin();
+
+    // Match add_torrent_alert to the torrent being loaded
+    void on_torrent_added(libtorrent::session& session, const libtorrent::add_torrent_params& params,
+        const libtorrent::torrent_handle& handle, const libtorrent::error_code& error);
+    void update(libtorrent::session& session, int64_t now_usec);
+
+    Stats get_stats() const;
+    // Mark everything unloaded without touching the session (session shutdown)
+    void reset();
+
+private:
+    enum class State : uint8_t {
+        unloaded,
+        loading,
+        loaded,
+        failed
+    };
+
+    struct Entry {
+        std::string torrent_path;
+        std::string save_path;
+        libtorrent::torrent_handle handle;
+        State state = State::unloaded;
+        bool requested = false;
+        bool announcing = false;   // loaded by the rotation, not by a peer
+        int peers = 0;
+        int upload_rate = 0;
+        int64_t uploaded = 0;
+        int64_t last_active_usec = 0;
+        int64_t last_announce_usec = 0;
+    };
+
+    class Plugin;
+
+    // Filled from the network thread by the plugin
+    struct Inbox {
+        std::mutex mutex;
+        std::vector<std::string> info_hashes;
+        size_t capacity = 1024;
+        int64_t dropped = 0;
+    };
+
+    std::unordered_map<std::string, Entry> _entries;
+    // v1 info hash of hybrid torrents, which peers may ask for instead
+    std::unordered_map<std::string, std::string> _aliases;
+    std::unordered_map<libtorrent::torrent_handle, std::string> _loaded;
+    // Removed while their add was in flight; dropped when the add completes
+    std::unordered_set<std::string> _orphans;
+    std::vector<std::string> _rotation;
+    size_t _rotation_cursor;
+    std::deque<std::string> _requests;
+    std::shared_ptr<Inbox> _inbox;
+    Config _config;
+
+    int _loading;
+    int _failed;
+    int _peers;
+    int64_t _upload_rate;
+    int64_t _total_uploaded;
+    int64_t _loads;
+    int64_t _evictions;
+    int64_t _request_count;
+    int64_t _dropped_requests;
+    int64_t _last_refresh_usec;
+
+    const std::string* resolve(const std::string& info_hash) const;
+    void set_state(Entry& entry, State state);
+    bool load(libtorrent::session& session, const std::string& info_hash, Entry& entry, int64_t now_usec);
+    void unload(libtorrent::session& session, Entry& entry);
+    bool evict_idlest(libtorrent::session& session);
+    void refresh(libtorrent::session& session, int64_t now_usec);
+    void drain_inbox();
+    int count_loaded() const;
+};
+
+} // namespace seed_pool
+
+#endif // SEED_POOL_H
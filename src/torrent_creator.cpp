@@ -0,0 +1,428 @@
+#include "torrent_creator.h"
+
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/classes/time.hpp>
+
+#include <libtorrent/create_torrent.hpp>
+#include <libtorrent/file_storage.hpp>
+#include <libtorrent/settings_pack.hpp>
+#include <libtorrent/torrent_info.hpp>
+#include <libtorrent/bencode.hpp>
+#include <libtorrent/entry.hpp>
+#include <libtorrent/add_torrent_params.hpp>
+#include <libtorrent/torrent_flags.hpp>
+#include <libtorrent/write_resume_data.hpp>
+#include <libtorrent/version.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+#include <thread>
+
+using namespace godot;
+
+namespace {
+
+constexpr int MIN_PIECE_SIZE = 16 * 1024;
+
+template <typename Hash>
+String hash_to_hex(const Hash& hash) {
+    std::stringstream ss;
+    ss << hash;
+    return String(ss.str().c_str());
+}
+
+} // namespace
+
+void TorrentCreator::_bind_methods() {
+    // Source and layout
+    ClassDB::bind_method(D_METHOD("set_path", "path"), &TorrentCreator::set_path);
+    ClassDB::bind_method(D_METHOD("get_path"), &TorrentCreator::get_path);
+    ClassDB::bind_method(D_METHOD("set_format", "format"), &TorrentCreator::set_format);
+    ClassDB::bind_method(D_METHOD("get_format"), &TorrentCreator::get_format);
+    ClassDB::bind_method(D_METHOD("is_format_supported", "format"), &TorrentCreator::is_format_supported);
+    ClassDB::bind_method(D_METHOD("set_piece_size", "bytes"), &TorrentCreator::set_piece_size);
+    ClassDB::bind_method(D_METHOD("get_piece_size"), &TorrentCreator::get_piece_size);
+    ClassDB::bind_method(D_METHOD("set_thread_count", "threads"), &TorrentCreator::set_thread_count);
+    ClassDB::bind_method(D_METHOD("get_thread_count"), &TorrentCreator::get_thread_count);
+
+    // Metadata
+    ClassDB::bind_method(D_METHOD("add_tracker", "url", "tier"), &TorrentCreator::add_tracker, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("add_web_seed", "url"), &TorrentCreator::add_web_seed);
+    ClassDB::bind_method(D_METHOD("clear_trackers"), &TorrentCreator::clear_trackers);
+    ClassDB::bind_method(D_METHOD("clear_web_seeds"), &TorrentCreator::clear_web_seeds);
+    ClassDB::bind_method(D_METHOD("set_private", "is_private"), &TorrentCreator::set_private);
+    ClassDB::bind_method(D_METHOD("is_private"), &TorrentCreator::is_private);
+    ClassDB::bind_method(D_METHOD("set_comment", "comment"), &TorrentCreator::set_comment);
+    ClassDB::bind_method(D_METHOD("get_comment"), &TorrentCreator::get_comment);
+    ClassDB::bind_method(D_METHOD("set_creator", "creator"), &TorrentCreator::set_creator);
+    ClassDB::bind_method(D_METHOD("get_creator"), &TorrentCreator::get_creator);
+
+    // Creation
+    ClassDB::bind_method(D_METHOD("generate"), &TorrentCreator::generate);
+    ClassDB::bind_method(D_METHOD("generate_resume_data", "save_path"), &TorrentCreator::generate_resume_data);
+    ClassDB::bind_method(D_METHOD("get_last_error"), &TorrentCreator::get_last_error);
+    ClassDB::bind_method(D_METHOD("get_last_result"), &TorrentCreator::get_last_result);
+
+    ADD_SIGNAL(MethodInfo("progress", PropertyInfo(Variant::INT, "pieces_done"), PropertyInfo(Variant::INT, "total_pieces")));
+
+    BIND_ENUM_CONSTANT(FORMAT_V1);
+    BIND_ENUM_CONSTANT(FORMAT_V2);
+    BIND_ENUM_CONSTANT(FORMAT_HYBRID);
+}
+
+TorrentCreator::TorrentCreator() {
+    _format = FORMAT_V1;
+    _piece_size = 0; // libtorrent picks from the total size
+    _thread_count = 0; // one per core
+    _private = false;
+    _creator = "godot-torrent";
+}
+
+TorrentCreator::~TorrentCreator() {
+}
+
+void TorrentCreator::set_path(String path) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _path = path;
+}
+
+String TorrentCreator::get_path() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _path;
+}
+
+void TorrentCreator::set_format(int format) {
+    if (format < FORMAT_V1 || format > FORMAT_HYBRID) {
+        UtilityFunctions::push_error("TorrentCreator: unknown format " + String::num_int64(format));
+        return;
+    }
+    if (!is_format_supported(format)) {
+        UtilityFunctions::push_error("TorrentCreator: v2 and hybrid torrents require libtorrent 2.0");
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _format = format;
+}
+
+int TorrentCreator::get_format() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _format;
+}
+
+bool TorrentCreator::is_format_supported(int format) const {
+    if (format == FORMAT_V1) {
+        return true;
+    }
+#if LIBTORRENT_VERSION_NUM >= 20000
+    return format == FORMAT_V2 || format == FORMAT_HYBRID;
+#else
+    return false;
+#endif
+}
+
+void TorrentCreator::set_piece_size(int bytes) {
+    // Pieces must be a power of two of at least one 16 KiB block
+    if (bytes != 0 && (bytes < MIN_PIECE_SIZE || (bytes & (bytes - 1)) != 0)) {
+        UtilityFunctions::push_error("TorrentCreator: piece size must be 0 (auto) or a power of two >= 16384");
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _piece_size = bytes;
+}
+
+int TorrentCreator::get_piece_size() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _piece_size;
+}
+
+void TorrentCreator::set_thread_count(int threads) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _thread_count = std::max(0, threads);
+}
+
+int TorrentCreator::get_thread_count() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _thread_count;
+}
+
+void TorrentCreator::add_tracker(String url, int tier) {
+    if (url.is_empty()) {
+        UtilityFunctions::push_error("TorrentCreator: tracker URL is empty");
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _trackers.emplace_back(url.utf8().get_data(), std::max(0, tier));
+}
+
+void TorrentCreator::add_web_seed(String url) {
+    if (url.is_empty()) {
+        UtilityFunctions::push_error("TorrentCreator: web seed URL is empty");
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _web_seeds.emplace_back(url.utf8().get_data());
+}
+
+void TorrentCreator::clear_trackers() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _trackers.clear();
+}
+
+void TorrentCreator::clear_web_seeds() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _web_seeds.clear();
+}
+
+void TorrentCreator::set_private(bool is_private) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _private = is_private;
+}
+
+bool TorrentCreator::is_private() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _private;
+}
+
+void TorrentCreator::set_comment(String comment) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _comment = comment;
+}
+
+String TorrentCreator::get_comment() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _comment;
+}
+
+void TorrentCreator::set_creator(String creator) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _creator = creator;
+}
+
+String TorrentCreator::get_creator() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _creator;
+}
+
+PackedByteArray TorrentCreator::generate() {
+    // Snapshot the configuration so setters are not blocked while hashing
+    String path;
+    int format;
+    int piece_size;
+    int threads;
+    bool is_private;
+    std::string comment;
+    std::string creator;
+    std::vector<std::pair<std::string, int>> trackers;
+    std::vector<std::string> web_seeds;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        path = _path;
+        format = _format;
+        piece_size = _piece_size;
+        threads = resolve_thread_count();
+        is_private = _private;
+        comment = _comment.utf8().get_data();
+        creator = _creator.utf8().get_data();
+        trackers = _trackers;
+        web_seeds = _web_seeds;
+        _last_error = "";
+        _last_result = Dictionary();
+        _last_torrent.clear();
+    }
+
+    if (path.is_empty()) {
+        return fail("No source path set");
+    }
+    if (path.begins_with("res://") || path.begins_with("user://")) {
+        path = ProjectSettings::get_singleton()->globalize_path(path);
+    }
+    path = path.simplify_path();
+    while (path.length() > 1 && (path.ends_with("/") || path.ends_with("\\"))) {
+        path = path.substr(0, path.length() - 1);
+    }
+
+    // Hashing reads files relative to the directory containing the source
+    std::string source = path.utf8().get_data();
+    std::string parent = path.get_base_dir().utf8().get_data();
+
+    uint64_t start_msec = Time::get_singleton()->get_ticks_msec();
+
+    try {
+        libtorrent::file_storage fs;
+        libtorrent::add_files(fs, source);
+
+        if (fs.num_files() == 0) {
+            return fail("No files found under " + path);
+        }
+
+#if LIBTORRENT_VERSION_NUM >= 20000
+        libtorrent::create_flags_t flags = {};
+        if (format == FORMAT_V1) {
+            flags |= libtorrent::create_torrent::v1_only;
+        } else if (format == FORMAT_V2) {
+            flags |= libtorrent::create_torrent::v2_only;
+        }
+        libtorrent::create_torrent ct(fs, piece_size, flags);
+#else
+        if (format != FORMAT_V1) {
+            return fail("v2 and hybrid torrents require libtorrent 2.0");
+        }
+        libtorrent::create_torrent ct(fs, piece_size);
+#endif
+
+        for (const auto& tracker : trackers) {
+            ct.add_tracker(tracker.first, tracker.second);
+        }
+        for (const auto& url : web_seeds) {
+            ct.add_url_seed(url);
+        }
+        ct.set_priv(is_private);
+        if (!comment.empty()) {
+            ct.set_comment(comment.c_str());
+        }
+        if (!creator.empty()) {
+            ct.set_creator(creator.c_str());
+        }
+
+        // The callback runs on this thread as pieces complete; emit at most
+        // once per percent so large torrents don't flood the signal
+        int total_pieces = ct.num_pieces();
+        int step = std::max(1, total_pieces / 100);
+        int pieces_done = 0;
+        auto on_piece = [&](libtorrent::piece_index_t) {
+            pieces_done++;
+            if (pieces_done % step == 0 || pieces_done == total_pieces) {
+                emit_signal("progress", pieces_done, total_pieces);
+            }
+        };
+
+        libtorrent::error_code ec;
+#if LIBTORRENT_VERSION_NUM >= 20000
+        // Hash jobs fan out across the disk I/O hashing pool
+        libtorrent::settings_pack settings;
+        settings.set_int(libtorrent::settings_pack::hashing_threads, threads);
+        settings.set_int(libtorrent::settings_pack::aio_threads, std::min(threads, 4));
+        libtorrent::set_piece_hashes(ct, parent, settings, on_piece, ec);
+#else
+        // libtorrent 1.2 sizes its own hashing pool
+        threads = 0;
+        libtorrent::set_piece_hashes(ct, parent, on_piece, ec);
+#endif
+
+        if (ec) {
+            return fail("Hashing failed: " + String(ec.message().c_str()));
+        }
+
+        std::vector<char> buffer;
+        libtorrent::bencode(std::back_inserter(buffer), ct.generate());
+
+        PackedByteArray torrent_data;
+        torrent_data.resize(buffer.size());
+        std::copy(buffer.begin(), buffer.end(), reinterpret_cast<char*>(torrent_data.ptrw()));
+
+        Dictionary result;
+        result["path"] = path;
+        result["format"] = format;
+        result["files"] = fs.num_files();
+        result["total_size"] = fs.total_size();
+        result["piece_size"] = ct.piece_length();
+        result["pieces"] = total_pieces;
+        result["hashing_threads"] = threads;
+        result["elapsed_ms"] = static_cast<int64_t>(Time::get_singleton()->get_ticks_msec() - start_msec);
+
+        libtorrent::torrent_info info(buffer.data(), static_cast<int>(buffer.size()), ec);
+        if (!ec) {
+#if LIBTORRENT_VERSION_NUM >= 20000
+            const auto& hashes = info.info_hashes();
+            result["info_hash"] = hashes.has_v1() ? hash_to_hex(hashes.v1) : String();
+            result["info_hash_v2"] = hashes.has_v2() ? hash_to_hex(hashes.v2) : String();
+#else
+            result["info_hash"] = hash_to_hex(info.info_hash());
+            result["info_hash_v2"] = String();
+#endif
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _last_result = result;
+        _last_torrent = std::move(buffer);
+        return torrent_data;
+    } catch (const std::exception& e) {
+        return fail("Exception creating torrent: " + String(e.what()));
+    }
+}
+
+PackedByteArray TorrentCreator::generate_resume_data(String save_path) {
+    std::vector<char> torrent;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        torrent = _last_torrent;
+    }
+
+    if (torrent.empty()) {
+        return fail("generate() must succeed before generate_resume_data()");
+    }
+    if (save_path.is_empty()) {
+        return fail("Save path cannot be empty");
+    }
+    if (save_path.begins_with("res://") || save_path.begins_with("user://")) {
+        save_path = ProjectSettings::get_singleton()->globalize_path(save_path);
+    }
+
+    try {
+        libtorrent::error_code ec;
+        auto info = std::make_shared<libtorrent::torrent_info>(torrent.data(), static_cast<int>(torrent.size()), ec);
+        if (ec) {
+            return fail("Failed to parse generated torrent: " + String(ec.message().c_str()));
+        }
+
+        // The pieces were hashed from these files moments ago, so mark them
+        // all present and let seed mode verify each one on first upload
+        libtorrent::add_torrent_params params;
+        params.ti = info;
+        params.save_path = save_path.utf8().get_data();
+        params.flags |= libtorrent::torrent_flags::seed_mode;
+        params.have_pieces.resize(info->num_pieces(), true);
+
+        std::vector<char> buffer = libtorrent::write_resume_data_buf(params);
+
+        PackedByteArray resume_data;
+        resume_data.resize(buffer.size());
+        std::copy(buffer.begin(), buffer.end(), reinterpret_cast<char*>(resume_data.ptrw()));
+        return resume_data;
+    } catch (const std::exception& e) {
+        return fail("Exception writing resume data: " + String(e.what()));
+    }
+}
+
+String TorrentCreator::get_last_error() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _last_error;
+}
+
+Dictionary TorrentCreator::get_last_result() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _last_result;
+}
+
+PackedByteArray TorrentCreator::fail(const String& message) {
+    UtilityFunctions::push_error("TorrentCreator: " + message);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _last_error = message;
+    return PackedByteArray();
+}
+
+int TorrentCreator::resolve_thread_count() const {
+    if (_thread_count > 0) {
+        return _thread_count;
+    }
+    unsigned int cores = std::thread::hardware_concurrency();
+    return cores > 0 ? static_cast<int>(cores) : 1;
+}
@@ -0,0 +1,93 @@
+#ifndef TORRENT_CREATOR_H
+#define TORRENT_CREATOR_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/variant/string.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/packed_string_array.hpp>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace godot;
+
+/**
+ * TorrentCreator - Builds .torrent files from a file or directory
+ *
+ * Walks the source path into a file_storage and hashes pieces through
+ * libtorrent's disk I/O, keeping one job in flight per hashing thread.
+ * generate() blocks and emits `progress` on the calling thread; run it
+ * from a Thread to keep the main loop responsive.
+ */
+class TorrentCreator : public RefCounted {
+    GDCLASS(TorrentCreator, RefCounted)
+
+public:
+    enum TorrentFormat {
+        FORMAT_V1 = 0,      // SHA-1 pieces, readable by every client
+        FORMAT_V2 = 1,      // SHA-256 merkle trees only (libtorrent 2.0)
+        FORMAT_HYBRID = 2   // Both, so v1 and v2 clients share one swarm (libtorrent 2.0)
+    };
+
+protected:
+    static void _bind_methods();
+
+public:
+    TorrentCreator();
+    ~TorrentCreator();
+
+    // Source and layout
+    void set_path(String path);
+    String get_path() const;
+    void set_format(int format);
+    int get_format() const;
+    bool is_format_supported(int format) const;
+    void set_piece_size(int bytes);
+    int get_piece_size() const;
+    void set_thread_count(int threads);
+    int get_thread_count() const;
+
+    // Metadata
+    void add_tracker(String url, int tier = 0);
+    void add_web_seed(String url);
+    void clear_trackers();
+    void clear_web_seeds();
+    void set_private(bool is_private);
+    bool is_private() const;
+    void set_comment(String comment);
+    String get_comment() const;
+    void set_creator(String creator);
+    String get_creator() const;
+
+    // Creation
+    PackedByteArray generate();
+    PackedByteArray generate_resume_data(String save_path);
+    String get_last_error() const;
+    Dictionary get_last_result() const;
+
+private:
+    mutable std::mutex _mutex;
+
+    String _path;
+    int _format;
+    int _piece_size;
+    int _thread_count;
+    bool _private;
+    String _comment;
+    String _creator;
+    std::vector<std::pair<std::string, int>> _trackers;
+    std::vector<std::string> _web_seeds;
+
+    String _last_error;
+    Dictionary _last_result;
+    std::vector<char> _last_torrent;
+
+    PackedByteArray fail(const String& message);
+    int resolve_thread_count() const;
+};
+
+VARIANT_ENUM_CAST(TorrentCreator::TorrentFormat);
+
+#endif // TORRENT_CREATOR_H
@@ -14,15 +14,116 @@
     #include <libtorrent/torrent_info.hpp>
     #include <libtorrent/peer_info.hpp>
     #include <libtorrent/hex.hpp>
+    #include <libtorrent/address.hpp>
+    #include <libtorrent/socket.hpp>
+    #include "peer_query.h"
+    #include "client_fingerprint.h"
 #endif
 
 using namespace godot;
 
+#ifndef TORRENT_STUB_MODE
+static_assert(TorrentHandle::PEER_FLAG_SEED == peer_query::FLAG_SEED &&
+    TorrentHandle::PEER_FLAG_ENCRYPTED == peer_query::FLAG_ENCRYPTED &&
+    TorrentHandle::PEER_FLAG_LOCAL == peer_query::FLAG_LOCAL &&
+    TorrentHandle::PEER_FLAG_CHOKED == peer_query::FLAG_CHOKED &&
+    TorrentHandle::PEER_FLAG_INTERESTING == peer_query::FLAG_INTERESTING &&
+    TorrentHandle::PEER_FLAG_REMOTE_CHOKED == peer_query::FLAG_REMOTE_CHOKED &&
+    TorrentHandle::PEER_FLAG_REMOTE_INTERESTED == peer_query::FLAG_REMOTE_INTERESTED,
+    "PeerFlag must match the peer_query flag bits");
+
+namespace {
+
+// One packed array per requested field, rows in selection order
+Dictionary peer_columns(const std::vector<libtorrent::peer_info>& peers, const std::vector<int>& selection, int fields) {
+    Dictionary columns;
+    int rows = static_cast<int>(selection.size());
+
+    if (fields & TorrentHandle::PEER_FIELD_IP) {
+        PackedStringArray ips;
+        ips.resize(rows);
+        for (int i = 0; i < rows; i++) {
+            ips.set(i, String(peers[selection[i]].ip.address().to_string().c_str()));
+        }
+        columns["ip"] = ips;
+    }
+    if (fields & TorrentHandle::PEER_FIELD_PORT) {
+        PackedInt32Array ports;
+        ports.resize(rows);
+        for (int i = 0; i < rows; i++) {
+            ports.set(i, peers[selection[i]].ip.port());
+        }
+        columns["port"] = ports;
+    }
+    if (fields & TorrentHandle::PEER_FIELD_CLIENT) {
+        PackedStringArray clients;
+        clients.resize(rows);
+        for (int i = 0; i < rows; i++) {
+            clients.set(i, String::utf8(client_fingerprint::client_name(peers[selection[i]]).c_str()));
+        }
+        columns["client"] = clients;
+    }
+    if (fields & TorrentHandle::PEER_FIELD_DOWNLOAD_RATE) {
+        PackedInt32Array rates;
+        rates.resize(rows);
+        for (int i = 0; i < rows; i++) {
+            rates.set(i, peers[selection[i]].down_speed);
+        }
+        columns["download_rate"] = rates;
+    }
+    if (fields & TorrentHandle::PEER_FIELD_UPLOAD_RATE) {
+        PackedInt32Array rates;
+        rates.resize(rows);
+        for (int i = 0; i < rows; i++) {
+            rates.set(i, peers[selection[i]].up_speed);
+        }
+        columns["upload_rate"] = rates;
+    }
+    if (fields & TorrentHandle::PEER_FIELD_TOTAL_DOWNLOAD) {
+        PackedInt64Array totals;
+        totals.resize(rows);
+        for (int i = 0; i < rows; i++) {
+            totals.set(i, peers[selection[i]].total_download);
+        }
+        columns["total_download"] = totals;
+    }
+    if (fields & TorrentHandle::PEER_FIELD_TOTAL_UPLOAD) {
+        PackedInt64Array totals;
+        totals.resize(rows);
+        for (int i = 0; i < rows; i++) {
+            totals.set(i, peers[selection[i]].total_upload);
+        }
+        columns["total_upload"] = totals;
+    }
+    if (fields & TorrentHandle::PEER_FIELD_PROGRESS) {
+        PackedFloat32Array progress;
+        progress.resize(rows);
+        for (int i = 0; i < rows; i++) {
+            progress.set(i, peers[selection[i]].progress);
+        }
+        columns["progress"] = progress;
+    }
+    if (fields & TorrentHandle::PEER_FIELD_FLAGS) {
+        PackedInt32Array flags;
+        flags.resize(rows);
+        for (int i = 0; i < rows; i++) {
+            flags.set(i, peer_query::flags_of(peers[selection[i]]));
+        }
+        columns["flags"] = flags;
+    }
+
+    return columns;
+}
+
+} // namespace
+#endif
+
 void TorrentHandle::_bind_methods() {
     ClassDB::bind_method(D_METHOD("pause"), &TorrentHandle::pause);
     ClassDB::bind_method(D_METHOD("resume"), &TorrentHandle::resume);
     ClassDB::bind_method(D_METHOD("is_paused"), &TorrentHandle::is_paused);
     ClassDB::bind_method(D_METHOD("is_valid"), &TorrentHandle::is_valid);
+    ClassDB::bind_method(D_METHOD("is_seed_mode"), &TorrentHandle::is_seed_mode);
     
     ClassDB::bind_method(D_METHOD("get_torrent_info"), &TorrentHandle::get_torrent_info);
     ClassDB::bind_method(D_METHOD("get_status"), &TorrentHandle::get_status);
@@ -44,8 +145,38 @@ void TorrentHandle::_bind_methods() {
     ClassDB::bind_method(D_METHOD("force_reannounce"), &TorrentHandle::force_reannounce);
     ClassDB::bind_method(D_METHOD("force_dht_announce"), &TorrentHandle::force_dht_announce);
     ClassDB::bind_method(D_METHOD("move_storage", "new_path"), &TorrentHandle::move_storage);
+
+    ClassDB::bind_method(D_METHOD("set_upload_limit", "bytes_per_second"), &TorrentHandle::set_upload_limit);
+    ClassDB::bind_method(D_METHOD("get_upload_limit"), &TorrentHandle::get_upload_limit);
+    ClassDB::bind_method(D_METHOD("set_download_limit", "bytes_per_second"), &TorrentHandle::set_download_limit);
+    ClassDB::bind_method(D_METHOD("get_download_limit"), &TorrentHandle::get_download_limit);
+    ClassDB::bind_method(D_METHOD("set_max_connections", "limit"), &TorrentHandle::set_max_connections);
+    ClassDB::bind_method(D_METHOD("get_max_connections"), &TorrentHandle::get_max_connections);
+    ClassDB::bind_method(D_METHOD("set_max_uploads", "limit"), &TorrentHandle::set_max_uploads);
+    ClassDB::bind_method(D_METHOD("get_max_uploads"), &TorrentHandle::get_max_uploads);
+
+    ClassDB::bind_method(D_METHOD("set_auto_managed", "auto_managed"), &TorrentHandle::set_auto_managed);
+    ClassDB::bind_method(D_METHOD("is_auto_managed"), &TorrentHandle::is_auto_managed);
+    ClassDB::bind_method(D_METHOD("get_queue_position"), &TorrentHandle::get_queue_position);
+    ClassDB::bind_method(D_METHOD("set_queue_position", "position"), &TorrentHandle::set_queue_position);
+    ClassDB::bind_method(D_METHOD("queue_position_up"), &TorrentHandle::queue_position_up);
+    ClassDB::bind_method(D_METHOD("queue_position_down"), &TorrentHandle::queue_position_down);
+    ClassDB::bind_method(D_METHOD("queue_position_top"), &TorrentHandle::queue_position_top);
+    ClassDB::bind_method(D_METHOD("queue_position_bottom"), &TorrentHandle::queue_position_bottom);
     
     ClassDB::bind_method(D_METHOD("get_peer_info"), &TorrentHandle::get_peer_info);
+    ClassDB::bind_method(D_METHOD("get_top_peers", "count", "sort_key", "fields", "require_flags", "exclude_flags", "client"),
+        &TorrentHandle::get_top_peers, DEFVAL(PEER_SORT_DOWNLOAD_RATE), DEFVAL(PEER_FIELD_ALL), DEFVAL(0), DEFVAL(0), DEFVAL(""));
+    ClassDB::bind_method(D_METHOD("request_peer_info_async", "count", "sort_key", "fields", "require_flags", "exclude_flags", "client"),
+        &TorrentHandle::request_peer_info_async, DEFVAL(-1), DEFVAL(PEER_SORT_DOWNLOAD_RATE), DEFVAL(PEER_FIELD_ALL), DEFVAL(0), DEFVAL(0), DEFVAL(""));
+    ClassDB::bind_method(D_METHOD("subscribe_peer_info", "interval_ms", "count", "sort_key", "fields", "require_flags", "exclude_flags", "client"),
+        &TorrentHandle::subscribe_peer_info, DEFVAL(-1), DEFVAL(PEER_SORT_DOWNLOAD_RATE), DEFVAL(PEER_FIELD_ALL), DEFVAL(0), DEFVAL(0), DEFVAL(""));
+    ClassDB::bind_method(D_METHOD("unsubscribe_peer_info"), &TorrentHandle::unsubscribe_peer_info);
+    ClassDB::bind_method(D_METHOD("is_peer_info_subscribed"), &TorrentHandle::is_peer_info_subscribed);
+    ClassDB::bind_method(D_METHOD("_deliver_peer_info"), &TorrentHandle::_deliver_peer_info);
+
+    ADD_SIGNAL(MethodInfo("peer_info_received", PropertyInfo(Variant::DICTIONARY, "peers")));
+    ClassDB::bind_method(D_METHOD("connect_peer", "ip", "port"), &TorrentHandle::connect_peer);
     
     ClassDB::bind_method(D_METHOD("scrape_tracker"), &TorrentHandle::scrape_tracker);
     ClassDB::bind_method(D_METHOD("flush_cache"), &TorrentHandle::flush_cache);
@@ -68,6 +199,31 @@ void TorrentHandle::_bind_methods() {
     // Internal methods for libtorrent integration
     ClassDB::bind_method(D_METHOD("_set_internal_handle", "handle"), &TorrentHandle::_set_internal_handle);
     ClassDB::bind_method(D_METHOD("_get_internal_handle"), &TorrentHandle::_get_internal_handle);
+
+    BIND_ENUM_CONSTANT(PEER_SORT_DOWNLOAD_RATE);
+    BIND_ENUM_CONSTANT(PEER_SORT_UPLOAD_RATE);
+    BIND_ENUM_CONSTANT(PEER_SORT_TOTAL_DOWNLOAD);
+    BIND_ENUM_CONSTANT(PEER_SORT_TOTAL_UPLOAD);
+    BIND_ENUM_CONSTANT(PEER_SORT_PROGRESS);
+
+    BIND_ENUM_CONSTANT(PEER_FIELD_IP);
+    BIND_ENUM_CONSTANT(PEER_FIELD_PORT);
+    BIND_ENUM_CONSTANT(PEER_FIELD_CLIENT);
+    BIND_ENUM_CONSTANT(PEER_FIELD_DOWNLOAD_RATE);
+    BIND_ENUM_CONSTANT(PEER_FIELD_UPLOAD_RATE);
+    BIND_ENUM_CONSTANT(PEER_FIELD_TOTAL_DOWNLOAD);
+    BIND_ENUM_CONSTANT(PEER_FIELD_TOTAL_UPLOAD);
+    BIND_ENUM_CONSTANT(PEER_FIELD_PROGRESS);
+    BIND_ENUM_CONSTANT(PEER_FIELD_FLAGS);
+    BIND_ENUM_CONSTANT(PEER_FIELD_ALL);
+
+    BIND_ENUM_CONSTANT(PEER_FLAG_SEED);
+    BIND_ENUM_CONSTANT(PEER_FLAG_ENCRYPTED);
+    BIND_ENUM_CONSTANT(PEER_FLAG_LOCAL);
+    BIND_ENUM_CONSTANT(PEER_FLAG_CHOKED);
+    BIND_ENUM_CONSTANT(PEER_FLAG_INTERESTING);
+    BIND_ENUM_CONSTANT(PEER_FLAG_REMOTE_CHOKED);
+    BIND_ENUM_CONSTANT(PEER_FLAG_REMOTE_INTERESTED);
 }
 
 TorrentHandle::TorrentHandle() {
@@ -77,6 +233,10 @@ TorrentHandle::TorrentHandle() {
     _stub_name = "Default Torrent";
     _stub_info_hash = "0123456789abcdef0123456789abcdef01234567";
     _resume_data_ready = false;
+    _peer_worker_running = false;
+    _peer_request_pending = false;
+    _peer_subscribed = false;
+    _peer_interval = std::chrono::milliseconds(1000);
 
     detect_build_mode();
     
@@ -88,6 +248,9 @@ TorrentHandle::TorrentHandle() {
 }
 
 TorrentHandle::~TorrentHandle() {
+    // The worker takes _handle_mutex, so it must be gone before we lock it
+    stop_peer_worker();
+
     try {
         std::lock_guard<std::mutex> lock(_handle_mutex);
         cleanup_handle();
@@ -118,6 +281,7 @@ void TorrentHandle::cleanup_handle() {
     }
     _handle_ptr = nullptr;
     _is_valid = false;
+    _torrent_info.unref();
 }
 
 bool TorrentHandle::validate_handle() const {
@@ -217,6 +381,28 @@ bool TorrentHandle::is_valid() const {
     return validate_handle();
 }
 
+bool TorrentHandle::is_seed_mode() const {
+    std::lock_guard<std::mutex> lock(_handle_mutex);
+
+    if (!validate_handle()) {
+        return false;
+    }
+
+    try {
+        if (!_is_stub_mode) {
+#ifndef TORRENT_STUB_MODE
+            // Cleared by libtorrent once every piece has been verified
+            libtorrent::torrent_handle* handle = static_cast<libtorrent::torrent_handle*>(_handle_ptr);
+            return static_cast<bool>(handle->flags() & libtorrent::torrent_flags::seed_mode);
+#endif
+        }
+    } catch (const std::exception& e) {
+        handle_operation_error("is_seed_mode", e);
+    }
+
+    return false;
+}
+
 Ref<TorrentInfo> TorrentHandle::get_torrent_info() {
     std::lock_guard<std::mutex> lock(_handle_mutex);
 
@@ -233,8 +419,13 @@ Ref<TorrentInfo> TorrentHandle::get_torrent_info() {
             libtorrent::torrent_handle* handle = static_cast<libtorrent::torrent_handle*>(_handle_ptr);
             std::shared_ptr<const libtorrent::torrent_info> ti = handle->torrent_file();
             if (ti) {
+                if (_torrent_info.is_valid() && _torrent_info->_get_internal_info() == ti) {
+                    return _torrent_info;
+                }
+
                 // Create a non-const shared_ptr copy for TorrentInfo
                 info->_set_internal_info(std::const_pointer_cast<libtorrent::torrent_info>(ti));
+                _torrent_info = info;
                 log_handle_operation("Retrieved real torrent info");
             }
 #endif
@@ -591,6 +782,264 @@ Array TorrentHandle::get_peer_info() {
     return peers;
 }
 
+Dictionary TorrentHandle::get_top_peers(int count, int sort_key, int fields, int require_flags, int exclude_flags, String client) {
+    std::lock_guard<std::mutex> lock(_handle_mutex);
+
+    Dictionary result;
+    result["total"] = 0;
+    result["matched"] = 0;
+
+    if (!validate_handle()) {
+        return result;
+    }
+
+    if (sort_key < PEER_SORT_DOWNLOAD_RATE || sort_key > PEER_SORT_PROGRESS) {
+        report_error("get_top_peers", "Invalid sort key: " + String::num_int64(sort_key));
+        return result;
+    }
+
+    try {
+        if (!_is_stub_mode) {
+#ifndef TORRENT_STUB_MODE
+            PeerRequest request;
+            request.count = count;
+            request.sort_key = sort_key;
+            request.fields = fields;
+            request.require_flags = require_flags;
+            request.exclude_flags = exclude_flags;
+            request.client = client;
+            result = collect_peers(*static_cast<libtorrent::torrent_handle*>(_handle_ptr), request);
+#endif
+        } else {
+            simulate_handle_operation("get_top_peers");
+        }
+    } catch (const std::exception& e) {
+        handle_operation_error("get_top_peers", e);
+    }
+
+    return result;
+}
+
+bool TorrentHandle::request_peer_info_async(int count, int sort_key, int fields, int require_flags, int exclude_flags, String client) {
+    if (!is_valid()) {
+        report_error("request_peer_info_async", "Invalid handle");
+        return false;
+    }
+    if (sort_key < PEER_SORT_DOWNLOAD_RATE || sort_key > PEER_SORT_PROGRESS) {
+        report_error("request_peer_info_async", "Invalid sort key: " + String::num_int64(sort_key));
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_peer_mutex);
+    // A request still waiting is replaced, so bursts collapse into one query
+    _peer_request = PeerRequest{count, sort_key, fields, require_flags, exclude_flags, client};
+    _peer_request_pending = true;
+    start_peer_worker();
+    _peer_cv.notify_one();
+    return true;
+}
+
+bool TorrentHandle::subscribe_peer_info(int interval_ms, int count, int sort_key, int fields, int require_flags, int exclude_flags, String client) {
+    if (!is_valid()) {
+        report_error("subscribe_peer_info", "Invalid handle");
+        return false;
+    }
+    if (interval_ms < 100) {
+        report_error("subscribe_peer_info", "Interval must be at least 100 ms");
+        return false;
+    }
+    if (sort_key < PEER_SORT_DOWNLOAD_RATE || sort_key > PEER_SORT_PROGRESS) {
+        report_error("subscribe_peer_info", "Invalid sort key: " + String::num_int64(sort_key));
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_peer_mutex);
+    _peer_subscription = PeerRequest{count, sort_key, fields, require_flags, exclude_flags, client};
+    _peer_interval = std::chrono::milliseconds(interval_ms);
+    _peer_next_due = std::chrono::steady_clock::now();
+    _peer_subscribed = true;
+    start_peer_worker();
+    _peer_cv.notify_one();
+    return true;
+}
+
+void TorrentHandle::unsubscribe_peer_info() {
+    std::lock_guard<std::mutex> lock(_peer_mutex);
+    _peer_subscribed = false;
+    _peer_cv.notify_one();
+}
+
+bool TorrentHandle::is_peer_info_subscribed() const {
+    std::lock_guard<std::mutex> lock(_peer_mutex);
+    return _peer_subscribed;
+}
+
+void TorrentHandle::_deliver_peer_info() {
+    std::vector<Dictionary> results;
+    {
+        std::lock_guard<std::mutex> lock(_peer_mutex);
+        results.swap(_peer_results);
+    }
+
+    for (const Dictionary& peers : results) {
+        emit_signal("peer_info_received", peers);
+    }
+}
+
+Dictionary TorrentHandle::collect_peers(const libtorrent::torrent_handle& handle, const PeerRequest& request) {
+    Dictionary result;
+#ifndef TORRENT_STUB_MODE
+    std::vector<libtorrent::peer_info> peer_list;
+    handle.get_peer_info(peer_list);
+
+    peer_query::Query query;
+    query.count = request.count;
+    query.sort_key = static_cast<peer_query::SortKey>(request.sort_key);
+    query.require_flags = request.require_flags;
+    query.exclude_flags = request.exclude_flags;
+    query.client = request.client.utf8().get_data();
+
+    int matched = 0;
+    std::vector<int> selection = peer_query::select(peer_list, query, matched);
+
+    result = peer_columns(peer_list, selection, request.fields);
+    result["total"] = static_cast<int>(peer_list.size());
+    result["matched"] = matched;
+#endif
+    return result;
+}
+
+bool TorrentHandle::fetch_peers(const PeerRequest& request, Dictionary& peers) const {
+#ifndef TORRENT_STUB_MODE
+    if (_is_stub_mode) {
+        return false;
+    }
+
+    // Copy the handle so the network thread round trip happens without our lock
+    libtorrent::torrent_handle handle;
+    {
+        std::lock_guard<std::mutex> lock(_handle_mutex);
+        if (!validate_handle()) {
+            return false;
+        }
+        handle = *static_cast<libtorrent::torrent_handle*>(_handle_ptr);
+    }
+
+    try {
+        peers = collect_peers(handle, request);
+        return true;
+    } catch (const std::exception& e) {
+        handle_operation_error("request_peer_info_async", e);
+    }
+#endif
+    return false;
+}
+
+void TorrentHandle::start_peer_worker() {
+    // NOTE: Caller must hold _peer_mutex lock
+    if (_peer_worker_running) {
+        return;
+    }
+    _peer_worker_running = true;
+    _peer_worker = std::thread(&TorrentHandle::peer_worker_loop, this);
+}
+
+void TorrentHandle::stop_peer_worker() {
+    {
+        std::lock_guard<std::mutex> lock(_peer_mutex);
+        _peer_worker_running = false;
+        _peer_subscribed = false;
+    }
+    _peer_cv.notify_one();
+
+    if (_peer_worker.joinable()) {
+        _peer_worker.join();
+    }
+}
+
+void TorrentHandle::peer_worker_loop() {
+    // Results waiting for the main thread; older ones are dropped if it stalls
+    constexpr size_t MAX_QUEUED_RESULTS = 4;
+
+    std::unique_lock<std::mutex> lock(_peer_mutex);
+    while (_peer_worker_running) {
+        bool due = _peer_subscribed && std::chrono::steady_clock::now() >= _peer_next_due;
+        if (!_peer_request_pending && !due) {
+            if (_peer_subscribed) {
+                _peer_cv.wait_until(lock, _peer_next_due);
+            } else {
+                _peer_cv.wait(lock);
+            }
+            continue;
+        }
+
+        bool subscription = !_peer_request_pending;
+        PeerRequest request = subscription ? _peer_subscription : _peer_request;
+        if (subscription) {
+            _peer_next_due = std::chrono::steady_clock::now() + _peer_interval;
+        } else {
+            _peer_request_pending = false;
+        }
+
+        lock.unlock();
+        Dictionary peers;
+        bool valid = fetch_peers(request, peers);
+        lock.lock();
+
+        if (!_peer_worker_running) {
+            break;
+        }
+        if (!valid) {
+            // The torrent is gone; nothing more to report
+            _peer_subscribed = false;
+            continue;
+        }
+
+        peers["subscription"] = subscription;
+        if (_peer_results.size() >= MAX_QUEUED_RESULTS) {
+            _peer_results.erase(_peer_results.begin());
+        }
+        _peer_results.push_back(peers);
+        // Emitted on the main thread; skipped by Godot if we are freed first
+        call_deferred("_deliver_peer_info");
+    }
+}
+
+void TorrentHandle::connect_peer(String ip, int port) {
+    std::lock_guard<std::mutex> lock(_handle_mutex);
+
+    if (!validate_handle()) {
+        UtilityFunctions::print_rich("[color=yellow]Cannot connect peer: Invalid handle[/color]");
+        return;
+    }
+
+    if (port <= 0 || port > 65535) {
+        report_error("connect_peer", "Invalid port: " + String::num(port));
+        return;
+    }
+
+    try {
+        if (!_is_stub_mode) {
+#ifndef TORRENT_STUB_MODE
+            libtorrent::error_code ec;
+            libtorrent::address address = libtorrent::make_address(ip.utf8().get_data(), ec);
+            if (ec) {
+                report_error("connect_peer", "Invalid IP address: " + ip);
+                return;
+            }
+
+            libtorrent::torrent_handle* handle = static_cast<libtorrent::torrent_handle*>(_handle_ptr);
+            handle->connect_peer(libtorrent::tcp::endpoint(address, static_cast<unsigned short>(port)));
+            log_handle_operation("Connecting to peer " + ip + ":" + String::num(port));
+#endif
+        } else {
+            simulate_handle_operation("connect_peer");
+        }
+    } catch (const std::exception& e) {
+        handle_operation_error("connect_peer", e);
+    }
+}
+
 void TorrentHandle::scrape_tracker() {
     std::lock_guard<std::mutex> lock(_handle_mutex);
     
@@ -892,6 +1341,361 @@ Array TorrentHandle::get_file_progress() {
     return progress;
 }
 
+void TorrentHandle::set_upload_limit(int bytes_per_second) {
+    std::lock_guard<std::mutex> lock(_handle_mutex);
+
+    if (!validate_handle()) {
+        return;
+    }
+
+    try {
+        if (!_is_stub_mode) {
+#ifndef TORRENT_STUB_MODE
+            libtorrent::torrent_handle* handle = static_cast<libtorrent::torrent_handle*>(_handle_ptr);
+            handle->set_upload_limit(bytes_per_second);
+            log_handle_operation("Upload limit set to " + String::num_int64(bytes_per_second));
+#endif
+        } else {
+            simulate_handle_operation("set_upload_limit");
+        }
+    } catch (const std::exception& e) {
+        handle_operation_error("set_upload_limit", e);
+    }
+}
+
+int TorrentHandle::get_upload_limit() const {
+    std::lock_guard<std::mutex> lock(_handle_mutex);
+
+    if (!validate_handle()) {
+        return 0;
+    }
+
+    try {
+        if (!_is_stub_mode) {
+#ifndef TORRENT_STUB_MODE
+            libtorrent::torrent_handle* handle = static_cast<libtorrent::torrent_handle*>(_handle_ptr);
+            return handle->upload_limit();
+#endif
+        }
+    } catch (const std::exception& e) {
+        handle_operation_error("get_upload_limit", e);
+    }
+
+    return 0;
+}
+
+void TorrentHandle::set_download_limit(int bytes_per_second) {
+    std::lock_guard<std::mutex> lock(_handle_mutex);
+
+    if (!validate_handle()) {
+        return;
+    }
+
+    try {
+        if (!_is_stub_mode) {
+#ifndef TORRENT_STUB_MODE
+            libtorrent::torrent_handle* handle = static_cast<libtorrent::torrent_handle*>(_handle_ptr);
+            handle->set_download_limit(bytes_per_second);
+            log_handle_operation("Download limit set to " + String::num_int64(bytes_per_second));
+#endif
+        } else {
+            simulate_handle_operation("set_download_limit");
+        }
+    } catch (const std::exception& e) {
+        handle_operation_error("set_download_limit", e);
+    }
+}
+
+int TorrentHandle::get_download_limit() const {
+    std::lock_guard<std::mutex> lock(_handle_mutex);
+
+    if (!validate_handle()) {
+        return 0;
+    }
+
+    try {
+        if (!_is_stub_mode) {
+#ifndef TORRENT_STUB_MODE
+            libtorrent::torrent_handle* handle = static_cast<libtorrent::torrent_handle*>(_handle_ptr);
+            return handle->download_limit();
+#endif
+        }
+    } catch (const std::exception& e) {
+        handle_operation_error("get_download_limit", e);
+    }
+
+    return 0;
+}
+
+void TorrentHandle::set_max_connections(int limit) {
+    std::lock_guard<std::mutex> lock(_handle_mutex);
+
+    if (!validate_handle()) {
+        return;
+    }
+
+    try {
+        if (!_is_stub_mode) {
+#ifndef TORRENT_STUB_MODE
+            libtorrent::torrent_handle* handle = static_cast<libtorrent::torrent_handle*>(_handle_ptr);
+            handle->set_max_connections(limit);
+            log_handle_operation("Max connections set to " + String::num_int64(limit));
+#endif
+        } else {
+            simulate_handle_operation("set_max_connections");
+        }
+    } catch (const std::exception& e) {
+        handle_operation_error("set_max_connections", e);
+    }
+}
+
+int TorrentHandle::get_max_connections() const {
+    std::lock_guard<std::mutex> lock(_handle_mutex);
+
+    if (!validate_handle()) {
+        return 0;
+    }
+
+    try {
+        if (!_is_stub_mode) {
+#ifndef TORRENT_STUB_MODE
+            libtorrent::torrent_handle* handle = static_cast<libtorrent::torrent_handle*>(_handle_ptr);
+            return handle->max_connections();
+#endif
+        }
+    } catch (const std::exception& e) {
+        handle_operation_error("get_max_connections", e);
+    }
+
+    return 0;
+}
+
+void TorrentHandle::set_max_uploads(int limit) {
+    std::lock_guard<std::mutex> lock(_handle_mutex);
+
+    if (!validate_handle()) {
+        return;
+    }
+
+    try {
+        if (!_is_stub_mode) {
+#ifndef TORRENT_STUB_MODE
+            libtorrent::torrent_handle* handle = static_cast<libtorrent::torrent_handle*>(_handle_ptr);
+            handle->set_max_uploads(limit);
+            log_handle_operation("Max uploads set to " + String::num_int64(limit));
+#endif
+        } else {
+            simulate_handle_operation("set_max_uploads");
+        }
+    } catch (const std::exception& e) {
+        handle_operation_error("set_max_uploads", e);
+    }
+}
+
+int TorrentHandle::get_max_uploads() const {
+    std::lock_guard<std::mutex> lock(_handle_mutex);
+
+    if (!validate_handle()) {
+        return 0;
+    }
+
+    try {
+        if (!_is_stub_mode) {
+#ifndef TORRENT_STUB_MODE
+            libtorrent::torrent_handle* handle = static_cast<libtorrent::torrent_handle*>(_handle_ptr);
+            return handle->max_uploads();
+#endif
+        }
+    } catch (const std::exception& e) {
+        handle_operation_error("get_max_uploads", e);
+    }
+
+    return 0;
+}
+
+void TorrentHandle::set_auto_managed(bool auto_managed) {
+    std::lock_guard<std::mutex> lock(_handle_mutex);
+
+    if (!validate_handle()) {
+        return;
+    }
+
+    try {
+        if (!_is_stub_mode) {
+#ifndef TORRENT_STUB_MODE
+            libtorrent::torrent_handle* handle = static_cast<libtorrent::torrent_handle*>(_handle_ptr);
+            if (auto_managed) {
+                handle->set_flags(libtorrent::torrent_flags::auto_managed);
+            } else {
+                handle->unset_flags(libtorrent::torrent_flags::auto_managed);
+            }
+            log_handle_operation(auto_managed ? "Auto-managed" : "Manually managed");
+#endif
+        } else {
+            simulate_handle_operation("set_auto_managed");
+        }
+    } catch (const std::exception& e) {
+        handle_operation_error("set_auto_managed", e);
+    }
+}
+
+bool TorrentHandle::is_auto_managed() const {
+    std::lock_guard<std::mutex> lock(_handle_mutex);
+
+    if (!validate_handle()) {
+        return false;
+    }
+
+    try {
+        if (!_is_stub_mode) {
+#ifndef TORRENT_STUB_MODE
+            libtorrent::torrent_handle* handle = static_cast<libtorrent::torrent_handle*>(_handle_ptr);
+            return static_cast<bool>(handle->flags() & libtorrent::torrent_flags::auto_managed);
+#endif
+        }
+    } catch (const std::exception& e) {
+        handle_operation_error("is_auto_managed", e);
+    }
+
+    return false;
+}
+
+int TorrentHandle::get_queue_position() const {
+    std::lock_guard<std::mutex> lock(_handle_mutex);
+
+    if (!validate_handle()) {
+        return -1;
+    }
+
+    try {
+        if (!_is_stub_mode) {
+#ifndef TORRENT_STUB_MODE
+            libtorrent::torrent_handle* handle = static_cast<libtorrent::torrent_handle*>(_handle_ptr);
+            return static_cast<int>(handle->queue_position());
+#endif
+        }
+    } catch (const std::exception& e) {
+        handle_operation_error("get_queue_position", e);
+    }
+
+    return -1;
+}
+
+void TorrentHandle::set_queue_position(int position) {
+    std::lock_guard<std::mutex> lock(_handle_mutex);
+
+    if (!validate_handle()) {
+        return;
+    }
+
+    if (position < 0) {
+        report_error("set_queue_position", "Queue position cannot be negative");
+        return;
+    }
+
+    try {
+        if (!_is_stub_mode) {
+#ifndef TORRENT_STUB_MODE
+            libtorrent::torrent_handle* handle = static_cast<libtorrent::torrent_handle*>(_handle_ptr);
+            handle->queue_position_set(libtorrent::queue_position_t{position});
+            log_handle_operation("Queue position set to " + String::num_int64(position));
+#endif
+        } else {
+            simulate_handle_operation("set_queue_position");
+        }
+    } catch (const std::exception& e) {
+        handle_operation_error("set_queue_position", e);
+    }
+}
+
+void TorrentHandle::queue_position_up() {
+    std::lock_guard<std::mutex> lock(_handle_mutex);
+
+    if (!validate_handle()) {
+        return;
+    }
+
+    try {
+        if (!_is_stub_mode) {
+#ifndef TORRENT_STUB_MODE
+            libtorrent::torrent_handle* handle = static_cast<libtorrent::torrent_handle*>(_handle_ptr);
+            handle->queue_position_up();
+            log_handle_operation("Moved up in queue");
+#endif
+        } else {
+            simulate_handle_operation("queue_position_up");
+        }
+    } catch (const std::exception& e) {
+        handle_operation_error("queue_position_up", e);
+    }
+}
+
+void TorrentHandle::queue_position_down() {
+    std::lock_guard<std::mutex> lock(_handle_mutex);
+
+    if (!validate_handle()) {
+        return;
+    }
+
+    try {
+        if (!_is_stub_mode) {
+#ifndef TORRENT_STUB_MODE
+            libtorrent::torrent_handle* handle = static_cast<libtorrent::torrent_handle*>(_handle_ptr);
+            handle->queue_position_down();
+            log_handle_operation("Moved down in queue");
+#endif
+        } else {
+            simulate_handle_operation("queue_position_down");
+        }
+    } catch (const std::exception& e) {
+        handle_operation_error("queue_position_down", e);
+    }
+}
+
+void TorrentHandle::queue_position_top() {
+    std::lock_guard<std::mutex> lock(_handle_mutex);
+
+    if (!validate_handle()) {
+        return;
+    }
+
+    try {
+        if (!_is_stub_mode) {
+#ifndef TORRENT_STUB_MODE
+            libtorrent::torrent_handle* handle = static_cast<libtorrent::torrent_handle*>(_handle_ptr);
+            handle->queue_position_top();
+            log_handle_operation("Moved to top of queue");
+#endif
+        } else {
+            simulate_handle_operation("queue_position_top");
+        }
+    } catch (const std::exception& e) {
+        handle_operation_error("queue_position_top", e);
+    }
+}
+
+void TorrentHandle::queue_position_bottom() {
+    std::lock_guard<std::mutex> lock(_handle_mutex);
+
+    if (!validate_handle()) {
+        return;
+    }
+
+    try {
+        if (!_is_stub_mode) {
+#ifndef TORRENT_STUB_MODE
+            libtorrent::torrent_handle* handle = static_cast<libtorrent::torrent_handle*>(_handle_ptr);
+            handle->queue_position_bottom();
+            log_handle_operation("Moved to bottom of queue");
+#endif
+        } else {
+            simulate_handle_operation("queue_position_bottom");
+        }
+    } catch (const std::exception& e) {
+        handle_operation_error("queue_position_bottom", e);
+    }
+}
+
 bool TorrentHandle::have_piece(int piece_index) const {
     std::lock_guard<std::mutex> lock(_handle_mutex);
 
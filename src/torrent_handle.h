@@ -6,8 +6,12 @@
 #include <godot_cpp/variant/dictionary.hpp>
 #include <godot_cpp/variant/array.hpp>
 #include <godot_cpp/variant/variant.hpp>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 using namespace godot;
 
@@ -29,6 +33,41 @@ namespace libtorrent {
 class TorrentHandle : public RefCounted {
     GDCLASS(TorrentHandle, RefCounted)
 
+public:
+    // Orderings for get_top_peers(), best first
+    enum PeerSortKey {
+        PEER_SORT_DOWNLOAD_RATE = 0,
+        PEER_SORT_UPLOAD_RATE = 1,
+        PEER_SORT_TOTAL_DOWNLOAD = 2,
+        PEER_SORT_TOTAL_UPLOAD = 3,
+        PEER_SORT_PROGRESS = 4
+    };
+
+    // Columns returned by get_top_peers()
+    enum PeerField {
+        PEER_FIELD_IP = 1,
+        PEER_FIELD_PORT = 2,
+        PEER_FIELD_CLIENT = 4,
+        PEER_FIELD_DOWNLOAD_RATE = 8,
+        PEER_FIELD_UPLOAD_RATE = 16,
+        PEER_FIELD_TOTAL_DOWNLOAD = 32,
+        PEER_FIELD_TOTAL_UPLOAD = 64,
+        PEER_FIELD_PROGRESS = 128,
+        PEER_FIELD_FLAGS = 256,
+        PEER_FIELD_ALL = 511
+    };
+
+    // Bits of the `flags` column and of the get_top_peers() filters
+    enum PeerFlag {
+        PEER_FLAG_SEED = 1,
+        PEER_FLAG_ENCRYPTED = 2,
+        PEER_FLAG_LOCAL = 4,
+        PEER_FLAG_CHOKED = 8,
+        PEER_FLAG_INTERESTING = 16,
+        PEER_FLAG_REMOTE_CHOKED = 32,
+        PEER_FLAG_REMOTE_INTERESTED = 64
+    };
+
 protected:
     static void _bind_methods();
 
@@ -41,6 +80,7 @@ public:
     void resume();
     bool is_paused() const;
     bool is_valid() const;
+    bool is_seed_mode() const;
     
     // Torrent information
     Ref<TorrentInfo> get_torrent_info();
@@ -66,9 +106,40 @@ public:
     void force_reannounce();
     void force_dht_announce();
     void move_storage(String new_path);
-    
+
+    // Per-torrent limits (0 or -1 means unlimited)
+    void set_upload_limit(int bytes_per_second);
+    int get_upload_limit() const;
+    void set_download_limit(int bytes_per_second);
+    int get_download_limit() const;
+    void set_max_connections(int limit);
+    int get_max_connections() const;
+    void set_max_uploads(int limit);
+    int get_max_uploads() const;
+
+    // Queueing (only auto-managed torrents are started and stopped by the queue)
+    void set_auto_managed(bool auto_managed);
+    bool is_auto_managed() const;
+    int get_queue_position() const;
+    void set_queue_position(int position);
+    void queue_position_up();
+    void queue_position_down();
+    void queue_position_top();
+    void queue_position_bottom();
+
     // Peer management
     Array get_peer_info();
+    Dictionary get_top_peers(int count, int sort_key = PEER_SORT_DOWNLOAD_RATE, int fields = PEER_FIELD_ALL,
+        int require_flags = 0, int exclude_flags = 0, String client = "");
+
+    // Same query off the main thread; results arrive through peer_info_received
+    bool request_peer_info_async(int count = -1, int sort_key = PEER_SORT_DOWNLOAD_RATE, int fields = PEER_FIELD_ALL,
+        int require_flags = 0, int exclude_flags = 0, String client = "");
+    bool subscribe_peer_info(int interval_ms, int count = -1, int sort_key = PEER_SORT_DOWNLOAD_RATE,
+        int fields = PEER_FIELD_ALL, int require_flags = 0, int exclude_flags = 0, String client = "");
+    void unsubscribe_peer_info();
+    bool is_peer_info_subscribed() const;
+    void connect_peer(String ip, int port);
     
     // Advanced operations
     void scrape_tracker();
@@ -95,6 +166,7 @@ public:
     // Internal methods for libtorrent integration
     void _set_internal_handle(const Variant& handle);
     Variant _get_internal_handle() const;
+    void _deliver_peer_info();
 
 private:
     // Handle storage (using void* for stub compatibility)
@@ -114,12 +186,43 @@ private:
     bool _resume_data_ready;
     mutable std::mutex _resume_data_mutex;
 
+    // Reused while the metadata is unchanged so its file table is built once
+    Ref<TorrentInfo> _torrent_info;
+
     // Thread safety
     mutable std::mutex _handle_mutex;
+
+    // Background peer queries, one worker per handle started on first use
+    struct PeerRequest {
+        int count = -1;
+        int sort_key = PEER_SORT_DOWNLOAD_RATE;
+        int fields = PEER_FIELD_ALL;
+        int require_flags = 0;
+        int exclude_flags = 0;
+        String client;
+    };
+    std::thread _peer_worker;
+    mutable std::mutex _peer_mutex;
+    std::condition_variable _peer_cv;
+    bool _peer_worker_running;
+    bool _peer_request_pending;
+    PeerRequest _peer_request;
+    bool _peer_subscribed;
+    std::chrono::milliseconds _peer_interval;
+    std::chrono::steady_clock::time_point _peer_next_due;
+    PeerRequest _peer_subscription;
+    std::vector<Dictionary> _peer_results;
     
     // Handle management
     void cleanup_handle();
     void detect_build_mode();
+
+    // Peer queries
+    static Dictionary collect_peers(const libtorrent::torrent_handle& handle, const PeerRequest& request);
+    bool fetch_peers(const PeerRequest& request, Dictionary& peers) const;
+    void start_peer_worker();
+    void stop_peer_worker();
+    void peer_worker_loop();
     
     // Error handling
     void handle_operation_error(const std::string& operation, const std::exception& e) const;
@@ -136,4 +239,8 @@ private:
     bool validate_priority(int priority) const;
 };
 
+VARIANT_ENUM_CAST(TorrentHandle::PeerSortKey);
+VARIANT_ENUM_CAST(TorrentHandle::PeerField);
+VARIANT_ENUM_CAST(TorrentHandle::PeerFlag);
+
 #endif // TORRENT_HANDLE_H
\ No newline at end of file
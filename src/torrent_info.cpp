@@ -6,6 +6,7 @@
 #include <libtorrent/announce_entry.hpp>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
 
 using namespace godot;
 
@@ -23,6 +24,12 @@ void TorrentInfo::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_file_path_at", "index"), &TorrentInfo::get_file_path_at);
     ClassDB::bind_method(D_METHOD("get_file_size_at", "index"), &TorrentInfo::get_file_size_at);
     ClassDB::bind_method(D_METHOD("get_files"), &TorrentInfo::get_files);
+    ClassDB::bind_method(D_METHOD("get_file_table"), &TorrentInfo::get_file_table);
+    ClassDB::bind_method(D_METHOD("find_file", "path"), &TorrentInfo::find_file);
+    ClassDB::bind_method(D_METHOD("find_files_with_prefix", "prefix"), &TorrentInfo::find_files_with_prefix);
+    ClassDB::bind_method(D_METHOD("find_files_matching", "pattern"), &TorrentInfo::find_files_matching);
+    ClassDB::bind_method(D_METHOD("map_file", "file_index", "offset", "size"), &TorrentInfo::map_file, DEFVAL(0), DEFVAL(-1));
+    ClassDB::bind_method(D_METHOD("map_piece_to_files", "piece_index"), &TorrentInfo::map_piece_to_files);
     
     ClassDB::bind_method(D_METHOD("get_piece_count"), &TorrentInfo::get_piece_count);
     ClassDB::bind_method(D_METHOD("get_piece_size"), &TorrentInfo::get_piece_size);
@@ -33,6 +40,11 @@ void TorrentInfo::_bind_methods() {
     
     ClassDB::bind_method(D_METHOD("is_valid"), &TorrentInfo::is_valid);
     ClassDB::bind_method(D_METHOD("is_private"), &TorrentInfo::is_private);
+
+    BIND_ENUM_CONSTANT(FILE_PAD);
+    BIND_ENUM_CONSTANT(FILE_HIDDEN);
+    BIND_ENUM_CONSTANT(FILE_EXECUTABLE);
+    BIND_ENUM_CONSTANT(FILE_SYMLINK);
 }
 
 TorrentInfo::TorrentInfo() : _torrent_info(nullptr) {
@@ -148,18 +160,165 @@ int64_t TorrentInfo::get_file_size_at(int index) const {
 Array TorrentInfo::get_files() const {
     Array files;
 
-    if (!_torrent_info) {
+    std::shared_ptr<const FileTable> table = get_table();
+    if (!table) {
         return files;
     }
 
-    int num_files = _torrent_info->num_files();
+    // Kept for compatibility; get_file_table() avoids one Dictionary per file
+    int num_files = table->paths.size();
+    files.resize(num_files);
     for (int i = 0; i < num_files; i++) {
-        files.append(get_file_at(i));
+        uint8_t flags = table->flags[i];
+        Dictionary file_info;
+        file_info["path"] = table->paths[i];
+        file_info["size"] = table->sizes[i];
+        file_info["offset"] = table->offsets[i];
+        file_info["pad_file"] = (flags & FILE_PAD) != 0;
+        file_info["hidden"] = (flags & FILE_HIDDEN) != 0;
+        file_info["executable"] = (flags & FILE_EXECUTABLE) != 0;
+        file_info["symlink"] = (flags & FILE_SYMLINK) != 0;
+        files[i] = file_info;
     }
 
     return files;
 }
 
+Dictionary TorrentInfo::get_file_table() const {
+    Dictionary file_table;
+
+    std::shared_ptr<const FileTable> table = get_table();
+    if (!table) {
+        return file_table;
+    }
+
+    // Packed arrays are copy-on-write, so this shares the cached columns
+    file_table["paths"] = table->paths;
+    file_table["sizes"] = table->sizes;
+    file_table["offsets"] = table->offsets;
+    file_table["flags"] = table->flags;
+
+    return file_table;
+}
+
+int TorrentInfo::find_file(String path) const {
+    std::shared_ptr<const FileTable> table = get_table();
+    if (!table) {
+        return -1;
+    }
+
+    std::string key = path.utf8().get_data();
+    std::replace(key.begin(), key.end(), '\\', '/');
+
+    auto it = table->index.find(key);
+    return it == table->index.end() ? -1 : it->second;
+}
+
+PackedInt32Array TorrentInfo::find_files_with_prefix(String prefix) const {
+    PackedInt32Array matches;
+
+    std::shared_ptr<const FileTable> table = get_table();
+    if (!table) {
+        return matches;
+    }
+
+    const String* paths = table->paths.ptr();
+    int num_files = table->paths.size();
+    for (int i = 0; i < num_files; i++) {
+        if (paths[i].begins_with(prefix)) {
+            matches.push_back(i);
+        }
+    }
+
+    return matches;
+}
+
+PackedInt32Array TorrentInfo::find_files_matching(String pattern) const {
+    PackedInt32Array matches;
+
+    std::shared_ptr<const FileTable> table = get_table();
+    if (!table) {
+        return matches;
+    }
+
+    // String::match() supports '*' and '?' wildcards
+    const String* paths = table->paths.ptr();
+    int num_files = table->paths.size();
+    for (int i = 0; i < num_files; i++) {
+        if (paths[i].match(pattern)) {
+            matches.push_back(i);
+        }
+    }
+
+    return matches;
+}
+
+Dictionary TorrentInfo::map_file(int file_index, int64_t offset, int64_t size) const {
+    Dictionary range;
+
+    if (!_torrent_info || file_index < 0 || file_index >= _torrent_info->num_files()) {
+        return range;
+    }
+
+    libtorrent::file_storage const& fs = _torrent_info->files();
+    libtorrent::file_index_t file(file_index);
+    int64_t file_size = fs.file_size(file);
+
+    if (offset < 0 || offset > file_size) {
+        return range;
+    }
+    // A negative size means up to the end of the file
+    if (size < 0 || offset + size > file_size) {
+        size = file_size - offset;
+    }
+
+    int64_t piece_length = fs.piece_length();
+    int64_t start = fs.file_offset(file) + offset;
+    int64_t end = start + size;
+
+    if (size == 0) {
+        // Empty files may sit at the very end; keep the piece index valid
+        int piece = std::min(static_cast<int>(start / piece_length), _torrent_info->num_pieces() - 1);
+        range["first_piece"] = piece;
+        range["first_piece_offset"] = static_cast<int>(start - piece * piece_length);
+        range["last_piece"] = piece;
+        range["last_piece_end"] = static_cast<int>(start - piece * piece_length);
+        range["size"] = size;
+        return range;
+    }
+
+    range["first_piece"] = static_cast<int>(start / piece_length);
+    range["first_piece_offset"] = static_cast<int>(start % piece_length);
+    range["last_piece"] = static_cast<int>((end - 1) / piece_length);
+    range["last_piece_end"] = static_cast<int>((end - 1) % piece_length + 1);
+    range["size"] = size;
+
+    return range;
+}
+
+Array TorrentInfo::map_piece_to_files(int piece_index) const {
+    Array slices;
+
+    if (!_torrent_info || piece_index < 0 || piece_index >= _torrent_info->num_pieces()) {
+        return slices;
+    }
+
+    libtorrent::file_storage const& fs = _torrent_info->files();
+    libtorrent::piece_index_t piece(piece_index);
+
+    // map_block binary searches the file offsets
+    for (auto const& slice : fs.map_block(piece, 0, fs.piece_size(piece))) {
+        Dictionary entry;
+        entry["file_index"] = static_cast<int>(slice.file_index);
+        entry["offset"] = slice.offset;
+        entry["size"] = slice.size;
+        entry["pad_file"] = fs.pad_file_at(slice.file_index);
+        slices.append(entry);
+    }
+
+    return slices;
+}
+
 int TorrentInfo::get_piece_count() const {
     if (!_torrent_info) {
         return 0;
@@ -234,9 +393,54 @@ bool TorrentInfo::is_private() const {
 }
 
 void TorrentInfo::_set_internal_info(std::shared_ptr<libtorrent::torrent_info> info) {
+    std::lock_guard<std::mutex> lock(_file_table_mutex);
     _torrent_info = info;
+    _file_table.reset();
 }
 
 std::shared_ptr<libtorrent::torrent_info> TorrentInfo::_get_internal_info() const {
     return _torrent_info;
-}
\ No newline at end of file
+}
+
+std::shared_ptr<const TorrentInfo::FileTable> TorrentInfo::get_table() const {
+    std::lock_guard<std::mutex> lock(_file_table_mutex);
+
+    if (_file_table || !_torrent_info || !_torrent_info->is_valid()) {
+        return _file_table;
+    }
+
+    libtorrent::file_storage const& fs = _torrent_info->files();
+    int num_files = fs.num_files();
+
+    auto table = std::make_shared<FileTable>();
+    table->paths.resize(num_files);
+    table->sizes.resize(num_files);
+    table->offsets.resize(num_files);
+    table->flags.resize(num_files);
+    table->index.reserve(num_files);
+
+    String* paths = table->paths.ptrw();
+    int64_t* sizes = table->sizes.ptrw();
+    int64_t* offsets = table->offsets.ptrw();
+    uint8_t* flags = table->flags.ptrw();
+
+    for (int i = 0; i < num_files; i++) {
+        libtorrent::file_index_t file(i);
+        std::string path = fs.file_path(file);
+        auto file_flags = fs.file_flags(file);
+
+        paths[i] = String::utf8(path.c_str());
+        sizes[i] = fs.file_size(file);
+        offsets[i] = fs.file_offset(file);
+        flags[i] = (fs.pad_file_at(file) ? FILE_PAD : 0) |
+                   ((file_flags & libtorrent::file_storage::flag_hidden) ? FILE_HIDDEN : 0) |
+                   ((file_flags & libtorrent::file_storage::flag_executable) ? FILE_EXECUTABLE : 0) |
+                   ((file_flags & libtorrent::file_storage::flag_symlink) ? FILE_SYMLINK : 0);
+
+        std::replace(path.begin(), path.end(), '\\', '/');
+        table->index.emplace(std::move(path), i);
+    }
+
+    _file_table = table;
+    return _file_table;
+}
@@ -5,7 +5,14 @@
 #include <godot_cpp/variant/string.hpp>
 #include <godot_cpp/variant/dictionary.hpp>
 #include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_int64_array.hpp>
+#include <godot_cpp/variant/packed_string_array.hpp>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 
 using namespace godot;
 
@@ -16,6 +23,15 @@ namespace libtorrent {
 class TorrentInfo : public RefCounted {
     GDCLASS(TorrentInfo, RefCounted)
 
+public:
+    // Bits of the `flags` column of get_file_table()
+    enum FileFlag {
+        FILE_PAD = 1,
+        FILE_HIDDEN = 2,
+        FILE_EXECUTABLE = 4,
+        FILE_SYMLINK = 8
+    };
+
 protected:
     static void _bind_methods();
 
@@ -39,6 +55,16 @@ public:
     int64_t get_file_size_at(int index) const;
     Array get_files() const;
 
+    // Columnar file table, built on first use and shared by the lookups below
+    Dictionary get_file_table() const;
+    int find_file(String path) const;
+    PackedInt32Array find_files_with_prefix(String prefix) const;
+    PackedInt32Array find_files_matching(String pattern) const;
+
+    // Byte range <-> piece mapping
+    Dictionary map_file(int file_index, int64_t offset = 0, int64_t size = -1) const;
+    Array map_piece_to_files(int piece_index) const;
+
     // Piece information
     int get_piece_count() const;
     int get_piece_size() const;
@@ -59,7 +85,23 @@ public:
     std::shared_ptr<libtorrent::torrent_info> _get_internal_info() const;
 
 private:
+    struct FileTable {
+        PackedStringArray paths;
+        PackedInt64Array sizes;
+        PackedInt64Array offsets;
+        PackedByteArray flags;
+        // Paths with '/' separators on every platform
+        std::unordered_map<std::string, int> index;
+    };
+
     std::shared_ptr<libtorrent::torrent_info> _torrent_info;
+
+    mutable std::mutex _file_table_mutex;
+    mutable std::shared_ptr<const FileTable> _file_table;
+
+    std::shared_ptr<const FileTable> get_table() const;
 };
 
+VARIANT_ENUM_CAST(TorrentInfo::FileFlag);
+
 #endif // TORRENT_INFO_H
\ No newline at end of file
@@ -1,10 +1,151 @@
 #include "torrent_logger.h"
+#include "binary_log_format.h"
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
 #include <godot_cpp/classes/time.hpp>
+#include <godot_cpp/classes/dir_access.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
 
 using namespace godot;
 
+namespace {
+
+// Default number of records held by the async ring (~1 MB)
+constexpr size_t DEFAULT_ASYNC_CAPACITY = 4096;
+
+// Maximum records written per batch before the file is flushed
+constexpr int ASYNC_BATCH_SIZE = 512;
+
+// How long the writer sleeps when the ring is empty
+constexpr auto ASYNC_IDLE_WAIT = std::chrono::milliseconds(20);
+
+// Interned ids reserved at construction: "{}" followed by the category
+// names, so a LogCategory maps to its string id without a lookup
+constexpr uint32_t FORMAT_ID_MESSAGE = 0;   // "{}" - plain log() calls
+constexpr uint32_t CATEGORY_ID_BASE = 1;    // ALL -> "" (uncategorized)
+constexpr uint32_t CATEGORY_ID_NONE = CATEGORY_ID_BASE;
+
+// Interned strings are never dropped and every binary log file carries the
+// ones it uses, so formats built at runtime must not grow the table forever.
+// Once it is full new strings are logged inline instead.
+constexpr size_t MAX_INTERNED_STRINGS = 4096;
+constexpr uint32_t INTERN_FULL = UINT32_MAX;
+
+// Per-thread cache in front of the intern table, keyed by the String's
+// buffer: a GDScript constant passed again shares its buffer, so its id is
+// found without a UTF-8 conversion or the intern lock. The text is compared
+// too since a freed buffer can be reused for another string.
+struct InternSlot {
+    uint64_t owner = 0;
+    const char32_t* data = nullptr;
+    std::u32string text;
+    uint32_t id = 0;
+    int8_t category = 0;
+};
+
+constexpr size_t INTERN_CACHE_SLOTS = 64;
+thread_local InternSlot intern_cache[INTERN_CACHE_SLOTS];
+
+std::atomic<uint64_t> next_intern_owner{1};
+
+const char* const CATEGORY_NAMES[TorrentLogger::CATEGORY_COUNT] = {
+    "", "SESSION", "TORRENT", "PEER", "TRACKER", "DHT",
+    "PORT_MAPPING", "STORAGE", "PERFORMANCE", "ALERT", "LOGGER"
+};
+
+constexpr uint32_t ALL_CATEGORIES_MASK = (1u << TorrentLogger::CATEGORY_COUNT) - 1;
+
+uint32_t category_string_id(TorrentLogger::LogCategory category) {
+    return CATEGORY_ID_BASE + static_cast<uint32_t>(category);
+}
+
+uint64_t now_usec() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Encode a UTF-32 Godot string straight into a fixed buffer without
+// allocating. Returns the number of bytes written; sets truncated when the
+// string did not fit.
+size_t encode_utf8(const char32_t* src, int64_t len, char* dst, size_t cap, bool& truncated) {
+    size_t out = 0;
+    truncated = false;
+
+    for (int64_t i = 0; i < len; i++) {
+        uint32_t c = static_cast<uint32_t>(src[i]);
+        size_t needed = c < 0x80 ? 1 : c < 0x800 ? 2 : c < 0x10000 ? 3 : 4;
+        if (out + needed > cap) {
+            truncated = true;
+            break;
+        }
+
+        if (needed == 1) {
+            dst[out++] = static_cast<char>(c);
+        } else if (needed == 2) {
+            dst[out++] = static_cast<char>(0xC0 | (c >> 6));
+            dst[out++] = static_cast<char>(0x80 | (c & 0x3F));
+        } else if (needed == 3) {
+            dst[out++] = static_cast<char>(0xE0 | (c >> 12));
+            dst[out++] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            dst[out++] = static_cast<char>(0x80 | (c & 0x3F));
+        } else {
+            dst[out++] = static_cast<char>(0xF0 | (c >> 18));
+            dst[out++] = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+            dst[out++] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            dst[out++] = static_cast<char>(0x80 | (c & 0x3F));
+        }
+    }
+
+    return out;
+}
+
+// Write a Godot string as a string argument, converting in place
+void encode_string_arg(binary_log::ArgEncoder& encoder, const String& value) {
+    size_t room = 0;
+    char* dest = encoder.begin_string(room);
+    if (!dest) {
+        return;
+    }
+
+    bool truncated = false;
+    size_t length = encode_utf8(value.ptr(), value.length(), dest, room, truncated);
+    encoder.commit_string(length, truncated);
+}
+
+void encode_variant_arg(binary_log::ArgEncoder& encoder, const Variant& value) {
+    switch (value.get_type()) {
+        case Variant::NIL:
+            encoder.add_nil();
+            break;
+        case Variant::BOOL:
+            encoder.add_bool(value.operator bool());
+            break;
+        case Variant::INT:
+            encoder.add_int(value.operator int64_t());
+            break;
+        case Variant::FLOAT:
+            encoder.add_float(value.operator double());
+            break;
+        case Variant::STRING:
+            encode_string_arg(encoder, value.operator String());
+            break;
+        default:
+            encode_string_arg(encoder, value.stringify());
+            break;
+    }
+}
+
+String rotated_path(const String& path, int index) {
+    return path + "." + String::num_int64(index);
+}
+
+} // namespace
+
 void TorrentLogger::_bind_methods() {
     // Logging control
     ClassDB::bind_method(D_METHOD("enable_logging", "enabled"), &TorrentLogger::enable_logging);
@@ -22,6 +163,20 @@ void TorrentLogger::_bind_methods() {
     ClassDB::bind_method(D_METHOD("set_log_file", "file_path"), &TorrentLogger::set_log_file);
     ClassDB::bind_method(D_METHOD("close_log_file"), &TorrentLogger::close_log_file);
     ClassDB::bind_method(D_METHOD("is_log_file_enabled"), &TorrentLogger::is_log_file_enabled);
+    ClassDB::bind_method(D_METHOD("set_log_format", "format"), &TorrentLogger::set_log_format);
+    ClassDB::bind_method(D_METHOD("get_log_format"), &TorrentLogger::get_log_format);
+    ClassDB::bind_method(D_METHOD("set_log_rotation", "max_bytes", "max_files"), &TorrentLogger::set_log_rotation, DEFVAL(5));
+
+    // Console output
+    ClassDB::bind_method(D_METHOD("set_console_output_enabled", "enabled"), &TorrentLogger::set_console_output_enabled);
+    ClassDB::bind_method(D_METHOD("is_console_output_enabled"), &TorrentLogger::is_console_output_enabled);
+
+    // Asynchronous backend
+    ClassDB::bind_method(D_METHOD("set_async_enabled", "enabled"), &TorrentLogger::set_async_enabled);
+    ClassDB::bind_method(D_METHOD("is_async_enabled"), &TorrentLogger::is_async_enabled);
+    ClassDB::bind_method(D_METHOD("set_async_capacity", "records"), &TorrentLogger::set_async_capacity);
+    ClassDB::bind_method(D_METHOD("get_async_capacity"), &TorrentLogger::get_async_capacity);
+    ClassDB::bind_method(D_METHOD("flush"), &TorrentLogger::flush);
 
     // Logging methods
     ClassDB::bind_method(D_METHOD("log_error", "message", "category"), &TorrentLogger::log_error, DEFVAL(""));
@@ -29,7 +184,22 @@ void TorrentLogger::_bind_methods() {
     ClassDB::bind_method(D_METHOD("log_info", "message", "category"), &TorrentLogger::log_info, DEFVAL(""));
     ClassDB::bind_method(D_METHOD("log_debug", "message", "category"), &TorrentLogger::log_debug, DEFVAL(""));
     ClassDB::bind_method(D_METHOD("log_trace", "message", "category"), &TorrentLogger::log_trace, DEFVAL(""));
-    ClassDB::bind_method(D_METHOD("log", "level", "message", "category"), &TorrentLogger::log, DEFVAL(""));
+    ClassDB::bind_method(D_METHOD("log", "level", "message", "category"),
+        static_cast<void (TorrentLogger::*)(LogLevel, const String&, const String&)>(&TorrentLogger::log), DEFVAL(""));
+    ClassDB::bind_method(D_METHOD("log_fmt", "level", "format", "args", "category"),
+        static_cast<void (TorrentLogger::*)(LogLevel, const String&, const Array&, const String&)>(&TorrentLogger::log_fmt), DEFVAL(""));
+
+    // libtorrent log alert sampling and tracing
+    ClassDB::bind_method(D_METHOD("set_sample_rate", "category", "one_in_n"), &TorrentLogger::set_sample_rate);
+    ClassDB::bind_method(D_METHOD("get_sample_rate", "category"), &TorrentLogger::get_sample_rate);
+    ClassDB::bind_method(D_METHOD("add_traced_peer", "address"), &TorrentLogger::add_traced_peer);
+    ClassDB::bind_method(D_METHOD("remove_traced_peer", "address"), &TorrentLogger::remove_traced_peer);
+    ClassDB::bind_method(D_METHOD("clear_traced_peers"), &TorrentLogger::clear_traced_peers);
+    ClassDB::bind_method(D_METHOD("get_traced_peers"), &TorrentLogger::get_traced_peers);
+    ClassDB::bind_method(D_METHOD("add_traced_torrent", "info_hash"), &TorrentLogger::add_traced_torrent);
+    ClassDB::bind_method(D_METHOD("remove_traced_torrent", "info_hash"), &TorrentLogger::remove_traced_torrent);
+    ClassDB::bind_method(D_METHOD("clear_traced_torrents"), &TorrentLogger::clear_traced_torrents);
+    ClassDB::bind_method(D_METHOD("get_traced_torrents"), &TorrentLogger::get_traced_torrents);
 
     // Statistics
     ClassDB::bind_method(D_METHOD("get_log_stats"), &TorrentLogger::get_log_stats);
@@ -54,30 +224,69 @@ void TorrentLogger::_bind_methods() {
     BIND_ENUM_CONSTANT(STORAGE);
     BIND_ENUM_CONSTANT(PERFORMANCE);
     BIND_ENUM_CONSTANT(ALERT);
+    BIND_ENUM_CONSTANT(LOGGER);
+
+    // Bind log file formats
+    BIND_ENUM_CONSTANT(FORMAT_TEXT);
+    BIND_ENUM_CONSTANT(FORMAT_BINARY);
 }
 
 TorrentLogger::TorrentLogger() {
     _enabled = false;
     _log_level = WARNING; // Default to warnings and errors
     _file_logging_enabled = false;
+    _log_format = FORMAT_TEXT;
+    _file_format = FORMAT_TEXT;
+    _rotation_max_bytes = 0;
+    _rotation_max_files = 5;
+    _log_file_bytes = 0;
+    _log_file_header_bytes = 0;
+    _file_last_timestamp = 0;
+    _console_enabled = true;
+
+    // Reserved interned strings (ids must match the constants above)
+    _intern_owner = next_intern_owner.fetch_add(1);
+    _intern_strings.push_back("{}");
+    _intern_categories.push_back(ALL);
+    _intern_ids["{}"] = FORMAT_ID_MESSAGE;
+    for (int i = 0; i < CATEGORY_COUNT; i++) {
+        _intern_ids[CATEGORY_NAMES[i]] = static_cast<uint32_t>(_intern_strings.size());
+        _intern_strings.push_back(CATEGORY_NAMES[i]);
+        _intern_categories.push_back(static_cast<int8_t>(i));
+    }
+
+    _async_capacity = DEFAULT_ASYNC_CAPACITY;
+    _async_enabled = false;
+    _async_producers = 0;
+    _writer_running = false;
+    _writer_busy = false;
 
     // Enable all categories by default
-    for (int i = 0; i < 10; i++) {
-        _category_filters[i] = true;
+    _category_mask = ALL_CATEGORIES_MASK;
+    update_active_level();
+
+    // No sampling, no tracing
+    for (int i = 0; i < CATEGORY_COUNT; i++) {
+        _sample_rates[i] = 1;
+        _sample_counters[i] = 0;
     }
+    _peer_trace_active = false;
+    _torrent_trace_active = false;
 
     // Reset statistics
     reset_log_stats();
 }
 
 TorrentLogger::~TorrentLogger() {
+    disable_async();
     close_log_file();
 }
 
 void TorrentLogger::enable_logging(bool enabled) {
     _enabled = enabled;
+    update_active_level();
     if (enabled) {
-        log_info("Logging enabled", "LOGGER");
+        log(INFO, "Logging enabled", LOGGER);
     }
 }
 
@@ -87,64 +296,140 @@ bool TorrentLogger::is_logging_enabled() const {
 
 void TorrentLogger::set_log_level(LogLevel level) {
     _log_level = level;
-    log_info("Log level set to: " + get_level_name(level), "LOGGER");
+    update_active_level();
+    log(INFO, "Log level set to: " + get_level_name(level), LOGGER);
+
+    if (level > TORRENT_LOG_MAX_LEVEL) {
+        UtilityFunctions::push_warning("Log level " + get_level_name(level) + " is above the compiled-in maximum (" +
+            get_level_name(static_cast<LogLevel>(TORRENT_LOG_MAX_LEVEL)) + "); those messages are not available in this build");
+    }
 }
 
 TorrentLogger::LogLevel TorrentLogger::get_log_level() const {
-    return _log_level;
+    return _log_level.load(std::memory_order_relaxed);
 }
 
 void TorrentLogger::enable_category(LogCategory category, bool enabled) {
-    if (category >= 0 && category < 10) {
-        _category_filters[category] = enabled;
+    // ALL is the uncategorized bucket and is never filtered
+    if (category <= ALL || category >= CATEGORY_COUNT) {
+        return;
+    }
+
+    if (enabled) {
+        _category_mask.fetch_or(1u << category, std::memory_order_relaxed);
+    } else {
+        _category_mask.fetch_and(~(1u << category), std::memory_order_relaxed);
     }
 }
 
 bool TorrentLogger::is_category_enabled(LogCategory category) const {
-    if (category >= 0 && category < 10) {
-        return _category_filters[category];
+    if (category >= 0 && category < CATEGORY_COUNT) {
+        return (_category_mask.load(std::memory_order_relaxed) & (1u << category)) != 0;
     }
     return false;
 }
 
 void TorrentLogger::enable_all_categories() {
-    for (int i = 0; i < 10; i++) {
-        _category_filters[i] = true;
-    }
+    _category_mask = ALL_CATEGORIES_MASK;
 }
 
 void TorrentLogger::disable_all_categories() {
-    for (int i = 0; i < 10; i++) {
-        _category_filters[i] = false;
-    }
+    _category_mask = 1u << ALL;
 }
 
 void TorrentLogger::set_log_file(const String& file_path) {
-    std::lock_guard<std::mutex> lock(_log_mutex);
+    // Records queued for the previous file go there, not into the new one
+    if (_async_enabled) {
+        flush();
+    }
 
-    close_log_file();
+    {
+        std::lock_guard<std::mutex> lock(_log_mutex);
 
-    _log_file = FileAccess::open(file_path, FileAccess::WRITE);
-    if (_log_file.is_valid()) {
-        _log_file_path = file_path;
-        _file_logging_enabled = true;
-
-        // Write header
-        String header = "=== godot-torrent Log File ===\n";
-        header += "Started: " + get_timestamp() + "\n";
-        header += "==============================\n\n";
-        _log_file->store_string(header);
-        _log_file->flush();
+        close_log_file_locked();
+        _file_format = _log_format;
 
-        log_info("Log file opened: " + file_path, "LOGGER");
-    } else {
-        UtilityFunctions::push_error("Failed to open log file: " + file_path);
+        if (!open_log_file_locked(file_path)) {
+            UtilityFunctions::push_error("Failed to open log file: " + file_path);
+            return;
+        }
     }
+
+    log(INFO, "Log file opened: " + file_path, LOGGER);
 }
 
 void TorrentLogger::close_log_file() {
+    // Make sure queued records reach the file before it goes away
+    if (_async_enabled) {
+        flush();
+    }
+
+    std::lock_guard<std::mutex> lock(_log_mutex);
+    close_log_file_locked();
+}
+
+bool TorrentLogger::is_log_file_enabled() const {
+    return _file_logging_enabled;
+}
+
+void TorrentLogger::set_log_format(LogFormat format) {
+    _log_format = format;
+
+    if (_file_logging_enabled && _file_format != format) {
+        UtilityFunctions::push_warning("Log format change applies to the next set_log_file() call");
+    }
+}
+
+TorrentLogger::LogFormat TorrentLogger::get_log_format() const {
+    return _log_format;
+}
+
+void TorrentLogger::set_log_rotation(int64_t max_bytes, int max_files) {
     std::lock_guard<std::mutex> lock(_log_mutex);
+    _rotation_max_bytes = max_bytes > 0 ? max_bytes : 0;
+    _rotation_max_files = max_files > 0 ? max_files : 0;
+}
 
+void TorrentLogger::set_console_output_enabled(bool enabled) {
+    _console_enabled = enabled;
+}
+
+bool TorrentLogger::is_console_output_enabled() const {
+    return _console_enabled;
+}
+
+bool TorrentLogger::open_log_file_locked(const String& file_path) {
+    // NOTE: Caller must hold _log_mutex lock
+    _log_file = FileAccess::open(file_path, FileAccess::WRITE);
+    if (!_log_file.is_valid()) {
+        return false;
+    }
+
+    _log_file_path = file_path;
+    _log_file_bytes = 0;
+    _file_last_timestamp = now_usec();
+    _file_emitted_ids.clear();
+
+    std::string header;
+    if (_file_format == FORMAT_BINARY) {
+        binary_log::append_file_header(header, _file_last_timestamp);
+    } else {
+        String text = "=== godot-torrent Log File ===\n";
+        text += "Started: " + get_timestamp() + "\n";
+        text += "==============================\n\n";
+        CharString utf8 = text.utf8();
+        header.assign(utf8.get_data(), utf8.length());
+    }
+
+    write_bytes_locked(header);
+    _log_file->flush();
+    _log_file_header_bytes = _log_file_bytes;
+    _file_logging_enabled = true;
+    return true;
+}
+
+void TorrentLogger::close_log_file_locked() {
+    // NOTE: Caller must hold _log_mutex lock
     if (_log_file.is_valid()) {
         _log_file->close();
         _log_file.unref();
@@ -153,8 +438,123 @@ void TorrentLogger::close_log_file() {
     }
 }
 
-bool TorrentLogger::is_log_file_enabled() const {
-    return _file_logging_enabled;
+void TorrentLogger::rotate_log_file_locked() {
+    // NOTE: Caller must hold _log_mutex lock
+    String path = _log_file_path;
+    _log_file->close();
+    _log_file.unref();
+
+    // log -> log.1 -> log.2 ... ; the oldest file falls off the end
+    if (_rotation_max_files > 0) {
+        String oldest = rotated_path(path, _rotation_max_files);
+        if (FileAccess::file_exists(oldest)) {
+            DirAccess::remove_absolute(oldest);
+        }
+        for (int i = _rotation_max_files - 1; i >= 1; i--) {
+            String from = rotated_path(path, i);
+            if (FileAccess::file_exists(from)) {
+                DirAccess::rename_absolute(from, rotated_path(path, i + 1));
+            }
+        }
+        DirAccess::rename_absolute(path, rotated_path(path, 1));
+    }
+
+    if (!open_log_file_locked(path)) {
+        _file_logging_enabled = false;
+        _log_file_path = "";
+        UtilityFunctions::push_error("Failed to reopen log file after rotation: " + path);
+    }
+}
+
+void TorrentLogger::write_bytes_locked(const std::string& bytes) {
+    // NOTE: Caller must hold _log_mutex lock
+    if (bytes.empty() || !_log_file.is_valid()) {
+        return;
+    }
+
+    PackedByteArray buffer;
+    buffer.resize(bytes.size());
+    memcpy(buffer.ptrw(), bytes.data(), bytes.size());
+    _log_file->store_buffer(buffer);
+    _log_file_bytes += static_cast<int64_t>(bytes.size());
+}
+
+void TorrentLogger::set_async_enabled(bool enabled) {
+    if (enabled == _async_enabled.load()) {
+        return;
+    }
+
+    if (enabled) {
+        if (!_async_ring) {
+            _async_ring.reset(new LogRingBuffer(_async_capacity));
+        }
+        start_writer();
+        _async_enabled = true;
+    } else {
+        disable_async();
+    }
+}
+
+void TorrentLogger::disable_async() {
+    _async_enabled = false;
+
+    // A producer that saw the backend enabled may still be pushing; once the
+    // count drops to zero every later producer sees it disabled
+    while (_async_producers.load() > 0) {
+        std::this_thread::yield();
+    }
+
+    // Drains whatever the last producers pushed
+    stop_writer();
+}
+
+bool TorrentLogger::is_async_enabled() const {
+    return _async_enabled;
+}
+
+void TorrentLogger::set_async_capacity(int records) {
+    if (records <= 0) {
+        UtilityFunctions::push_error("Async log capacity must be positive");
+        return;
+    }
+
+    if (_async_enabled) {
+        UtilityFunctions::push_warning("Async log capacity can only be changed while the async backend is disabled");
+        return;
+    }
+
+    // The ring is recreated with the new size on the next enable. Disabling
+    // waited for every producer, so nothing can still be pushing into it.
+    _async_capacity = static_cast<size_t>(records);
+    _async_ring.reset();
+}
+
+int TorrentLogger::get_async_capacity() const {
+    if (_async_ring) {
+        return static_cast<int>(_async_ring->capacity());
+    }
+    return static_cast<int>(_async_capacity);
+}
+
+void TorrentLogger::flush() {
+    if (!_async_enabled || !_async_ring) {
+        std::lock_guard<std::mutex> lock(_log_mutex);
+        if (_log_file.is_valid()) {
+            _log_file->flush();
+        }
+        return;
+    }
+
+    // Wake the writer and wait until it has caught up (bounded wait)
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (_async_ring->size_approx() > 0 || _writer_busy) {
+        _writer_cv.notify_one();
+        if (std::chrono::steady_clock::now() > deadline) {
+            UtilityFunctions::push_warning("TorrentLogger::flush timed out waiting for writer thread");
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
 }
 
 void TorrentLogger::log_error(const String& message, const String& category) {
@@ -178,26 +578,117 @@ void TorrentLogger::log_trace(const String& message, const String& category) {
 }
 
 void TorrentLogger::log(LogLevel level, const String& message, const String& category) {
-    if (!should_log(level, category)) {
+    if (!is_level_enabled(level)) {
         return;
     }
 
-    // Update statistics
-    switch (level) {
-        case ERROR: _log_count_error++; break;
-        case WARNING: _log_count_warning++; break;
-        case INFO: _log_count_info++; break;
-        case DEBUG: _log_count_debug++; break;
-        case TRACE: _log_count_trace++; break;
-        default: break;
+    // Known names resolve to their LogCategory through the intern table;
+    // custom categories are never filtered
+    LogCategory resolved = ALL;
+    uint32_t category_id = intern_category(category, resolved);
+    if (!is_enabled_for(level, resolved)) {
+        return;
     }
 
-    String formatted = format_log_message(level, message, category);
-    write_to_console(level, formatted);
+    if (category_id == INTERN_FULL) {
+        write_message(level, "[" + category + "] " + message, CATEGORY_ID_NONE);
+        return;
+    }
+    write_message(level, message, category_id);
+}
 
-    if (_file_logging_enabled) {
-        write_to_file(formatted);
+void TorrentLogger::log(LogLevel level, const String& message, LogCategory category) {
+    if (!is_enabled_for(level, category)) {
+        return;
     }
+
+    write_message(level, message, category_string_id(category));
+}
+
+void TorrentLogger::log_fmt(LogLevel level, const String& format, const Array& args, const String& category) {
+    if (!is_level_enabled(level)) {
+        return;
+    }
+
+    LogCategory resolved = ALL;
+    uint32_t category_id = intern_category(category, resolved);
+    if (!is_enabled_for(level, resolved)) {
+        return;
+    }
+
+    if (category_id == INTERN_FULL) {
+        write_fmt(level, "[" + category + "] " + format, args, CATEGORY_ID_NONE);
+        return;
+    }
+    write_fmt(level, format, args, category_id);
+}
+
+void TorrentLogger::log_fmt(LogLevel level, const String& format, const Array& args, LogCategory category) {
+    if (!is_enabled_for(level, category)) {
+        return;
+    }
+
+    write_fmt(level, format, args, category_string_id(category));
+}
+
+void TorrentLogger::write_message(LogLevel level, const String& message, uint32_t category_id) {
+    count_message(level);
+
+    // The message itself is the single argument of the "{}" format
+    LogRecord record;
+    init_record(record, level, FORMAT_ID_MESSAGE, category_id);
+
+    binary_log::ArgEncoder encoder(record.payload, LogRecord::MAX_PAYLOAD);
+    encode_string_arg(encoder, message);
+
+    record.argc = encoder.count();
+    record.length = static_cast<uint16_t>(encoder.size());
+    if (encoder.truncated()) {
+        // Only the ring needs fixed-size records; sync mode writes it whole
+        if (!_async_enabled.load()) {
+            CharString utf8 = message.utf8();
+            write_oversized(record, utf8.get_data(), static_cast<size_t>(utf8.length()));
+            return;
+        }
+        record.flags |= binary_log::FLAG_TRUNCATED;
+        _log_count_truncated.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    submit_record(record);
+}
+
+void TorrentLogger::write_fmt(LogLevel level, const String& format, const Array& args, uint32_t category_id) {
+    uint32_t format_id = intern_string(format);
+    if (format_id == INTERN_FULL) {
+        // Rendered here and sent as a plain message
+        write_message(level, format.format(args, "{}"), category_id);
+        return;
+    }
+
+    LogRecord record;
+    init_record(record, level, format_id, category_id);
+
+    binary_log::ArgEncoder encoder(record.payload, LogRecord::MAX_PAYLOAD);
+    for (int64_t i = 0; i < args.size(); i++) {
+        encode_variant_arg(encoder, args[i]);
+    }
+
+    if (encoder.truncated() && !_async_enabled.load()) {
+        // Too big for a record; rendered here and written whole
+        write_message(level, format.format(args, "{}"), category_id);
+        return;
+    }
+
+    count_message(level);
+
+    record.argc = encoder.count();
+    record.length = static_cast<uint16_t>(encoder.size());
+    if (encoder.truncated()) {
+        record.flags |= binary_log::FLAG_TRUNCATED;
+        _log_count_truncated.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    submit_record(record);
 }
 
 void TorrentLogger::process_libtorrent_alert(int alert_type, const String& alert_message) {
@@ -205,25 +696,158 @@ void TorrentLogger::process_libtorrent_alert(int alert_type, const String& alert
         return;
     }
 
-    LogLevel level = get_alert_log_level(alert_type);
-    String category = get_alert_category(alert_type);
+    log(get_alert_log_level(alert_type), alert_message, get_alert_category(alert_type));
+}
+
+void TorrentLogger::set_sample_rate(LogCategory category, int one_in_n) {
+    if (category < 0 || category >= CATEGORY_COUNT) {
+        UtilityFunctions::push_error("Invalid log category: " + String::num_int64(category));
+        return;
+    }
+
+    _sample_rates[category] = one_in_n > 1 ? static_cast<uint32_t>(one_in_n) : 1;
+    _sample_counters[category] = 0;
+}
+
+int TorrentLogger::get_sample_rate(LogCategory category) const {
+    if (category < 0 || category >= CATEGORY_COUNT) {
+        return 1;
+    }
+    return static_cast<int>(_sample_rates[category].load(std::memory_order_relaxed));
+}
+
+void TorrentLogger::add_traced_peer(const String& address) {
+    std::lock_guard<std::mutex> lock(_trace_mutex);
+    _traced_peers.insert(address.utf8().get_data());
+    _peer_trace_active = true;
+}
+
+void TorrentLogger::remove_traced_peer(const String& address) {
+    std::lock_guard<std::mutex> lock(_trace_mutex);
+    _traced_peers.erase(address.utf8().get_data());
+    _peer_trace_active = !_traced_peers.empty();
+}
+
+void TorrentLogger::clear_traced_peers() {
+    std::lock_guard<std::mutex> lock(_trace_mutex);
+    _traced_peers.clear();
+    _peer_trace_active = false;
+}
+
+PackedStringArray TorrentLogger::get_traced_peers() const {
+    PackedStringArray result;
+    std::lock_guard<std::mutex> lock(_trace_mutex);
+    for (const std::string& address : _traced_peers) {
+        result.append(String::utf8(address.c_str()));
+    }
+    return result;
+}
+
+void TorrentLogger::add_traced_torrent(const String& info_hash) {
+    std::lock_guard<std::mutex> lock(_trace_mutex);
+    _traced_torrents.insert(info_hash.to_lower().utf8().get_data());
+    _torrent_trace_active = true;
+}
+
+void TorrentLogger::remove_traced_torrent(const String& info_hash) {
+    std::lock_guard<std::mutex> lock(_trace_mutex);
+    _traced_torrents.erase(info_hash.to_lower().utf8().get_data());
+    _torrent_trace_active = !_traced_torrents.empty();
+}
+
+void TorrentLogger::clear_traced_torrents() {
+    std::lock_guard<std::mutex> lock(_trace_mutex);
+    _traced_torrents.clear();
+    _torrent_trace_active = false;
+}
+
+PackedStringArray TorrentLogger::get_traced_torrents() const {
+    PackedStringArray result;
+    std::lock_guard<std::mutex> lock(_trace_mutex);
+    for (const std::string& info_hash : _traced_torrents) {
+        result.append(String::utf8(info_hash.c_str()));
+    }
+    return result;
+}
+
+bool TorrentLogger::is_peer_traced(const std::string& address) const {
+    std::lock_guard<std::mutex> lock(_trace_mutex);
+    return _traced_peers.count(address) > 0;
+}
 
-    log(level, alert_message, category);
+bool TorrentLogger::is_torrent_traced(const std::string& info_hash) const {
+    std::lock_guard<std::mutex> lock(_trace_mutex);
+    return _traced_torrents.count(info_hash) > 0;
+}
+
+bool TorrentLogger::sample(LogCategory category) {
+    uint32_t rate = _sample_rates[category].load(std::memory_order_relaxed);
+    if (rate <= 1) {
+        return true;
+    }
+
+    if (_sample_counters[category].fetch_add(1, std::memory_order_relaxed) % rate == 0) {
+        return true;
+    }
+
+    _log_count_sampled_out.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void TorrentLogger::log_native(LogLevel level, LogCategory category, const char* message, size_t length) {
+    if (!is_enabled_for(level, category)) {
+        return;
+    }
+
+    count_message(level);
+
+    // libtorrent already hands us UTF-8, so it goes straight into the payload
+    LogRecord record;
+    init_record(record, level, FORMAT_ID_MESSAGE, category_string_id(category));
+
+    binary_log::ArgEncoder encoder(record.payload, LogRecord::MAX_PAYLOAD);
+    encoder.add_string(message, length);
+
+    record.argc = encoder.count();
+    record.length = static_cast<uint16_t>(encoder.size());
+    if (encoder.truncated()) {
+        if (!_async_enabled.load()) {
+            write_oversized(record, message, length);
+            return;
+        }
+        record.flags |= binary_log::FLAG_TRUNCATED;
+        _log_count_truncated.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    submit_record(record);
 }
 
 Dictionary TorrentLogger::get_log_stats() const {
     Dictionary stats;
-    stats["enabled"] = _enabled;
-    stats["log_level"] = static_cast<int>(_log_level);
-    stats["file_logging"] = _file_logging_enabled;
-    stats["log_file_path"] = _log_file_path;
-    stats["error_count"] = _log_count_error;
-    stats["warning_count"] = _log_count_warning;
-    stats["info_count"] = _log_count_info;
-    stats["debug_count"] = _log_count_debug;
-    stats["trace_count"] = _log_count_trace;
-    stats["total_count"] = _log_count_error + _log_count_warning + _log_count_info +
-                          _log_count_debug + _log_count_trace;
+    stats["enabled"] = _enabled.load();
+    stats["log_level"] = static_cast<int>(_log_level.load());
+    stats["compiled_max_level"] = TORRENT_LOG_MAX_LEVEL;
+    stats["file_logging"] = _file_logging_enabled.load();
+    {
+        // The writer thread updates these on every write and rotation
+        std::lock_guard<std::mutex> lock(_log_mutex);
+        stats["log_file_path"] = _log_file_path;
+        stats["log_file_bytes"] = _log_file_bytes;
+    }
+    stats["log_format"] = static_cast<int>(_log_format);
+    stats["error_count"] = _log_count_error.load();
+    stats["warning_count"] = _log_count_warning.load();
+    stats["info_count"] = _log_count_info.load();
+    stats["debug_count"] = _log_count_debug.load();
+    stats["trace_count"] = _log_count_trace.load();
+    stats["total_count"] = _log_count_error.load() + _log_count_warning.load() + _log_count_info.load() +
+                          _log_count_debug.load() + _log_count_trace.load();
+    stats["async_enabled"] = _async_enabled.load();
+    stats["async_capacity"] = get_async_capacity();
+    stats["async_pending"] = _async_ring ? static_cast<int64_t>(_async_ring->size_approx()) : 0;
+    stats["dropped_count"] = _async_ring ? static_cast<int64_t>(_async_ring->dropped_count()) : 0;
+    stats["truncated_count"] = _log_count_truncated.load();
+    stats["sampled_out_count"] = _log_count_sampled_out.load();
     return stats;
 }
 
@@ -233,45 +857,37 @@ void TorrentLogger::reset_log_stats() {
     _log_count_info = 0;
     _log_count_debug = 0;
     _log_count_trace = 0;
-}
+    _log_count_truncated = 0;
+    _log_count_sampled_out = 0;
 
-bool TorrentLogger::should_log(LogLevel level, const String& category) const {
-    if (!_enabled || level == NONE) {
-        return false;
-    }
-
-    // Check log level
-    if (level > _log_level) {
-        return false;
+    if (_async_ring) {
+        _async_ring->reset_dropped_count();
     }
+}
 
-    // Check category filter (if category is specified)
-    if (!category.is_empty()) {
-        // Simple category matching
-        if (category == "SESSION" && !_category_filters[SESSION]) return false;
-        if (category == "TORRENT" && !_category_filters[TORRENT]) return false;
-        if (category == "PEER" && !_category_filters[PEER]) return false;
-        if (category == "TRACKER" && !_category_filters[TRACKER]) return false;
-        if (category == "DHT" && !_category_filters[DHT]) return false;
-        if (category == "PORT_MAPPING" && !_category_filters[PORT_MAPPING]) return false;
-        if (category == "STORAGE" && !_category_filters[STORAGE]) return false;
-        if (category == "PERFORMANCE" && !_category_filters[PERFORMANCE]) return false;
-        if (category == "ALERT" && !_category_filters[ALERT]) return false;
+void TorrentLogger::count_message(LogLevel level) {
+    switch (level) {
+        case ERROR: _log_count_error.fetch_add(1, std::memory_order_relaxed); break;
+        case WARNING: _log_count_warning.fetch_add(1, std::memory_order_relaxed); break;
+        case INFO: _log_count_info.fetch_add(1, std::memory_order_relaxed); break;
+        case DEBUG: _log_count_debug.fetch_add(1, std::memory_order_relaxed); break;
+        case TRACE: _log_count_trace.fetch_add(1, std::memory_order_relaxed); break;
+        default: break;
     }
-
-    return true;
 }
 
-String TorrentLogger::format_log_message(LogLevel level, const String& message, const String& category) const {
-    String formatted = "[" + get_timestamp() + "] ";
-    formatted += "[" + get_level_name(level) + "]";
+bool TorrentLogger::is_level_enabled(LogLevel level) const {
+    return level <= _active_level.load(std::memory_order_relaxed) && level != NONE;
+}
 
-    if (!category.is_empty()) {
-        formatted += " [" + category + "]";
+void TorrentLogger::update_active_level() {
+    // Folds the enabled flag, the runtime level and the compiled-in maximum
+    // into a single value so the hot path does one compare
+    int level = _enabled ? static_cast<int>(_log_level.load()) : static_cast<int>(NONE);
+    if (level > TORRENT_LOG_MAX_LEVEL) {
+        level = TORRENT_LOG_MAX_LEVEL;
     }
-
-    formatted += " " + message;
-    return formatted;
+    _active_level = level;
 }
 
 String TorrentLogger::get_level_name(LogLevel level) const {
@@ -322,15 +938,6 @@ void TorrentLogger::write_to_console(LogLevel level, const String& formatted_mes
     }
 }
 
-void TorrentLogger::write_to_file(const String& formatted_message) {
-    std::lock_guard<std::mutex> lock(_log_mutex);
-
-    if (_log_file.is_valid()) {
-        _log_file->store_line(formatted_message);
-        _log_file->flush();
-    }
-}
-
 TorrentLogger::LogLevel TorrentLogger::get_alert_log_level(int alert_type) const {
     // Map alert types to log levels
     // This is a simplified mapping - can be expanded based on libtorrent alert types
@@ -354,8 +961,309 @@ TorrentLogger::LogLevel TorrentLogger::get_alert_log_level(int alert_type) const
     }
 }
 
-String TorrentLogger::get_alert_category(int alert_type) const {
+TorrentLogger::LogCategory TorrentLogger::get_alert_category(int alert_type) const {
     // This is a simplified categorization
     // In practice, you'd need to check specific alert type values from libtorrent
-    return "ALERT";
+    return ALERT;
+}
+
+uint32_t TorrentLogger::intern_string(const String& value, LogCategory* category) {
+    const char32_t* data = value.ptr();
+    int64_t length = value.length();
+
+    InternSlot* slot = nullptr;
+    if (data && length > 0) {
+        slot = &intern_cache[(reinterpret_cast<uintptr_t>(data) >> 4) % INTERN_CACHE_SLOTS];
+        if (slot->owner == _intern_owner && slot->data == data &&
+            slot->text.size() == static_cast<size_t>(length) &&
+            std::char_traits<char32_t>::compare(slot->text.data(), data, static_cast<size_t>(length)) == 0) {
+            if (category) {
+                *category = static_cast<LogCategory>(slot->category);
+            }
+            return slot->id;
+        }
+    }
+
+    CharString utf8 = value.utf8();
+    std::string key(utf8.get_data(), utf8.length());
+
+    uint32_t id;
+    int8_t resolved;
+    {
+        std::lock_guard<std::mutex> lock(_intern_mutex);
+        auto it = _intern_ids.find(key);
+        if (it != _intern_ids.end()) {
+            id = it->second;
+        } else if (_intern_strings.size() >= MAX_INTERNED_STRINGS) {
+            if (category) {
+                *category = ALL;
+            }
+            return INTERN_FULL;
+        } else {
+            id = static_cast<uint32_t>(_intern_strings.size());
+            _intern_strings.push_back(key);
+            _intern_categories.push_back(ALL);
+            _intern_ids.emplace(std::move(key), id);
+        }
+        resolved = _intern_categories[id];
+    }
+
+    // Ids never change once assigned, so the slot stays valid
+    if (slot) {
+        slot->owner = _intern_owner;
+        slot->data = data;
+        slot->text.assign(data, static_cast<size_t>(length));
+        slot->id = id;
+        slot->category = resolved;
+    }
+
+    if (category) {
+        *category = static_cast<LogCategory>(resolved);
+    }
+    return id;
+}
+
+uint32_t TorrentLogger::intern_category(const String& name, LogCategory& category) {
+    if (name.is_empty()) {
+        category = ALL;
+        return CATEGORY_ID_NONE;
+    }
+
+    return intern_string(name, &category);
+}
+
+const std::string& TorrentLogger::lookup_string_locked(uint32_t id) {
+    // NOTE: Caller must hold _log_mutex lock
+    if (id >= _string_cache.size()) {
+        std::lock_guard<std::mutex> lock(_intern_mutex);
+        for (size_t i = _string_cache.size(); i < _intern_strings.size(); i++) {
+            _string_cache.push_back(_intern_strings[i]);
+        }
+    }
+
+    if (id >= _string_cache.size()) {
+        return _string_cache[CATEGORY_ID_NONE];
+    }
+    return _string_cache[id];
+}
+
+void TorrentLogger::init_record(LogRecord& record, LogLevel level, uint32_t format_id, uint32_t category_id) {
+    record.timestamp_usec = now_usec();
+    record.category_id = category_id;
+    record.format_id = format_id;
+    record.level = static_cast<uint8_t>(level);
+    record.flags = 0;
+    record.argc = 0;
+    record.length = 0;
+}
+
+void TorrentLogger::submit_record(const LogRecord& record) {
+    // Async mode: the record goes into the ring, the writer does the rest.
+    // Drop-on-overflow: the ring counts the drop, the caller never blocks.
+    _async_producers.fetch_add(1);
+    if (_async_enabled.load()) {
+        _async_ring->try_push(record);
+        _async_producers.fetch_sub(1);
+        return;
+    }
+    _async_producers.fetch_sub(1);
+
+    std::lock_guard<std::mutex> lock(_log_mutex);
+    write_records_locked(&record, 1);
+    if (_log_file.is_valid()) {
+        _log_file->flush();
+    }
+}
+
+void TorrentLogger::write_oversized(const LogRecord& record, const char* message, size_t length) {
+    // A single string argument in a heap payload instead of the record's own
+    std::string payload;
+    payload.reserve(length + 6);
+    payload.push_back(static_cast<char>(binary_log::ARG_STRING));
+    binary_log::append_varint(payload, length);
+    payload.append(message, length);
+
+    LogRecord header = record;
+    header.argc = 1;
+    header.length = 0;
+
+    std::lock_guard<std::mutex> lock(_log_mutex);
+    std::string batch;
+    append_record_locked(header, reinterpret_cast<const uint8_t*>(payload.data()), payload.size(), batch);
+    write_bytes_locked(batch);
+    if (_log_file.is_valid()) {
+        _log_file->flush();
+    }
+}
+
+void TorrentLogger::write_records_locked(const LogRecord* records, int count) {
+    // NOTE: Caller must hold _log_mutex lock
+    std::string batch;
+    for (int i = 0; i < count; i++) {
+        if (!append_record_locked(records[i], records[i].payload, records[i].length, batch)) {
+            return;
+        }
+    }
+
+    write_bytes_locked(batch);
+}
+
+bool TorrentLogger::append_record_locked(const LogRecord& record, const uint8_t* payload, size_t length,
+        std::string& batch) {
+    // NOTE: Caller must hold _log_mutex lock
+    bool console = _console_enabled.load(std::memory_order_relaxed);
+    bool to_file = _log_file.is_valid();
+    bool binary = to_file && _file_format == FORMAT_BINARY;
+
+    std::string entry;
+
+    // Text is only rendered when something will show it
+    if (console || (to_file && !binary)) {
+        std::string line = format_record_text(record, payload, length);
+        if (console) {
+            write_to_console(static_cast<LogLevel>(record.level), String::utf8(line.c_str(), line.size()));
+        }
+        if (to_file && !binary) {
+            entry = std::move(line);
+            entry.push_back('\n');
+        }
+    }
+
+    if (!to_file) {
+        return true;
+    }
+
+    if (binary) {
+        encode_binary_entry(record, payload, length, entry);
+    }
+
+    // Size-based rotation, never leaving a file with only a header
+    int64_t pending = static_cast<int64_t>(batch.size() + entry.size());
+    bool has_records = _log_file_bytes + static_cast<int64_t>(batch.size()) > _log_file_header_bytes;
+    if (_rotation_max_bytes > 0 && has_records && _log_file_bytes + pending > _rotation_max_bytes) {
+        write_bytes_locked(batch);
+        batch.clear();
+        rotate_log_file_locked();
+
+        if (!_log_file.is_valid()) {
+            return false;
+        }
+
+        // String definitions restart in the new file
+        if (binary) {
+            entry.clear();
+            encode_binary_entry(record, payload, length, entry);
+        }
+    }
+
+    batch += entry;
+    return true;
+}
+
+std::string TorrentLogger::format_record_text(const LogRecord& record, const uint8_t* payload, size_t length) {
+    std::vector<binary_log::DecodedArg> args;
+    binary_log::decode_args(payload, length, record.argc, args);
+
+    std::string line = "[" + binary_log::format_timestamp(record.timestamp_usec) + "] [";
+    line += binary_log::level_name(record.level);
+    line += "]";
+
+    const std::string& category = lookup_string_locked(record.category_id);
+    if (!category.empty()) {
+        line += " [" + category + "]";
+    }
+
+    line += " ";
+    line += binary_log::format_message(lookup_string_locked(record.format_id), args);
+    if (record.flags & binary_log::FLAG_TRUNCATED) {
+        line += "...";
+    }
+    return line;
+}
+
+void TorrentLogger::encode_binary_entry(const LogRecord& record, const uint8_t* payload, size_t length,
+        std::string& out) {
+    // NOTE: Caller must hold _log_mutex lock
+    uint32_t ids[2] = { record.category_id, record.format_id };
+    for (uint32_t id : ids) {
+        if (id >= _file_emitted_ids.size()) {
+            _file_emitted_ids.resize(id + 1, false);
+        }
+        if (!_file_emitted_ids[id]) {
+            binary_log::append_string_entry(out, id, lookup_string_locked(id));
+            _file_emitted_ids[id] = true;
+        }
+    }
+
+    int64_t delta = static_cast<int64_t>(record.timestamp_usec - _file_last_timestamp);
+    _file_last_timestamp = record.timestamp_usec;
+
+    binary_log::append_record_entry(out, delta, static_cast<uint8_t>(record.level | record.flags),
+        record.category_id, record.format_id, record.argc, payload, length);
+}
+
+void TorrentLogger::start_writer() {
+    if (_writer_running) {
+        return;
+    }
+
+    _writer_batch.resize(ASYNC_BATCH_SIZE);
+    _writer_running = true;
+    _writer_thread = std::thread(&TorrentLogger::writer_loop, this);
+}
+
+void TorrentLogger::stop_writer() {
+    if (!_writer_running) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_writer_mutex);
+        _writer_running = false;
+    }
+    _writer_cv.notify_one();
+
+    if (_writer_thread.joinable()) {
+        _writer_thread.join();
+    }
+
+    // Write out anything that was queued while the writer was shutting down
+    if (_async_ring) {
+        while (drain_ring() > 0) {
+        }
+    }
+}
+
+void TorrentLogger::writer_loop() {
+    while (_writer_running) {
+        if (drain_ring() > 0) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_writer_mutex);
+        _writer_cv.wait_for(lock, ASYNC_IDLE_WAIT, [this]() {
+            return !_writer_running || _async_ring->size_approx() > 0;
+        });
+    }
+}
+
+int TorrentLogger::drain_ring() {
+    _writer_busy = true;
+
+    int count = 0;
+    while (count < ASYNC_BATCH_SIZE && _async_ring->try_pop(_writer_batch[count])) {
+        count++;
+    }
+
+    // One file write and one flush per batch instead of per message
+    if (count > 0) {
+        std::lock_guard<std::mutex> lock(_log_mutex);
+        write_records_locked(_writer_batch.data(), count);
+        if (_log_file.is_valid()) {
+            _log_file->flush();
+        }
+    }
+
+    _writer_busy = false;
+    return count;
 }
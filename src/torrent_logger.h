@@ -4,12 +4,29 @@
 #include <godot_cpp/classes/ref_counted.hpp>
 #include <godot_cpp/variant/string.hpp>
 #include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/packed_string_array.hpp>
 #include <godot_cpp/classes/file_access.hpp>
+#include <atomic>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "log_ring_buffer.h"
 
 using namespace godot;
 
+// Highest level compiled in (0 = NONE ... 5 = TRACE); set with
+// `scons log_max_level=<level>`. Levels above it are removed at compile time.
+#ifndef TORRENT_LOG_MAX_LEVEL
+#define TORRENT_LOG_MAX_LEVEL 5
+#endif
+
 /**
  * TorrentLogger - Centralized logging for godot-torrent
  *
@@ -17,7 +34,9 @@ using namespace godot;
  * - Log level filtering (error, warning, info, debug, trace)
  * - Category filtering (session, torrent, peer, tracker, dht, etc.)
  * - Forward logs to Godot console
- * - Optional file output
+ * - Optional file output (text or compact binary, with size-based rotation)
+ * - Optional asynchronous backend (lock-free ring drained by a writer thread)
+ * - Sampling and peer/torrent allowlists for libtorrent's own log alerts
  * - Performance-conscious (minimal overhead when disabled)
  */
 class TorrentLogger : public RefCounted {
@@ -45,7 +64,16 @@ public:
         PORT_MAPPING = 6,
         STORAGE = 7,
         PERFORMANCE = 8,
-        ALERT = 9
+        ALERT = 9,
+        LOGGER = 10
+    };
+
+    static constexpr int CATEGORY_COUNT = 11;
+
+    // Log file encodings
+    enum LogFormat {
+        FORMAT_TEXT = 0,    // Human readable lines
+        FORMAT_BINARY = 1   // Structured records, decode with torrent_log_decoder
     };
 
 protected:
@@ -72,6 +100,20 @@ public:
     void set_log_file(const String& file_path);
     void close_log_file();
     bool is_log_file_enabled() const;
+    void set_log_format(LogFormat format);
+    LogFormat get_log_format() const;
+    void set_log_rotation(int64_t max_bytes, int max_files = 5);
+
+    // Console output
+    void set_console_output_enabled(bool enabled);
+    bool is_console_output_enabled() const;
+
+    // Asynchronous backend
+    void set_async_enabled(bool enabled);
+    bool is_async_enabled() const;
+    void set_async_capacity(int records);
+    int get_async_capacity() const;
+    void flush();
 
     // Logging methods
     void log_error(const String& message, const String& category = "");
@@ -83,48 +125,183 @@ public:
     // Log a message with explicit level
     void log(LogLevel level, const String& message, const String& category = "");
 
+    // Structured logging: "{}" placeholders are filled from args when the
+    // record is rendered, so the format string is interned and sent once
+    void log_fmt(LogLevel level, const String& format, const Array& args, const String& category = "");
+
+    // Enum-typed variants for C++ callers: no category string lookup
+    void log(LogLevel level, const String& message, LogCategory category);
+    void log_fmt(LogLevel level, const String& format, const Array& args, LogCategory category);
+
+    // One load, one compare and one mask test; used by the TORRENT_LOG macros
+    // so a disabled statement never builds its message
+    bool is_enabled_for(LogLevel level, LogCategory category) const {
+        return level <= _active_level.load(std::memory_order_relaxed) && level != NONE &&
+               (_category_mask.load(std::memory_order_relaxed) & (1u << category)) != 0;
+    }
+
     // Internal: Process libtorrent alert for logging
     void process_libtorrent_alert(int alert_type, const String& alert_message);
 
+    // libtorrent log alert sampling: keep 1 in `one_in_n` records of a
+    // category (1 = keep everything). Traced peers/torrents are never sampled.
+    void set_sample_rate(LogCategory category, int one_in_n);
+    int get_sample_rate(LogCategory category) const;
+
+    // Allowlists for peer/torrent log alerts. While a list is non-empty only
+    // matching peers (by IP address) or torrents (by info hash) are logged.
+    void add_traced_peer(const String& address);
+    void remove_traced_peer(const String& address);
+    void clear_traced_peers();
+    PackedStringArray get_traced_peers() const;
+    void add_traced_torrent(const String& info_hash);
+    void remove_traced_torrent(const String& info_hash);
+    void clear_traced_torrents();
+    PackedStringArray get_traced_torrents() const;
+
+    // Internal: native sink for libtorrent log alerts (no Variant conversion)
+    bool has_peer_trace_filter() const { return _peer_trace_active.load(std::memory_order_relaxed); }
+    bool has_torrent_trace_filter() const { return _torrent_trace_active.load(std::memory_order_relaxed); }
+    bool is_peer_traced(const std::string& address) const;
+    bool is_torrent_traced(const std::string& info_hash) const;
+    bool sample(LogCategory category);
+    void log_native(LogLevel level, LogCategory category, const char* message, size_t length);
+
     // Statistics
     Dictionary get_log_stats() const;
     void reset_log_stats();
 
 private:
-    bool _enabled;
-    LogLevel _log_level;
-    bool _category_filters[10]; // One for each LogCategory
+    std::atomic<bool> _enabled;
+    std::atomic<LogLevel> _log_level;
+    std::atomic<int> _active_level;        // _log_level, or NONE while disabled
+    std::atomic<uint32_t> _category_mask;  // Bit per LogCategory; ALL is always set
 
     // File logging
     Ref<FileAccess> _log_file;
     String _log_file_path;
-    bool _file_logging_enabled;
+    std::atomic<bool> _file_logging_enabled;
+    LogFormat _log_format;       // Format used when the next file is opened
+    LogFormat _file_format;      // Format of the currently open file
+    int64_t _rotation_max_bytes;
+    int _rotation_max_files;
+    int64_t _log_file_bytes;
+    int64_t _log_file_header_bytes;
+    uint64_t _file_last_timestamp;
+    std::vector<bool> _file_emitted_ids;
+    std::atomic<bool> _console_enabled;
 
-    // Statistics
-    int _log_count_error;
-    int _log_count_warning;
-    int _log_count_info;
-    int _log_count_debug;
-    int _log_count_trace;
+    // Statistics (updated from any logging thread)
+    std::atomic<int> _log_count_error;
+    std::atomic<int> _log_count_warning;
+    std::atomic<int> _log_count_info;
+    std::atomic<int> _log_count_debug;
+    std::atomic<int> _log_count_trace;
+    std::atomic<int> _log_count_truncated;
+    std::atomic<int> _log_count_sampled_out;
 
-    // Thread safety for file writes
+    // Thread safety for file writes (also guards the writer-side state above)
     mutable std::mutex _log_mutex;
 
+    // Interned strings (formats and category names)
+    std::mutex _intern_mutex;
+    std::unordered_map<std::string, uint32_t> _intern_ids;
+    std::vector<std::string> _intern_strings;
+    std::vector<int8_t> _intern_categories;  // LogCategory of each interned name
+    uint64_t _intern_owner;                  // Tags this logger's entries in the per-thread cache
+    std::vector<std::string> _string_cache; // Writer-side copy, guarded by _log_mutex
+
+    // libtorrent log alert sampling and tracing
+    std::atomic<uint32_t> _sample_rates[CATEGORY_COUNT];
+    std::atomic<uint32_t> _sample_counters[CATEGORY_COUNT];
+    mutable std::mutex _trace_mutex;
+    std::unordered_set<std::string> _traced_peers;
+    std::unordered_set<std::string> _traced_torrents;
+    std::atomic<bool> _peer_trace_active;
+    std::atomic<bool> _torrent_trace_active;
+
+    // Asynchronous backend
+    std::unique_ptr<LogRingBuffer> _async_ring;
+    size_t _async_capacity;
+    std::atomic<bool> _async_enabled;
+    std::atomic<int> _async_producers;  // submit_record calls that may be using the ring
+    std::atomic<bool> _writer_running;
+    std::atomic<bool> _writer_busy;
+    std::thread _writer_thread;
+    std::mutex _writer_mutex;
+    std::condition_variable _writer_cv;
+    std::vector<LogRecord> _writer_batch;
+
     // Helper methods
-    bool should_log(LogLevel level, const String& category) const;
-    String format_log_message(LogLevel level, const String& message, const String& category) const;
+    bool is_level_enabled(LogLevel level) const;
+    void update_active_level();
     String get_level_name(LogLevel level) const;
     String get_timestamp() const;
     void write_to_console(LogLevel level, const String& formatted_message);
-    void write_to_file(const String& formatted_message);
+    void count_message(LogLevel level);
+
+    // Record pipeline
+    // Returns INTERN_FULL once the table is at its cap; the string is then logged inline
+    uint32_t intern_string(const String& value, LogCategory* category = nullptr);
+    uint32_t intern_category(const String& name, LogCategory& category);
+    const std::string& lookup_string_locked(uint32_t id);
+    void write_message(LogLevel level, const String& message, uint32_t category_id);
+    void write_fmt(LogLevel level, const String& format, const Array& args, uint32_t category_id);
+    void init_record(LogRecord& record, LogLevel level, uint32_t format_id, uint32_t category_id);
+    void submit_record(const LogRecord& record);
+    // Sync mode only: writes a message too long for a record with a heap payload
+    void write_oversized(const LogRecord& record, const char* message, size_t length);
+    void write_records_locked(const LogRecord* records, int count);
+    // Returns false when rotation left no file open
+    bool append_record_locked(const LogRecord& record, const uint8_t* payload, size_t length, std::string& batch);
+    std::string format_record_text(const LogRecord& record, const uint8_t* payload, size_t length);
+    void encode_binary_entry(const LogRecord& record, const uint8_t* payload, size_t length, std::string& out);
+
+    // File helpers (caller must hold _log_mutex)
+    bool open_log_file_locked(const String& file_path);
+    void close_log_file_locked();
+    void rotate_log_file_locked();
+    void write_bytes_locked(const std::string& bytes);
+
+    // Asynchronous backend helpers
+    void start_writer();
+    void stop_writer();
+    void writer_loop();
+    int drain_ring();
+    // Turn the async backend off and wait until no producer can touch the ring
+    void disable_async();
 
     // Map libtorrent alert types to log levels and categories
     LogLevel get_alert_log_level(int alert_type) const;
-    String get_alert_category(int alert_type) const;
+    LogCategory get_alert_category(int alert_type) const;
 };
 
 // Enum registration for GDScript
 VARIANT_ENUM_CAST(TorrentLogger::LogLevel);
 VARIANT_ENUM_CAST(TorrentLogger::LogCategory);
+VARIANT_ENUM_CAST(TorrentLogger::LogFormat);
+
+/**
+ * Logging macros for C++ call sites. The level check against
+ * TORRENT_LOG_MAX_LEVEL is resolved at compile time, so statements above it
+ * (including building the message) disappear from the binary. Enabled
+ * statements cost a single is_enabled_for() test before the message is built.
+ *
+ *   TORRENT_LOG_DEBUG(_logger, TorrentLogger::PEER, "Connected: " + address);
+ */
+#define TORRENT_LOG(logger, level, category, message) \
+    do { \
+        if constexpr ((level) <= TORRENT_LOG_MAX_LEVEL) { \
+            if ((logger).is_valid() && (logger)->is_enabled_for((level), (category))) { \
+                (logger)->log((level), (message), (category)); \
+            } \
+        } \
+    } while (0)
+
+#define TORRENT_LOG_ERROR(logger, category, message) TORRENT_LOG(logger, TorrentLogger::ERROR, category, message)
+#define TORRENT_LOG_WARNING(logger, category, message) TORRENT_LOG(logger, TorrentLogger::WARNING, category, message)
+#define TORRENT_LOG_INFO(logger, category, message) TORRENT_LOG(logger, TorrentLogger::INFO, category, message)
+#define TORRENT_LOG_DEBUG(logger, category, message) TORRENT_LOG(logger, TorrentLogger::DEBUG, category, message)
+#define TORRENT_LOG_TRACE(logger, category, message) TORRENT_LOG(logger, TorrentLogger::TRACE, category, message)
 
 #endif // TORRENT_LOGGER_H
@@ -5,7 +5,9 @@
 #include <godot_cpp/variant/packed_byte_array.hpp>
 #include <godot_cpp/variant/string.hpp>
 #include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_string_array.hpp>
 #include <memory>
+#include <vector>
 
 using namespace godot;
 
@@ -14,6 +16,48 @@ class TorrentLogger;
 
 namespace libtorrent {
     class session;
+    struct alert;
+    struct settings_pack;
+    struct torrent_handle;
+    struct add_torrent_params;
+    class torrent_info;
+}
+
+namespace memory_storage {
+    class MemoryStore;
+}
+
+namespace recheck {
+    class RecheckQueue;
+}
+
+namespace dedup {
+    class DedupStore;
+}
+
+namespace metadata_cache {
+    class MetadataCache;
+}
+
+namespace ip_blocklist {
+    class Loader;
+}
+
+namespace bandwidth_governor {
+    class Governor;
+    struct Limits;
+}
+
+namespace scheduler {
+    class DownloadScheduler;
+}
+
+namespace seed_pool {
+    class SeedPool;
+}
+
+namespace file_worker {
+    class FileWorker;
 }
 
 /**
@@ -24,6 +68,14 @@ namespace libtorrent {
 class TorrentSession : public RefCounted {
     GDCLASS(TorrentSession, RefCounted)
 
+public:
+    // Peer classes every session starts with
+    enum PeerClass {
+        PEER_CLASS_GLOBAL = 0,  // every peer; carries the session rate limits
+        PEER_CLASS_TCP = 1,     // TCP peers
+        PEER_CLASS_LOCAL = 2    // peers on local networks; unlimited
+    };
+
 protected:
     static void _bind_methods();
 
@@ -48,6 +100,11 @@ public:
     void set_max_uploads(int limit);
     void set_max_half_open_connections(int limit);
 
+    // Queueing of auto-managed torrents
+    void set_active_limits(int downloads, int seeds, int limit);
+    void set_slow_torrent_exemption(bool enabled, int inactive_down_rate = 2048, int inactive_up_rate = 2048);
+    Dictionary get_queue_settings() const;
+
     // Protocol encryption
     void set_encryption_policy(int policy); // 0=disabled, 1=enabled, 2=forced
     void set_prefer_encrypted(bool prefer);
@@ -83,10 +140,62 @@ public:
     // Torrent operations
     Ref<TorrentHandle> add_torrent_file(PackedByteArray torrent_data, String save_path);
     Ref<TorrentHandle> add_torrent_file_with_resume(PackedByteArray torrent_data, String save_path, PackedByteArray resume_data);
+    Ref<TorrentHandle> add_torrent_file_trusted(PackedByteArray torrent_data, String save_path);
+
+    // Delta patching from a previous build already on disk
+    Dictionary plan_patch(PackedByteArray torrent_data, PackedByteArray previous_torrent_data);
+    Ref<TorrentHandle> add_torrent_file_patch(PackedByteArray torrent_data, String save_path,
+        PackedByteArray previous_torrent_data, String previous_save_path, String link_mode = "auto");
+
+    // Torrents waiting for their files to be placed (driven by get_alerts/clear_alerts or update_file_placements)
+    int get_pending_placements() const;
+    void update_file_placements();
     Ref<TorrentHandle> add_magnet_uri(String magnet_uri, String save_path);
     Ref<TorrentHandle> add_magnet_uri_with_resume(String magnet_uri, String save_path, PackedByteArray resume_data);
     bool remove_torrent(Ref<TorrentHandle> handle, bool delete_files = false);
 
+    // In-memory storage (libtorrent 2.0+)
+    bool is_memory_storage_supported() const;
+    Ref<TorrentHandle> add_torrent_file_in_memory(PackedByteArray torrent_data);
+    Ref<TorrentHandle> add_magnet_uri_in_memory(String magnet_uri);
+    void set_memory_storage_limit_mb(int size_mb);
+    void set_memory_storage_spill_path(String path);
+    PackedByteArray get_memory_file_data(Ref<TorrentHandle> handle, int file_index);
+    Dictionary get_memory_storage_stats() const;
+
+    // Content deduplication across torrents
+    void set_dedup_enabled(bool enabled);
+    bool is_dedup_enabled() const;
+    bool set_dedup_link_mode(String mode);
+    String get_dedup_link_mode() const;
+    int register_dedup_content(PackedByteArray torrent_data, String save_path);
+    Dictionary get_dedup_stats() const;
+    void clear_dedup_store();
+
+    // Metadata cache used to start magnet links with known metadata
+    bool set_metadata_cache_path(String path);
+    String get_metadata_cache_path() const;
+    void set_metadata_cache_memory_entries(int entries);
+    bool add_metadata_to_cache(PackedByteArray torrent_data);
+    bool has_cached_metadata(String info_hash) const;
+    bool remove_cached_metadata(String info_hash);
+    void clear_metadata_cache(bool delete_files = false);
+    Dictionary get_metadata_cache_stats() const;
+
+    // Recheck scheduling (driven by get_alerts or update_recheck_queue)
+    bool queue_recheck(Ref<TorrentHandle> handle, int priority = 0);
+    bool cancel_recheck(Ref<TorrentHandle> handle);
+    void set_recheck_max_active(int max_active);
+    int get_recheck_max_active() const;
+    void set_recheck_rate_limit(int bytes_per_second);
+    int get_recheck_rate_limit() const;
+    void pause_recheck_queue();
+    void resume_recheck_queue();
+    bool is_recheck_queue_paused() const;
+    Dictionary get_recheck_status() const;
+    void clear_finished_rechecks();
+    void update_recheck_queue();
+
     // Statistics and monitoring
     Dictionary get_session_stats();
 
@@ -102,17 +211,66 @@ public:
     // IP filtering
     void set_ip_filter_enabled(bool enabled);
     void add_ip_filter_rule(String ip_range, bool blocked);
+    int add_ip_filter_rules(PackedStringArray ip_ranges, bool blocked);
     void clear_ip_filter();
+    bool is_ip_blocked(String ip) const;
+    bool load_ip_filter_file(String path, bool merge = false);
+    bool is_ip_filter_loading() const;
+    Dictionary get_ip_filter_status() const;
+
+    // Peer classes: rate limits and priorities for groups of peers by IP
+    int create_peer_class(String name);
+    void delete_peer_class(int class_id);
+    bool configure_peer_class(int class_id, Dictionary options);
+    Dictionary get_peer_class(int class_id) const;
+    bool set_peer_class_range(String ip_range, PackedInt32Array class_ids);
 
     // Disk cache configuration
     void set_cache_size(int size_mb);
     void set_cache_expiry(int seconds);
 
+    // Disk I/O engine (selected before start_session, libtorrent 2.0+)
+    bool set_disk_io_backend(String backend);
+    String get_disk_io_backend() const;
+    PackedStringArray get_available_disk_io_backends() const;
+    void set_disk_io_threads(int aio_threads, int hashing_threads);
+
+    // Frame-time governor that throttles transfers during gameplay
+    bool set_bandwidth_governor_enabled(bool enabled);
+    bool is_bandwidth_governor_enabled() const;
+    void set_gameplay_active(bool active);
+    bool is_gameplay_active() const;
+    void set_bandwidth_governor_config(Dictionary config);
+    Dictionary get_bandwidth_governor_config() const;
+    int update_bandwidth_governor(double frame_time_ms = -1.0);
+    Dictionary get_bandwidth_governor_status() const;
+
+    // Download order across torrents (driven by get_alerts or update_download_wishlist)
+    bool set_download_wishlist(Array wishes);
+    void clear_download_wishlist();
+    void set_wishlist_max_active(int max_active);
+    int get_wishlist_max_active() const;
+    void set_wishlist_deadline_pieces(int pieces);
+    int get_wishlist_deadline_pieces() const;
+    Dictionary get_wishlist_status() const;
+    void update_download_wishlist();
+
+    // Seed-only torrents loaded on demand (driven by get_alerts or update_seed_pool)
+    String add_seed(String torrent_path, String save_path);
+    bool remove_seed(String info_hash);
+    bool has_seed(String info_hash) const;
+    bool request_seed(String info_hash);
+    void set_seed_pool_config(Dictionary config);
+    Dictionary get_seed_pool_config() const;
+    Dictionary get_seed_pool_stats() const;
+    void update_seed_pool();
+
     // Logging
     void set_logger(Ref<TorrentLogger> logger);
     Ref<TorrentLogger> get_logger() const;
     void enable_logging(bool enabled);
     void set_log_level(int level);
+    void set_libtorrent_log_alerts(bool session_log, bool torrent_log, bool peer_log);
 
 private:
     // The actual libtorrent session
@@ -121,12 +279,86 @@ private:
     // Logger
     Ref<TorrentLogger> _logger;
 
+    // Backing store for torrents kept in memory; shared with the disk I/O
+    std::shared_ptr<memory_storage::MemoryStore> _memory_store;
+
+    // libtorrent disk I/O used for torrents that are not kept in memory
+    String _disk_io_backend;
+
+    // Rate-limited rechecks across all torrents
+    std::unique_ptr<recheck::RecheckQueue> _recheck_queue;
+
+    // Index of complete files shared between torrents
+    std::unique_ptr<dedup::DedupStore> _dedup_store;
+    bool _dedup_enabled;
+    String _dedup_link_mode;
+
+    // Torrent metadata by info hash, filled from metadata_received_alert
+    std::unique_ptr<metadata_cache::MetadataCache> _metadata_cache;
+
+    // Background blocklist parsing and the outcome of the last load
+    std::unique_ptr<ip_blocklist::Loader> _ip_filter_loader;
+    bool _ip_filter_merge;
+    Dictionary _ip_filter_last_load;
+
+    // Frame-time throttle; owns the rate, connection and thread settings while enabled
+    std::unique_ptr<bandwidth_governor::Governor> _governor;
+    bool _governor_enabled;
+
+    // Wish list planner for file priorities, queue order and piece deadlines
+    std::unique_ptr<scheduler::DownloadScheduler> _download_scheduler;
+
+    // Registry of seed-only torrents kept out of scripts
+    std::unique_ptr<seed_pool::SeedPool> _seed_pool;
+
+    // Copies and links files for torrents before they are added
+    std::unique_ptr<file_worker::FileWorker> _file_worker;
+
+    // Create the libtorrent session with our disk I/O installed
+    libtorrent::session* create_session(const libtorrent::settings_pack& settings);
+
+    // Link known content into a torrent about to be added, in the background;
+    // returns the pending handle, or null if deduplication does not apply
+    Ref<TorrentHandle> queue_dedup_add(const libtorrent::add_torrent_params& params, const String& operation);
+
+    // Add a torrent whose files were placed in the background and hand its
+    // handle to the TorrentHandle returned earlier
+    void finish_placement(Ref<TorrentHandle> handle, libtorrent::add_torrent_params& params,
+        int reused_files, const String& operation);
+
+    // Store metadata under every info hash of the torrent
+    void cache_metadata(const libtorrent::torrent_info& info, const std::vector<char>& torrent);
+
+    // Give a parsed magnet link its cached metadata, if any
+    void apply_cached_metadata(libtorrent::add_torrent_params& params);
+
+    // Push governor limits to libtorrent
+    void apply_governor_limits(const bandwidth_governor::Limits& limits);
+    // Replaces the governor's level 0 limits and applies the current level
+    void rebase_governor(const bandwidth_governor::Limits& baseline);
+
+    // Install a blocklist once the loader has finished parsing it
+    void install_loaded_ip_filter();
+
+    // Underlying libtorrent handle of a TorrentHandle, or nullptr
+    libtorrent::torrent_handle* get_lt_handle(const Ref<TorrentHandle>& handle) const;
+
+    // Forward libtorrent log alerts straight to the logger; returns true if consumed
+    bool route_log_alert(libtorrent::alert* alert);
+    // Session bookkeeping for an alert (rechecks, seed pool, metadata, dedup);
+    // runs whether alerts are returned by get_alerts() or dropped by clear_alerts()
+    void handle_internal_alert(libtorrent::alert* alert);
+    // Advances the queues and background jobs driven by alert polling
+    void update_background_work();
+
     // Helper to convert Dictionary to libtorrent settings_pack
-    void apply_dictionary_settings(Dictionary settings);
+    void apply_dictionary_settings(Dictionary settings, libtorrent::settings_pack& lt_settings);
 
     // Error handling helpers
     void report_error(const String& operation, const String& message);
     void report_libtorrent_error(const String& operation, int error_code, const String& error_message);
 };
 
+VARIANT_ENUM_CAST(TorrentSession::PeerClass);
+
 #endif // TORRENT_SESSION_H
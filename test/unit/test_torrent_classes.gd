@@ -1,5 +1,7 @@
 extends GutTest
 
+const FIXTURE_DIR = "user://test_torrent_classes"
+
 var session: TorrentSession
 
 func before_each():
@@ -10,6 +12,7 @@ func after_each():
     if session:
         session.stop_session()
     session = null
+    _remove_dir(ProjectSettings.globalize_path(FIXTURE_DIR))
 
 func test_invalid_torrent_handle():
     var handle = TorrentHandle.new()
@@ -38,6 +41,81 @@ func test_torrent_info_methods():
     assert_eq(info.get_name(), "", "Name should be empty for invalid info")
     assert_eq(info.get_total_size(), 0, "Size should be 0 for invalid info")
 
+func test_torrent_info_file_table():
+    var handle = _add_fixture([20000, 20000, 20000])
+    assert_not_null(handle, "Fixture torrent should be added")
+    if not handle:
+        return
+
+    var info = handle.get_torrent_info()
+    assert_same(handle.get_torrent_info(), info, "Info should be reused while metadata is unchanged")
+
+    var table = info.get_file_table()
+    assert_eq(table["paths"].size(), info.get_file_count(), "Every file should have a row")
+
+    var index = info.find_file("payload/file_1.bin")
+    assert_ne(index, -1, "Path should map to its index")
+    assert_eq(table["paths"][index].get_file(), "file_1.bin")
+    assert_eq(table["sizes"][index], 20000)
+    assert_eq(table["flags"][index] & TorrentInfo.FILE_PAD, 0, "Payload files are not padding")
+    assert_eq(info.find_file("payload/missing.bin"), -1, "Unknown path should not be found")
+
+    assert_eq(info.find_files_with_prefix("payload/file_").size(), 3)
+    assert_eq(Array(info.find_files_matching("*_1.bin")), [index], "Glob should match a single file")
+
+func test_torrent_info_piece_mapping():
+    var handle = _add_fixture([20000, 0, 30000])
+    assert_not_null(handle, "Fixture torrent should be added")
+    if not handle:
+        return
+
+    var info = handle.get_torrent_info()
+    var table = info.get_file_table()
+    var piece_size = info.get_piece_size()
+    var first = info.find_file("payload/file_0.bin")
+    var empty = info.find_file("payload/file_1.bin")
+    var last = info.find_file("payload/file_2.bin")
+
+    # Byte range inside a file
+    var piece_range = info.map_file(first, 100, 5000)
+    var start = table["offsets"][first] + 100
+    assert_eq(piece_range["first_piece"], start / piece_size)
+    assert_eq(piece_range["first_piece_offset"], start % piece_size)
+    assert_eq(piece_range["last_piece"], (start + 4999) / piece_size)
+    assert_eq(info.map_file(first)["size"], 20000, "Default range should cover the whole file")
+    assert_eq(info.map_file(first, 15000, 100000)["size"], 5000, "Size should be clipped to the file")
+    assert_eq(info.map_file(first, 20000)["size"], 0, "Offset at the end should give an empty range")
+
+    # A piece spanning files: neither payload size is a piece multiple, so
+    # the tail of whichever comes first shares its piece with what follows
+    var leading = first if table["offsets"][first] < table["offsets"][last] else last
+    var tail_piece = info.map_file(leading)["last_piece"]
+    var slices = info.map_piece_to_files(tail_piece)
+    assert_gt(slices.size(), 1, "Piece should span more than one file")
+    assert_eq(slices[0]["file_index"], leading)
+    assert_eq(slices[0]["offset"], tail_piece * piece_size - table["offsets"][leading])
+    var covered = 0
+    for slice in slices:
+        covered += slice["size"]
+        assert_ne(slice["file_index"], empty, "Empty files hold no piece data")
+    assert_eq(covered, info.get_piece_size_at(tail_piece), "Slices should cover the whole piece")
+
+    # Zero-length file
+    assert_ne(empty, -1, "Empty file should be listed")
+    var empty_range = info.map_file(empty)
+    assert_eq(empty_range["size"], 0)
+    assert_eq(empty_range["first_piece"], empty_range["last_piece"])
+    assert_lt(empty_range["first_piece"], info.get_piece_count(), "Piece index should stay valid")
+
+    # Out of range
+    assert_true(info.map_file(-1).is_empty(), "Negative file index should be rejected")
+    assert_true(info.map_file(info.get_file_count()).is_empty(), "File index past the end should be rejected")
+    assert_true(info.map_file(first, -1).is_empty(), "Negative offset should be rejected")
+    assert_true(info.map_file(first, 30000).is_empty(), "Offset past the end should be rejected")
+    assert_true(info.map_piece_to_files(-1).is_empty(), "Negative piece should be rejected")
+    assert_true(info.map_piece_to_files(info.get_piece_count()).is_empty(), "Piece past the end should be rejected")
+    assert_true(TorrentInfo.new().map_file(0).is_empty(), "Invalid info should map nothing")
+
 func test_torrent_status_methods():
     var status = TorrentStatus.new()
     
@@ -51,6 +129,26 @@ func test_peer_info_methods():
     assert_not_null(peer, "PeerInfo should be created")
     assert_eq(peer.get_ip(), "", "IP should be empty for invalid peer")
     assert_eq(peer.get_port(), 0, "Port should be 0 for invalid peer")
+    assert_eq(peer.get_client(), "", "Client should be empty for invalid peer")
+
+    var dict = peer.get_peer_dictionary()
+    assert_eq(dict["client"], "", "Dictionary should match the getters")
+    assert_eq(dict["port"], 0)
+    assert_same(peer.get_peer_dictionary(), dict, "Dictionary should be built once")
+
+func test_peer_client_decoding():
+    var known = "-qB4520-".to_ascii_buffer()
+    known.append_array("abcdefghijkl".to_ascii_buffer())
+    assert_eq(PeerInfo.identify_client(known), "qBittorrent 4.5.2", "Azureus-style id should decode")
+
+    var shadow = "S58B--".to_ascii_buffer()
+    shadow.append_array("abcdefghijklmn".to_ascii_buffer())
+    assert_eq(PeerInfo.identify_client(shadow), "Shadow 5.8.11", "Shadow-style id should decode")
+
+    var unknown = "-ZZ1234-".to_ascii_buffer()
+    unknown.append_array("abcdefghijkl".to_ascii_buffer())
+    assert_eq(PeerInfo.identify_client(unknown), "", "Unknown client code should not decode")
+    assert_eq(PeerInfo.identify_client("-qB45".to_ascii_buffer()), "", "Short id should not decode")
 
 func test_alert_manager():
     var alert_manager = AlertManager.new()
@@ -66,4 +164,35 @@ func test_alert_manager():
     alert_manager.enable_status_alerts(false)
     
     var mask = alert_manager.get_alert_mask()
-    assert_ne(mask, 0, "Alert mask should not be zero")
\ No newline at end of file
+    assert_ne(mask, 0, "Alert mask should not be zero")
+
+# Adds a torrent of payload/file_<i>.bin files with the given sizes, 16 KiB
+# pieces, and returns its handle (null on failure)
+func _add_fixture(sizes: Array) -> TorrentHandle:
+    var payload = FIXTURE_DIR.path_join("payload")
+    DirAccess.make_dir_recursive_absolute(ProjectSettings.globalize_path(payload))
+    for i in range(sizes.size()):
+        var bytes = PackedByteArray()
+        bytes.resize(sizes[i])
+        bytes.fill(i + 1)
+        var file = FileAccess.open(payload.path_join("file_%d.bin" % i), FileAccess.WRITE)
+        file.store_buffer(bytes)
+        file.close()
+
+    var creator = TorrentCreator.new()
+    creator.set_path(payload)
+    creator.set_piece_size(16384)
+    var handle = session.add_torrent_file(creator.generate(), ProjectSettings.globalize_path(FIXTURE_DIR))
+    if not handle or not handle.is_valid():
+        return null
+    return handle
+
+func _remove_dir(path: String):
+    var dir = DirAccess.open(path)
+    if not dir:
+        return
+    for sub in dir.get_directories():
+        _remove_dir(path.path_join(sub))
+    for file_name in dir.get_files():
+        dir.remove(file_name)
+    DirAccess.remove_absolute(path)
@@ -0,0 +1,208 @@
+extends GutTest
+
+# Tests for TorrentCreator
+
+const SOURCE_DIR = "user://test_torrent_creator/payload"
+
+var creator: TorrentCreator
+
+func before_each():
+	creator = TorrentCreator.new()
+
+func after_each():
+	creator = null
+	_remove_dir(ProjectSettings.globalize_path("user://test_torrent_creator"))
+
+func test_creator_defaults():
+	assert_eq(creator.get_format(), TorrentCreator.FORMAT_V1, "Default format should be v1")
+	assert_eq(creator.get_piece_size(), 0, "Piece size should default to auto")
+	assert_eq(creator.get_thread_count(), 0, "Thread count should default to one per core")
+	assert_false(creator.is_private(), "Torrents should not be private by default")
+	assert_true(creator.is_format_supported(TorrentCreator.FORMAT_V1), "v1 should always be supported")
+
+func test_invalid_piece_size_rejected():
+	creator.set_piece_size(65536)
+	creator.set_piece_size(100000)
+	assert_eq(creator.get_piece_size(), 65536, "Non power of two piece size should be ignored")
+	creator.set_piece_size(8192)
+	assert_eq(creator.get_piece_size(), 65536, "Piece size below 16 KiB should be ignored")
+
+func test_generate_without_path_fails():
+	var data = creator.generate()
+	assert_true(data.is_empty(), "generate() without a path should fail")
+	assert_ne(creator.get_last_error(), "", "Failure should be reported")
+
+func test_generate_directory():
+	_write_payload(3, 100000)
+	creator.set_path(SOURCE_DIR)
+	creator.set_piece_size(32768)
+	creator.set_thread_count(2)
+	creator.add_tracker("udp://tracker.example.com:6969/announce")
+	creator.set_private(true)
+	watch_signals(creator)
+
+	var data = creator.generate()
+	assert_false(data.is_empty(), "generate() should return torrent bytes")
+	assert_eq(data[0], "d".unicode_at(0), "Output should be a bencoded dictionary")
+	assert_signal_emitted(creator, "progress", "Progress should be reported")
+
+	var result = creator.get_last_result()
+	assert_eq(result["files"], 3, "All files should be packaged")
+	assert_eq(result["total_size"], 300000, "Total size should match the payload")
+	assert_eq(result["pieces"], 10, "Pieces should cover the payload")
+	assert_eq(result["info_hash"].length(), 40, "v1 info hash should be reported")
+
+	var session = TorrentSession.new()
+	session.start_session()
+	var handle = session.add_torrent_file(data, ProjectSettings.globalize_path("user://test_torrent_creator"))
+	assert_not_null(handle, "Generated torrent should be accepted by the session")
+	if handle:
+		assert_true(handle.get_torrent_info().is_private(), "Private flag should be kept")
+		session.remove_torrent(handle)
+	session.stop_session()
+
+func test_resume_data_requires_generate():
+	var resume = creator.generate_resume_data("user://test_torrent_creator")
+	assert_true(resume.is_empty(), "Resume data needs a generated torrent")
+	assert_ne(creator.get_last_error(), "", "Failure should be reported")
+
+func test_trusted_add_seeds_without_check():
+	_write_payload(2, 65536)
+	creator.set_path(SOURCE_DIR)
+	var data = creator.generate()
+	assert_false(data.is_empty(), "generate() should return torrent bytes")
+
+	var save_path = ProjectSettings.globalize_path("user://test_torrent_creator")
+	var resume = creator.generate_resume_data(save_path)
+	assert_false(resume.is_empty(), "Resume data should be produced")
+
+	var session = TorrentSession.new()
+	session.start_session()
+	var handle = session.add_torrent_file_trusted(data, save_path)
+	assert_not_null(handle, "Trusted add should succeed")
+	if handle:
+		assert_true(handle.is_seed_mode(), "Trusted torrent should start in seed mode")
+		session.remove_torrent(handle)
+
+	handle = session.add_torrent_file_with_resume(data, save_path, resume)
+	assert_not_null(handle, "Add with creator resume data should succeed")
+	if handle:
+		assert_true(handle.is_seed_mode(), "Creator resume data should carry seed mode")
+		session.remove_torrent(handle)
+	session.stop_session()
+
+func test_patch_reuses_unchanged_files():
+	var base = ProjectSettings.globalize_path("user://test_torrent_creator")
+	_write_payload(2, 65536)
+	creator.set_path(SOURCE_DIR)
+	creator.set_piece_size(16384)
+	var previous = creator.generate()
+	assert_false(previous.is_empty(), "Previous build should be created")
+
+	# Build N+1: same layout, second file changed
+	var changed = PackedByteArray()
+	changed.resize(65536)
+	changed.fill(42)
+	var file = FileAccess.open(SOURCE_DIR.path_join("file_1.bin"), FileAccess.WRITE)
+	file.store_buffer(changed)
+	file.close()
+	var next = creator.generate()
+
+	var session = TorrentSession.new()
+	var plan = session.plan_patch(next, previous)
+	assert_eq(plan["matched_files"], 1, "Unchanged file should be matched")
+	assert_eq(plan["reused_bytes"], 65536, "Unchanged file should be reused")
+	assert_eq(plan["download_bytes"], 65536, "Only the changed file should be downloaded")
+
+	session.start_session()
+	DirAccess.make_dir_recursive_absolute(base.path_join("next"))
+	var handle = session.add_torrent_file_patch(next, base.path_join("next"), previous, base, "copy")
+	assert_not_null(handle, "Patch torrent should be queued")
+	_wait_for_placements(session, true)
+	assert_true(handle.is_valid(), "Patch torrent should be added when alerts are only drained")
+	assert_true(FileAccess.file_exists(base.path_join("next/payload/file_0.bin")), "Unchanged file should be placed")
+	if handle:
+		session.remove_torrent(handle)
+	session.stop_session()
+
+func test_dedup_links_known_files():
+	var base = ProjectSettings.globalize_path("user://test_torrent_creator")
+	_write_payload(2, 65536)
+	creator.set_path(SOURCE_DIR)
+	creator.set_piece_size(16384)
+	var pack = creator.generate()
+
+	# A second torrent holding only a copy of the first file
+	DirAccess.make_dir_recursive_absolute(base.path_join("single"))
+	DirAccess.copy_absolute(base.path_join("payload/file_0.bin"), base.path_join("single/file_0.bin"))
+	creator.set_path(base.path_join("single/file_0.bin"))
+	var single = creator.generate()
+	DirAccess.remove_absolute(base.path_join("single/file_0.bin"))
+
+	var session = TorrentSession.new()
+	session.set_dedup_enabled(true)
+	assert_eq(session.register_dedup_content(pack, base), 2, "Both files should be indexed")
+
+	session.start_session()
+	DirAccess.make_dir_recursive_absolute(base.path_join("dest"))
+	var handle = session.add_torrent_file(single, base.path_join("dest"))
+	assert_not_null(handle, "Torrent should be queued")
+	_wait_for_placements(session, true)
+	assert_true(handle.is_valid(), "Torrent should be added once linking is done, with alerts only drained")
+	assert_true(FileAccess.file_exists(base.path_join("dest/file_0.bin")), "Known file should be linked in")
+	assert_eq(session.get_dedup_stats()["linked_files"], 1, "One file should have been linked")
+	if handle:
+		session.remove_torrent(handle)
+	session.stop_session()
+
+func test_metadata_cache_persists():
+	_write_payload(1, 40000)
+	creator.set_path(SOURCE_DIR)
+	var data = creator.generate()
+	var info_hash = creator.get_last_result()["info_hash"]
+
+	var session = TorrentSession.new()
+	assert_true(session.set_metadata_cache_path("user://test_torrent_creator/metadata"), "Cache directory should be created")
+	assert_false(session.has_cached_metadata(info_hash), "Cache should start empty")
+	assert_true(session.add_metadata_to_cache(data), "Torrent should be cached")
+	assert_true(session.has_cached_metadata(info_hash.to_upper()), "Lookup should ignore case")
+
+	# A new session finds the entry on disk
+	var reopened = TorrentSession.new()
+	reopened.set_metadata_cache_path("user://test_torrent_creator/metadata")
+	assert_true(reopened.has_cached_metadata(info_hash), "Entry should survive a restart")
+
+	reopened.clear_metadata_cache(true)
+	assert_false(reopened.has_cached_metadata(info_hash), "Cleared entry should be gone from disk")
+	assert_false(session.add_metadata_to_cache(PackedByteArray([1, 2, 3])), "Invalid torrent should be rejected")
+
+func _write_payload(count: int, size: int):
+	DirAccess.make_dir_recursive_absolute(ProjectSettings.globalize_path(SOURCE_DIR))
+	var bytes = PackedByteArray()
+	bytes.resize(size)
+	for i in range(count):
+		bytes.fill(i + 1)
+		var file = FileAccess.open(SOURCE_DIR.path_join("file_%d.bin" % i), FileAccess.WRITE)
+		file.store_buffer(bytes)
+		file.close()
+
+func _remove_dir(path: String):
+	var dir = DirAccess.open(path)
+	if not dir:
+		return
+	for sub in dir.get_directories():
+		_remove_dir(path.path_join(sub))
+	for file_name in dir.get_files():
+		dir.remove(file_name)
+	DirAccess.remove_absolute(path)
+
+# `drain_only` polls with clear_alerts(), which must place files too
+func _wait_for_placements(session: TorrentSession, drain_only: bool = false):
+	for i in range(200):
+		if drain_only:
+			session.clear_alerts()
+		else:
+			session.get_alerts()
+		if session.get_pending_placements() == 0:
+			return
+		OS.delay_msec(10)
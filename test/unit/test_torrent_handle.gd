@@ -189,6 +189,49 @@ func test_peer_information():
 	assert_not_null(peers, "Should return peers array")
 	assert_true(peers is Array, "Peers should be an Array")
 
+func test_connect_peer_invalid_handle():
+	# Validates: connect_peer is safe on a handle without a torrent
+	handle._set_internal_handle({})
+
+	handle.connect_peer("127.0.0.1", 6881)
+	handle.connect_peer("not an ip", 6881)
+	assert_true(true, "connect_peer should not crash on an invalid handle")
+
+func test_limits_invalid_handle():
+	# Validates: per-torrent limits are safe without a torrent
+	handle.set_upload_limit(1024)
+	handle.set_max_connections(10)
+	assert_eq(handle.get_upload_limit(), 0, "Invalid handle should report no limit")
+	assert_eq(handle.get_max_connections(), 0, "Invalid handle should report no limit")
+
+func test_top_peers_invalid_handle():
+	# Validates: top-N peer query is safe without a torrent
+	var top = handle.get_top_peers(5)
+	assert_eq(top["total"], 0, "Invalid handle should have no peers")
+	assert_eq(top["matched"], 0)
+	assert_false(top.has("ip"), "No columns without a torrent")
+
+	handle._set_internal_handle({})
+	top = handle.get_top_peers(5, TorrentHandle.PEER_SORT_UPLOAD_RATE, TorrentHandle.PEER_FIELD_IP, TorrentHandle.PEER_FLAG_SEED)
+	assert_eq(top["matched"], 0)
+
+func test_async_peer_info_invalid_handle():
+	# Validates: asynchronous peer requests are refused without a torrent
+	assert_false(handle.request_peer_info_async(10), "Invalid handle should refuse a request")
+	assert_false(handle.subscribe_peer_info(500), "Invalid handle should refuse a subscription")
+	assert_false(handle.is_peer_info_subscribed())
+	handle.unsubscribe_peer_info()
+	assert_false(handle.is_peer_info_subscribed(), "Unsubscribing without a subscription should be safe")
+
+func test_queueing_invalid_handle():
+	# Validates: queue operations are safe without a torrent
+	handle.set_auto_managed(true)
+	handle.queue_position_top()
+	handle.queue_position_down()
+	handle.set_queue_position(3)
+	assert_false(handle.is_auto_managed(), "Invalid handle should not be auto-managed")
+	assert_eq(handle.get_queue_position(), -1, "Invalid handle should not be queued")
+
 func test_memory_management():
 	# Validates: Memory is managed correctly
 	
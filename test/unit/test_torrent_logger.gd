@@ -0,0 +1,215 @@
+extends GutTest
+
+# Tests for TorrentLogger
+
+var logger: TorrentLogger
+
+func before_each():
+	logger = TorrentLogger.new()
+
+func after_each():
+	if logger:
+		logger.set_async_enabled(false)
+		logger.close_log_file()
+	logger = null
+
+func test_logger_defaults():
+	assert_false(logger.is_logging_enabled(), "Logging should be disabled by default")
+	assert_eq(logger.get_log_level(), TorrentLogger.WARNING, "Default level should be WARNING")
+	assert_false(logger.is_async_enabled(), "Async backend should be disabled by default")
+
+func test_level_filtering_counts():
+	logger.enable_logging(true)
+	logger.set_log_level(TorrentLogger.WARNING)
+	logger.reset_log_stats()
+
+	logger.log_error("error", "TEST")
+	logger.log_warning("warning", "TEST")
+	logger.log_info("info", "TEST")
+	logger.log_debug("debug", "TEST")
+
+	var stats = logger.get_log_stats()
+	assert_eq(stats["error_count"], 1, "Error should be counted")
+	assert_eq(stats["warning_count"], 1, "Warning should be counted")
+	assert_eq(stats["info_count"], 0, "Info should be filtered out")
+	assert_eq(stats["debug_count"], 0, "Debug should be filtered out")
+
+func test_async_writes_to_file():
+	var path = "user://test_async_logger.log"
+	logger.enable_logging(true)
+	logger.set_log_level(TorrentLogger.TRACE)
+	logger.set_log_file(path)
+	logger.set_async_enabled(true)
+	assert_true(logger.is_async_enabled(), "Async backend should be enabled")
+
+	for i in range(100):
+		logger.log_trace("async message %d" % i, "TEST")
+
+	logger.flush()
+	logger.close_log_file()
+
+	var file = FileAccess.open(path, FileAccess.READ)
+	assert_not_null(file, "Log file should exist")
+	var text = file.get_as_text()
+	file.close()
+
+	assert_true(text.contains("async message 0"), "First async record should be written")
+	assert_true(text.contains("async message 99"), "Last async record should be written")
+	assert_true(text.contains("[TRACE] [TEST]"), "Records should be decorated by the writer")
+
+func test_async_overflow_drops_instead_of_blocking():
+	logger.enable_logging(true)
+	logger.set_log_level(TorrentLogger.TRACE)
+	logger.set_async_capacity(16)
+	logger.set_async_enabled(true)
+	logger.reset_log_stats()
+
+	for i in range(5000):
+		logger.log_trace("flood %d" % i, "TEST")
+
+	logger.flush()
+	var stats = logger.get_log_stats()
+	assert_eq(stats["trace_count"], 5000, "All calls should be counted")
+	assert_true(stats["dropped_count"] >= 0, "Drop counter should be reported")
+	assert_eq(stats["async_pending"], 0, "Ring should be drained after flush")
+
+func test_async_capacity_locked_while_enabled():
+	logger.set_async_capacity(64)
+	logger.set_async_enabled(true)
+	logger.set_async_capacity(1024)
+	assert_eq(logger.get_async_capacity(), 64, "Capacity should not change while async is enabled")
+
+	logger.set_async_enabled(false)
+	logger.set_async_capacity(1024)
+	assert_eq(logger.get_async_capacity(), 1024, "Capacity should change while async is disabled")
+
+func test_long_messages_are_truncated():
+	logger.enable_logging(true)
+	logger.set_log_level(TorrentLogger.TRACE)
+	logger.set_async_enabled(true)
+	logger.reset_log_stats()
+
+	logger.log_trace("x".repeat(1000), "TEST")
+	logger.flush()
+
+	assert_eq(logger.get_log_stats()["truncated_count"], 1, "Oversized record should be counted as truncated")
+
+func test_long_messages_kept_whole_in_sync_mode():
+	var path = "user://test_sync_long_logger.log"
+	logger.enable_logging(true)
+	logger.set_log_level(TorrentLogger.TRACE)
+	logger.set_console_output_enabled(false)
+	logger.set_log_file(path)
+	logger.reset_log_stats()
+
+	var message = "y".repeat(1000)
+	logger.log_trace(message, "TEST")
+	logger.log_fmt(TorrentLogger.INFO, "long arg {}", ["z".repeat(1000)], "TEST")
+	logger.close_log_file()
+
+	var file = FileAccess.open(path, FileAccess.READ)
+	var text = file.get_as_text()
+	file.close()
+
+	assert_true(text.contains(message + "\n"), "Sync mode should write long messages in full")
+	assert_true(text.contains("long arg " + "z".repeat(1000)), "Sync mode should write long arguments in full")
+	assert_eq(logger.get_log_stats()["truncated_count"], 0, "Nothing should be truncated in sync mode")
+
+func test_binary_log_file_has_header():
+	var path = "user://test_binary_logger.gtlog"
+	logger.enable_logging(true)
+	logger.set_log_level(TorrentLogger.TRACE)
+	logger.set_console_output_enabled(false)
+	logger.set_log_format(TorrentLogger.FORMAT_BINARY)
+	logger.set_log_file(path)
+
+	logger.log_fmt(TorrentLogger.INFO, "piece {} took {} ms", [42, 1.5], "STORAGE")
+	logger.close_log_file()
+
+	var file = FileAccess.open(path, FileAccess.READ)
+	assert_not_null(file, "Binary log file should exist")
+	var bytes = file.get_buffer(file.get_length())
+	file.close()
+
+	assert_eq(bytes.slice(0, 5).get_string_from_ascii(), "GTLOG", "Binary log should start with the magic")
+	assert_true(bytes.size() > 16, "Binary log should contain records after the header")
+
+func test_log_fmt_text_output():
+	var path = "user://test_fmt_logger.log"
+	logger.enable_logging(true)
+	logger.set_log_level(TorrentLogger.TRACE)
+	logger.set_console_output_enabled(false)
+	logger.set_log_file(path)
+
+	logger.log_fmt(TorrentLogger.INFO, "{} peers, seeding={}", [7, true], "PEER")
+	logger.close_log_file()
+
+	var file = FileAccess.open(path, FileAccess.READ)
+	var text = file.get_as_text()
+	file.close()
+
+	assert_true(text.contains("[INFO] [PEER] 7 peers, seeding=true"), "Arguments should be substituted into the format")
+
+func test_log_rotation_creates_backup():
+	var path = "user://test_rotating_logger.log"
+	logger.enable_logging(true)
+	logger.set_log_level(TorrentLogger.TRACE)
+	logger.set_console_output_enabled(false)
+	logger.set_log_rotation(1024, 2)
+	logger.set_log_file(path)
+
+	for i in range(100):
+		logger.log_info("rotation message %d" % i, "TEST")
+	logger.close_log_file()
+
+	assert_true(FileAccess.file_exists(path + ".1"), "Rotated file should exist")
+	assert_false(FileAccess.file_exists(path + ".3"), "Only max_files backups should be kept")
+	var file = FileAccess.open(path, FileAccess.READ)
+	assert_true(file.get_length() <= 1024 + 256, "Active file should stay near the size limit")
+	file.close()
+
+func test_category_filtering():
+	logger.enable_logging(true)
+	logger.set_log_level(TorrentLogger.TRACE)
+	logger.set_console_output_enabled(false)
+	logger.disable_all_categories()
+	logger.enable_category(TorrentLogger.TRACKER, true)
+	logger.reset_log_stats()
+
+	logger.log_info("filtered", "PEER")
+	logger.log_info("kept", "TRACKER")
+	logger.log_info("custom categories are never filtered", "MY_GAME")
+	logger.log_info("uncategorized")
+
+	assert_false(logger.is_category_enabled(TorrentLogger.PEER), "PEER should be disabled")
+	assert_true(logger.is_category_enabled(TorrentLogger.TRACKER), "TRACKER should be enabled")
+	assert_eq(logger.get_log_stats()["info_count"], 3, "Only the disabled category should be filtered")
+
+func test_disabled_logger_counts_nothing():
+	logger.set_log_level(TorrentLogger.TRACE)
+	logger.reset_log_stats()
+
+	logger.log_error("ignored", "SESSION")
+	assert_eq(logger.get_log_stats()["total_count"], 0, "Disabled logger should not record anything")
+	assert_true(logger.get_log_stats().has("compiled_max_level"), "Stats should report the compiled-in level")
+
+func test_sample_rate_configuration():
+	assert_eq(logger.get_sample_rate(TorrentLogger.PEER), 1, "Sampling should be off by default")
+	logger.set_sample_rate(TorrentLogger.PEER, 100)
+	assert_eq(logger.get_sample_rate(TorrentLogger.PEER), 100, "Sample rate should be stored")
+	logger.set_sample_rate(TorrentLogger.PEER, 0)
+	assert_eq(logger.get_sample_rate(TorrentLogger.PEER), 1, "Invalid rates should mean no sampling")
+
+func test_traced_peers_and_torrents():
+	logger.add_traced_peer("203.0.113.7")
+	logger.add_traced_peer("198.51.100.2")
+	logger.remove_traced_peer("198.51.100.2")
+	assert_eq(logger.get_traced_peers(), PackedStringArray(["203.0.113.7"]), "Only the remaining peer should be traced")
+
+	logger.add_traced_torrent("ABCDEF0123456789ABCDEF0123456789ABCDEF01")
+	assert_eq(logger.get_traced_torrents()[0], "abcdef0123456789abcdef0123456789abcdef01", "Info hashes should be normalised to lower case")
+
+	logger.clear_traced_peers()
+	logger.clear_traced_torrents()
+	assert_eq(logger.get_traced_peers().size(), 0, "Peer allowlist should be empty")
+	assert_eq(logger.get_traced_torrents().size(), 0, "Torrent allowlist should be empty")
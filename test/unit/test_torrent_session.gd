@@ -2,6 +2,8 @@ extends GutTest
 
 # Tests for TorrentSession - Pure libtorrent wrapper
 
+const SEED_DIR = "user://test_seed_pool"
+
 var session: TorrentSession
 
 func before_each():
@@ -51,3 +53,393 @@ func test_dht_operations():
 	session.stop_dht()
 
 	assert_true(session.is_running(), "Session should still be running after DHT operations")
+
+func test_memory_storage_settings():
+	session.set_memory_storage_limit_mb(64)
+	var stats = session.get_memory_storage_stats()
+	assert_eq(stats["limit_bytes"], 64 * 1024 * 1024, "Limit should be stored in bytes")
+	assert_eq(stats["used_bytes"], 0, "No memory should be used before any torrent is added")
+	assert_eq(stats["default_backend"], "disk", "Disk storage should be the default")
+
+func test_memory_storage_backend_setting():
+	var result = session.start_session_with_settings({"storage_backend": "memory", "memory_storage_limit_mb": 16})
+	assert_true(result, "Session should start with memory storage settings")
+
+	var stats = session.get_memory_storage_stats()
+	assert_eq(stats["default_backend"], "memory", "Memory should be the session default")
+	assert_eq(stats["limit_bytes"], 16 * 1024 * 1024, "Limit from settings should be applied")
+
+func test_memory_storage_round_trip():
+	# Validates: data downloaded into memory exports byte for byte
+	if not session.is_memory_storage_supported():
+		pass_test("In-memory storage requires libtorrent 2.0")
+		return
+
+	var dir = ProjectSettings.globalize_path("user://test_memory_round_trip")
+	DirAccess.make_dir_recursive_absolute(dir)
+	var payload = PackedByteArray()
+	payload.resize(200000)
+	for i in range(payload.size()):
+		payload[i] = (i * 7 + 3) % 251
+	var file = FileAccess.open(dir.path_join("payload.bin"), FileAccess.WRITE)
+	file.store_buffer(payload)
+	file.close()
+
+	var creator = TorrentCreator.new()
+	creator.set_path(dir.path_join("payload.bin"))
+	creator.set_piece_size(16384)
+	var torrent = creator.generate()
+	assert_false(torrent.is_empty(), "Torrent should be created")
+
+	var loopback = {
+		"enable_dht": false,
+		"enable_lsd": false,
+		"enable_upnp": false,
+		"enable_natpmp": false,
+		"allow_multiple_connections_per_ip": true,
+	}
+	var seeder = TorrentSession.new()
+	loopback["listen_interfaces"] = "127.0.0.1:46881"
+	assert_true(seeder.start_session_with_settings(loopback), "Seeder should start")
+	seeder.add_torrent_file_trusted(torrent, dir)
+
+	loopback["listen_interfaces"] = "127.0.0.1:46882"
+	assert_true(session.start_session_with_settings(loopback), "Leecher should start")
+	var handle = session.add_torrent_file_in_memory(torrent)
+	assert_not_null(handle, "Torrent should be added in memory")
+	assert_true(session.get_memory_file_data(handle, 0).is_empty(), "Nothing should export before download")
+	handle.connect_peer("127.0.0.1", 46881)
+
+	var finished = false
+	for i in range(1000):
+		seeder.get_alerts()
+		session.get_alerts()
+		var status = handle.get_status()
+		if status and status.is_finished():
+			finished = true
+			break
+		OS.delay_msec(10)
+	assert_true(finished, "Download into memory should finish")
+
+	var exported = session.get_memory_file_data(handle, 0)
+	assert_eq(exported.size(), payload.size(), "Export should have the file size")
+	assert_true(exported == payload, "Exported bytes should match the source")
+
+	session.remove_torrent(handle)
+	seeder.stop_session()
+	DirAccess.remove_absolute(dir.path_join("payload.bin"))
+	DirAccess.remove_absolute(dir)
+
+func test_disk_io_backend_selection():
+	var backends = session.get_available_disk_io_backends()
+	assert_true(backends.has("default"), "Default backend should always be available")
+	assert_eq(session.get_disk_io_backend(), "default", "Default backend should be selected initially")
+
+	assert_false(session.set_disk_io_backend("no_such_backend"), "Unknown backend should be rejected")
+	assert_eq(session.get_disk_io_backend(), "default", "Rejected backend should not change the selection")
+
+	if backends.has("posix"):
+		assert_true(session.set_disk_io_backend("posix"), "Available backend should be accepted")
+		assert_true(session.start_session(), "Session should start with the selected backend")
+		assert_false(session.set_disk_io_backend("default"), "Backend cannot change while running")
+		assert_eq(session.get_disk_io_backend(), "posix")
+
+func test_recheck_queue_settings():
+	assert_eq(session.get_recheck_max_active(), 1, "One check should run at a time by default")
+	assert_eq(session.get_recheck_rate_limit(), 0, "Recheck rate should be unlimited by default")
+
+	session.set_recheck_max_active(3)
+	session.set_recheck_rate_limit(50 * 1024 * 1024)
+	assert_eq(session.get_recheck_max_active(), 3)
+	assert_eq(session.get_recheck_rate_limit(), 50 * 1024 * 1024)
+
+	session.pause_recheck_queue()
+	assert_true(session.is_recheck_queue_paused(), "Queue should report paused")
+	session.resume_recheck_queue()
+	assert_false(session.is_recheck_queue_paused(), "Queue should report resumed")
+
+	var status = session.get_recheck_status()
+	assert_eq(status["queued"], 0, "Queue should start empty")
+	assert_eq(status["torrents"].size(), 0, "No torrents should be listed")
+
+func test_queue_recheck_invalid_handle():
+	session.start_session()
+	assert_false(session.queue_recheck(TorrentHandle.new()), "Invalid handle should be rejected")
+	assert_eq(session.get_recheck_status()["queued"], 0, "Rejected handle should not be queued")
+
+func test_ip_filter_rules():
+	session.start_session()
+	assert_eq(session.add_ip_filter_rules(["10.0.0.0/8", "1.2.3.4-1.2.3.8", "::1"], true), 3, "All rules should apply")
+	assert_eq(session.add_ip_filter_rules(["not an address"], true), 0, "Invalid rules should be skipped")
+
+func test_load_ip_filter_file():
+	var path = "user://test_blocklist.p2p"
+	var file = FileAccess.open(path, FileAccess.WRITE)
+	file.store_line("# test list")
+	file.store_line("Example range:1.2.3.0-1.2.3.255")
+	file.store_line("Microsoft Corp, Inc:2.3.4.0-2.3.4.255")
+	file.store_line("AT&T/Bell:9.9.9.0-9.9.9.255")
+	file.store_line("005.006.007.000 - 005.006.007.255 , 000 , dat entry")
+	file.store_line("8.8.0.0/16")
+	file.store_line("garbage")
+	file.close()
+
+	assert_false(session.load_ip_filter_file(path), "Loading needs a running session")
+	session.start_session()
+	assert_true(session.load_ip_filter_file(path), "Load should start")
+
+	for i in range(100):
+		session.get_alerts()
+		if not session.is_ip_filter_loading() and not session.get_ip_filter_status()["last_load"].is_empty():
+			break
+		await wait_frames(1)
+
+	var last_load = session.get_ip_filter_status()["last_load"]
+	assert_true(last_load["success"], "Blocklist should be installed")
+	assert_eq(last_load["ranges"], 5, "P2P descriptions with commas or slashes should parse")
+	assert_eq(last_load["invalid_lines"], 1, "Garbage line should be counted")
+	DirAccess.remove_absolute(ProjectSettings.globalize_path(path))
+
+func test_load_ip_filter_file_merge():
+	var path = "user://test_blocklist_merge.p2p"
+	var file = FileAccess.open(path, FileAccess.WRITE)
+	file.store_line("Example range:1.2.3.0-1.2.3.255")
+	file.close()
+
+	session.start_session()
+	session.add_ip_filter_rule("10.0.0.0/8", true)
+	assert_true(session.load_ip_filter_file(path, true), "Merge load should start")
+
+	# Draining without reading alerts still installs the filter
+	for i in range(100):
+		session.clear_alerts()
+		if not session.is_ip_filter_loading() and not session.get_ip_filter_status()["last_load"].is_empty():
+			break
+		await wait_frames(1)
+
+	assert_true(session.get_ip_filter_status()["last_load"]["success"], "Blocklist should be installed")
+	assert_true(session.is_ip_blocked("1.2.3.4"), "File range should be blocked after a merge")
+	assert_true(session.is_ip_blocked("10.1.2.3"), "Existing rule should survive the merge")
+	assert_false(session.is_ip_blocked("8.8.8.8"), "Other addresses should stay allowed")
+	DirAccess.remove_absolute(ProjectSettings.globalize_path(path))
+
+func test_peer_classes():
+	assert_eq(session.create_peer_class("wan"), -1, "Classes need a running session")
+	session.start_session()
+
+	var wan = session.create_peer_class("wan")
+	assert_gt(wan, TorrentSession.PEER_CLASS_LOCAL, "New class should not reuse a built-in id")
+	assert_true(session.configure_peer_class(wan, {"upload_limit": 4096, "upload_priority": 300}))
+
+	var info = session.get_peer_class(wan)
+	assert_eq(info["label"], "wan")
+	assert_eq(info["upload_limit"], 4096)
+	assert_eq(info["upload_priority"], 255, "Priority should be clamped")
+
+	assert_true(session.set_peer_class_range("10.0.0.0/8", [TorrentSession.PEER_CLASS_LOCAL]))
+	assert_true(session.set_peer_class_range("0.0.0.0-255.255.255.255", [TorrentSession.PEER_CLASS_GLOBAL, wan]))
+	assert_false(session.set_peer_class_range("bogus", [wan]), "Invalid range should be rejected")
+	assert_false(session.set_peer_class_range("1.2.3.4", [40]), "Invalid class id should be rejected")
+	session.delete_peer_class(wan)
+
+func test_bandwidth_governor_throttles_during_gameplay():
+	assert_false(session.set_bandwidth_governor_enabled(true), "Governor needs a running session")
+	session.start_session()
+	session.set_download_rate_limit(0)
+	assert_true(session.set_bandwidth_governor_enabled(true))
+	session.set_bandwidth_governor_config({"frame_budget_ms": 16.0, "escalate_frames": 2, "menu_relax_frames": 1})
+
+	# Slow frames outside gameplay never throttle
+	for i in range(10):
+		session.update_bandwidth_governor(40.0)
+	assert_eq(session.get_bandwidth_governor_status()["level"], 0, "Menus should stay unthrottled")
+
+	session.set_gameplay_active(true)
+	for i in range(4):
+		session.update_bandwidth_governor(40.0)
+	var status = session.get_bandwidth_governor_status()
+	assert_gt(status["level"], 0, "Slow gameplay frames should throttle")
+	assert_gt(status["download_limit"], 0, "Throttled level should cap downloads")
+
+	# User limits set while throttled become the new level 0
+	session.set_download_rate_limit(1048576)
+	status = session.get_bandwidth_governor_status()
+	assert_gt(status["level"], 0, "Changing the limit should keep the level")
+	assert_lt(status["download_limit"], 1048576, "Throttled level should scale the new limit")
+
+	session.set_gameplay_active(false)
+	for i in range(10):
+		session.update_bandwidth_governor(40.0)
+	assert_eq(session.get_bandwidth_governor_status()["level"], 0, "Leaving gameplay should relax")
+	assert_eq(session.get_bandwidth_governor_status()["download_limit"], 1048576, "Level 0 should be the user limit")
+
+	assert_true(session.set_bandwidth_governor_enabled(false))
+	assert_false(session.is_bandwidth_governor_enabled())
+
+func test_download_wishlist_plans_torrents():
+	assert_false(session.set_download_wishlist([]), "Wish list needs a running session")
+	session.start_session()
+	var handle = session.add_magnet_uri("magnet:?xt=urn:btih:dd8255ecdc7ca55fb0bbf81323d87062db1f6d1c", "user://test_wishlist")
+	assert_not_null(handle)
+
+	assert_true(session.set_download_wishlist([{"handle": handle, "needed_in": 30.0}]))
+	var status = session.get_wishlist_status()
+	assert_eq(status["max_active"], 3)
+	assert_eq(status["wishes"].size(), 1)
+	var wish = status["wishes"][0]
+	assert_eq(wish["info_hash"], "dd8255ecdc7ca55fb0bbf81323d87062db1f6d1c")
+	assert_eq(wish["file_index"], -1)
+	assert_eq(wish["state"], "active", "The first wish should be forced active")
+	assert_lt(wish["needed_in"], 30.1)
+
+	assert_false(session.set_download_wishlist([{"file_index": 0}]), "Wish without a handle should be rejected")
+	assert_eq(session.get_wishlist_status()["wishes"].size(), 1, "Rejected list should keep the previous one")
+
+	session.clear_download_wishlist()
+	assert_eq(session.get_wishlist_status()["wishes"].size(), 0)
+
+func test_seed_pool_loads_on_request():
+	var paths = _write_seed_torrents(1)
+	var info_hash = session.add_seed(paths[0], SEED_DIR)
+	assert_ne(info_hash, "", "Registration should report the info hash")
+	assert_true(session.has_seed(info_hash.to_upper()), "Lookup should ignore case")
+	assert_eq(session.add_seed(paths[0], SEED_DIR), "", "Duplicate should be rejected")
+	assert_eq(session.add_seed(SEED_DIR.path_join("missing.torrent"), SEED_DIR), "", "Missing file should be rejected")
+
+	session.start_session()
+	session.set_seed_pool_config({"announce_interval": 0})
+	assert_true(session.request_seed(info_hash))
+	_wait_for_seeds(1)
+	var stats = session.get_seed_pool_stats()
+	assert_eq(stats["registered"], 1)
+	assert_eq(stats["loads"], 1, "Requested torrent should be loaded once")
+	assert_eq(stats["loaded"], 1, "Torrent should be loaded once its add completes")
+	assert_eq(stats["loading"], 0)
+
+	assert_true(session.remove_seed(info_hash))
+	assert_false(session.has_seed(info_hash))
+	assert_eq(session.get_seed_pool_stats()["loaded"], 0, "Removing should unload")
+	_remove_seed_dir()
+
+func test_seed_pool_evicts_at_max_loaded():
+	var paths = _write_seed_torrents(2)
+	var first = session.add_seed(paths[0], SEED_DIR)
+	var second = session.add_seed(paths[1], SEED_DIR)
+
+	session.start_session()
+	session.set_seed_pool_config({"announce_interval": 0, "max_loaded": 1})
+	session.request_seed(first)
+	_wait_for_seeds(1)
+
+	# Full: the next request evicts the idle torrent
+	session.request_seed(second)
+	_wait_for_seeds(1, 2)
+	var stats = session.get_seed_pool_stats()
+	assert_eq(stats["loads"], 2, "Second torrent should be loaded")
+	assert_eq(stats["evictions"], 1, "First torrent should be evicted")
+	assert_eq(stats["loaded"], 1, "Never more than max_loaded")
+	_remove_seed_dir()
+
+func test_seed_pool_driven_by_clear_alerts():
+	var paths = _write_seed_torrents(1)
+	var info_hash = session.add_seed(paths[0], SEED_DIR)
+
+	session.start_session()
+	session.set_seed_pool_config({"announce_interval": 0})
+	session.request_seed(info_hash)
+	_wait_for_seeds(1, 1, true)
+	var stats = session.get_seed_pool_stats()
+	assert_eq(stats["loaded"], 1, "Draining alerts should complete the load")
+	assert_eq(stats["loading"], 0, "Nothing should be left loading")
+	_remove_seed_dir()
+
+func test_seed_pool_remove_while_loading():
+	var paths = _write_seed_torrents(1)
+	var info_hash = session.add_seed(paths[0], SEED_DIR)
+
+	session.start_session()
+	session.set_seed_pool_config({"announce_interval": 0})
+	session.request_seed(info_hash)
+	session.update_seed_pool()
+	assert_eq(session.get_seed_pool_stats()["loading"], 1, "Add should be in flight")
+
+	assert_true(session.remove_seed(info_hash))
+	assert_eq(session.get_seed_pool_stats()["loading"], 0)
+
+	# The late add is dropped from the session instead of being adopted
+	for i in range(50):
+		session.get_alerts()
+		OS.delay_msec(10)
+	var stats = session.get_seed_pool_stats()
+	assert_eq(stats["registered"], 0)
+	assert_eq(stats["loaded"], 0, "Orphaned add should not be loaded")
+
+	# Still in the session it would make loading it again fail as a duplicate
+	info_hash = session.add_seed(paths[0], SEED_DIR)
+	session.request_seed(info_hash)
+	_wait_for_seeds(1, 2)
+	stats = session.get_seed_pool_stats()
+	assert_eq(stats["loaded"], 1, "Re-registered torrent should load")
+	assert_eq(stats["failed"], 0, "Orphan should have been removed from the session")
+	_remove_seed_dir()
+
+func test_queue_settings():
+	session.start_session()
+	session.set_active_limits(4, 8, 12)
+	session.set_slow_torrent_exemption(true, 1024, 512)
+
+	var queue = session.get_queue_settings()
+	assert_eq(queue["active_downloads"], 4)
+	assert_eq(queue["active_seeds"], 8)
+	assert_eq(queue["active_limit"], 12)
+	assert_true(queue["dont_count_slow_torrents"])
+	assert_eq(queue["inactive_down_rate"], 1024)
+	assert_eq(queue["inactive_up_rate"], 512)
+
+	var handle = session.add_magnet_uri("magnet:?xt=urn:btih:c9e15763f722f23e98a29decdfae341b98d53056", "user://test_queue")
+	handle.set_auto_managed(false)
+	assert_false(handle.is_auto_managed())
+	handle.set_auto_managed(true)
+	assert_true(handle.is_auto_managed())
+
+# Writes `count` torrents with distinct payloads into SEED_DIR; returns their paths
+func _write_seed_torrents(count: int) -> Array:
+	var dir = ProjectSettings.globalize_path(SEED_DIR)
+	DirAccess.make_dir_recursive_absolute(dir)
+	var paths = []
+	for i in range(count):
+		var payload = PackedByteArray()
+		payload.resize(40000)
+		payload.fill(i + 1)
+		var payload_name = "seed_%d.bin" % i
+		var file = FileAccess.open(dir.path_join(payload_name), FileAccess.WRITE)
+		file.store_buffer(payload)
+		file.close()
+
+		var creator = TorrentCreator.new()
+		creator.set_path(dir.path_join(payload_name))
+		var path = dir.path_join("seed_%d.torrent" % i)
+		file = FileAccess.open(path, FileAccess.WRITE)
+		file.store_buffer(creator.generate())
+		file.close()
+		paths.append(path)
+	return paths
+
+# Polls alerts (which drive the pool) until `loaded` torrents are loaded
+# after at least `loads` loads; `drain_only` polls with clear_alerts()
+func _wait_for_seeds(loaded: int, loads: int = 1, drain_only: bool = false):
+	for i in range(200):
+		if drain_only:
+			session.clear_alerts()
+		else:
+			session.get_alerts()
+		var stats = session.get_seed_pool_stats()
+		if stats["loaded"] == loaded and stats["loads"] >= loads and stats["loading"] == 0:
+			return
+		OS.delay_msec(10)
+
+func _remove_seed_dir():
+	var dir = ProjectSettings.globalize_path(SEED_DIR)
+	for file_name in DirAccess.get_files_at(dir):
+		DirAccess.remove_absolute(dir.path_join(file_name))
+	DirAccess.remove_absolute(dir)
@@ -0,0 +1,354 @@
+// torrent_disk_benchmark - A/B throughput test of the disk I/O backends
+//
+// Usage: torrent_disk_benchmark [options]
+//   --backend NAME        default, mmap, posix, memory or all (default: all)
+//   --path DIR            Directory for the test data (default: disk_benchmark_data)
+//   --size-mb N           Size of the test torrent (default: 256)
+//   --piece-kb N          Piece size (default: 1024)
+//   --aio-threads N       settings_pack::aio_threads (default: 10)
+//   --hashing-threads N   settings_pack::hashing_threads (default: 2)
+//   --queue-depth N       Outstanding 16 KiB jobs (default: 256)
+//
+// Writes, hashes and reads back a synthetic single-file torrent through the
+// disk_interface directly (no peers, no network) and prints one JSON object
+// per backend. Run it on the drive being tuned for. Every phase goes through
+// the OS page cache, so pick a size well above free RAM to measure the device
+// rather than the cache.
+
+#include "memory_disk_io.h"
+
+#include <libtorrent/version.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#if LIBTORRENT_VERSION_NUM >= 20000
+#include <libtorrent/disk_interface.hpp>
+#include <libtorrent/disk_buffer_holder.hpp>
+#include <libtorrent/file_storage.hpp>
+#include <libtorrent/hasher.hpp>
+#include <libtorrent/io_context.hpp>
+#include <libtorrent/peer_request.hpp>
+#include <libtorrent/performance_counters.hpp>
+#include <libtorrent/session_handle.hpp>
+#include <libtorrent/settings_pack.hpp>
+#include <libtorrent/storage_defs.hpp>
+
+#include <boost/asio/executor_work_guard.hpp>
+
+namespace lt = libtorrent;
+
+namespace {
+
+struct Options {
+    std::string backend = "all";
+    std::string path = "disk_benchmark_data";
+    int64_t size_mb = 256;
+    int piece_kb = 1024;
+    int aio_threads = 10;
+    int hashing_threads = 2;
+    int queue_depth = 256;
+};
+
+struct Phase {
+    double seconds = 0.0;
+    int64_t bytes = 0;
+    int errors = 0;
+    int mismatches = 0;
+};
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+std::string phase_json(const Phase& phase) {
+    double mb_per_sec = phase.seconds > 0.0 ? phase.bytes / (1024.0 * 1024.0) / phase.seconds : 0.0;
+
+    char buffer[160];
+    std::snprintf(buffer, sizeof(buffer),
+        "{\"seconds\":%.3f,\"bytes\":%lld,\"mb_per_sec\":%.1f,\"errors\":%d,\"mismatches\":%d}",
+        phase.seconds, static_cast<long long>(phase.bytes), mb_per_sec, phase.errors, phase.mismatches);
+    return buffer;
+}
+
+// Drives the disk I/O: handlers are posted to the io_context, so completions
+// are counted by running it until enough jobs are left in flight
+class Pump {
+public:
+    Pump(lt::io_context& ioc, lt::disk_interface& disk) : _ioc(ioc), _disk(disk), _outstanding(0) {}
+
+    void started() { _outstanding++; }
+    void finished() { _outstanding--; }
+
+    void wait_until(int in_flight) {
+        _disk.submit_jobs();
+        while (_outstanding > in_flight) {
+            _ioc.run_one();
+        }
+    }
+
+private:
+    lt::io_context& _ioc;
+    lt::disk_interface& _disk;
+    int _outstanding;
+};
+
+bool run_backend(const std::string& name, const Options& options) {
+    lt::disk_io_constructor_type constructor;
+    std::shared_ptr<memory_storage::MemoryStore> store;
+
+    if (name == "memory") {
+        store = std::make_shared<memory_storage::MemoryStore>();
+        store->set_memory_default(true);
+        constructor = memory_storage::make_disk_io_constructor(store, nullptr);
+    } else {
+        constructor = memory_storage::disk_io_constructor_for(name);
+    }
+
+    if (!constructor) {
+        std::fprintf(stderr, "skipping %s: not available in this build\n", name.c_str());
+        // Only an explicitly requested backend counts as a failure
+        return options.backend == "all";
+    }
+
+    int const piece_size = options.piece_kb * 1024;
+    int64_t const total_size = options.size_mb * 1024 * 1024;
+    int const num_pieces = static_cast<int>((total_size + piece_size - 1) / piece_size);
+    int const block_size = lt::default_block_size;
+
+    // A handful of distinct piece payloads, so hashing cannot be short-cut
+    // and a read from the wrong offset is caught
+    int const variants = 16;
+    std::vector<char> pool(static_cast<size_t>(piece_size) + variants * 4096);
+    std::mt19937 random(42);
+    for (char& byte : pool) {
+        byte = static_cast<char>(random());
+    }
+
+    auto piece_data = [&](int piece) { return pool.data() + (piece % variants) * 4096; };
+    auto piece_length = [&](int piece) {
+        return piece == num_pieces - 1 ? static_cast<int>(total_size - int64_t(piece) * piece_size) : piece_size;
+    };
+
+    std::vector<lt::sha1_hash> expected(static_cast<size_t>(num_pieces));
+    for (int piece = 0; piece < num_pieces; piece++) {
+        expected[piece] = lt::hasher(piece_data(piece), piece_length(piece)).final();
+    }
+
+    lt::io_context ioc;
+    auto work = boost::asio::make_work_guard(ioc);
+    lt::counters counters;
+    lt::settings_pack settings;
+    settings.set_int(lt::settings_pack::aio_threads, options.aio_threads);
+    settings.set_int(lt::settings_pack::hashing_threads, options.hashing_threads);
+
+    std::unique_ptr<lt::disk_interface> disk = constructor(ioc, settings, counters);
+    Pump pump(ioc, *disk);
+
+    lt::file_storage files;
+    files.set_piece_length(piece_size);
+    files.add_file("disk_benchmark/" + name + ".dat", total_size);
+    files.set_num_pieces(num_pieces);
+
+    lt::sha1_hash info_hash;
+    for (auto& byte : info_hash) {
+        byte = static_cast<std::uint8_t>(random());
+    }
+
+    lt::aux::vector<lt::download_priority_t, lt::file_index_t> priorities;
+    lt::storage_params params(files, nullptr, options.path, lt::storage_mode_sparse, priorities, info_hash);
+    lt::storage_holder storage = disk->new_torrent(params, std::shared_ptr<void>());
+
+    int const depth = options.queue_depth > 0 ? options.queue_depth : 1;
+
+    // Write
+    Phase write;
+    Clock::time_point start = Clock::now();
+    for (int piece = 0; piece < num_pieces; piece++) {
+        int const length = piece_length(piece);
+        for (int offset = 0; offset < length; offset += block_size) {
+            lt::peer_request request;
+            request.piece = lt::piece_index_t(piece);
+            request.start = offset;
+            request.length = std::min(block_size, length - offset);
+
+            pump.started();
+            disk->async_write(storage.index(), request, piece_data(piece) + offset, nullptr,
+                [&](lt::storage_error const& error) {
+                    pump.finished();
+                    if (error.ec) write.errors++;
+                });
+            write.bytes += request.length;
+
+            if (write.errors > 0) break;
+            pump.wait_until(depth - 1);
+        }
+    }
+    pump.wait_until(0);
+
+    // Closing the files flushes what the backend still holds
+    pump.started();
+    disk->async_release_files(storage.index(), [&]() { pump.finished(); });
+    pump.wait_until(0);
+    write.seconds = seconds_since(start);
+
+    // Hash (v1 only, the same job a recheck or piece completion runs)
+    Phase hash;
+    int const hash_depth = std::max(1, depth * block_size / piece_size);
+    start = Clock::now();
+    for (int piece = 0; piece < num_pieces && write.errors == 0; piece++) {
+        pump.started();
+        disk->async_hash(storage.index(), lt::piece_index_t(piece), {}, lt::disk_interface::sequential_access,
+            [&](lt::piece_index_t index, lt::sha1_hash const& result, lt::storage_error const& error) {
+                pump.finished();
+                if (error.ec) {
+                    hash.errors++;
+                } else if (result != expected[static_cast<int>(index)]) {
+                    hash.mismatches++;
+                }
+            });
+        hash.bytes += piece_length(piece);
+        pump.wait_until(hash_depth - 1);
+    }
+    pump.wait_until(0);
+    hash.seconds = seconds_since(start);
+
+    // Read
+    Phase read;
+    start = Clock::now();
+    for (int piece = 0; piece < num_pieces && write.errors == 0; piece++) {
+        int const length = piece_length(piece);
+        for (int offset = 0; offset < length; offset += block_size) {
+            lt::peer_request request;
+            request.piece = lt::piece_index_t(piece);
+            request.start = offset;
+            request.length = std::min(block_size, length - offset);
+
+            char const* source = piece_data(piece) + offset;
+            int const block_length = request.length;
+
+            pump.started();
+            disk->async_read(storage.index(), request,
+                [&, source, block_length](lt::disk_buffer_holder buffer, lt::storage_error const& error) {
+                    pump.finished();
+                    if (error.ec) {
+                        read.errors++;
+                    } else if (buffer.size() < block_length || std::memcmp(buffer.data(), source, block_length) != 0) {
+                        read.mismatches++;
+                    }
+                });
+            read.bytes += request.length;
+            pump.wait_until(depth - 1);
+        }
+    }
+    pump.wait_until(0);
+    read.seconds = seconds_since(start);
+
+    pump.started();
+    disk->async_delete_files(storage.index(), lt::session_handle::delete_files,
+        [&](lt::storage_error const&) { pump.finished(); });
+    pump.wait_until(0);
+
+    storage = lt::storage_holder();
+    disk->abort(true);
+    work.reset();
+    ioc.run();
+
+    std::printf("{\"backend\":\"%s\",\"size_bytes\":%lld,\"piece_size\":%d,\"aio_threads\":%d,"
+        "\"hashing_threads\":%d,\"queue_depth\":%d,\"write\":%s,\"hash\":%s,\"read\":%s}\n",
+        name.c_str(), static_cast<long long>(total_size), piece_size, options.aio_threads,
+        options.hashing_threads, depth, phase_json(write).c_str(), phase_json(hash).c_str(),
+        phase_json(read).c_str());
+    std::fflush(stdout);
+
+    return write.errors == 0 && hash.errors == 0 && hash.mismatches == 0 &&
+        read.errors == 0 && read.mismatches == 0;
+}
+
+bool parse_int(const char* value, int64_t& out) {
+    char* end = nullptr;
+    long long parsed = std::strtoll(value, &end, 10);
+    if (!end || *end != '\0' || parsed <= 0) {
+        return false;
+    }
+    out = parsed;
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "--help" || arg == "-h") {
+            std::printf("Usage: %s [--backend default|mmap|posix|memory|all] [--path DIR] [--size-mb N]\n"
+                "       [--piece-kb N] [--aio-threads N] [--hashing-threads N] [--queue-depth N]\n", argv[0]);
+            return 0;
+        }
+
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "error: %s needs a value\n", arg.c_str());
+            return 2;
+        }
+        const char* value = argv[++i];
+
+        int64_t number = 0;
+        if (arg == "--backend") {
+            options.backend = value;
+        } else if (arg == "--path") {
+            options.path = value;
+        } else if (parse_int(value, number)) {
+            if (arg == "--size-mb") options.size_mb = number;
+            else if (arg == "--piece-kb") options.piece_kb = static_cast<int>(number);
+            else if (arg == "--aio-threads") options.aio_threads = static_cast<int>(number);
+            else if (arg == "--hashing-threads") options.hashing_threads = static_cast<int>(number);
+            else if (arg == "--queue-depth") options.queue_depth = static_cast<int>(number);
+            else {
+                std::fprintf(stderr, "error: unknown option %s\n", arg.c_str());
+                return 2;
+            }
+        } else {
+            std::fprintf(stderr, "error: %s expects a positive number, got '%s'\n", arg.c_str(), value);
+            return 2;
+        }
+    }
+
+    if (options.piece_kb % 16 != 0) {
+        std::fprintf(stderr, "error: --piece-kb must be a multiple of 16\n");
+        return 2;
+    }
+
+    std::vector<std::string> backends;
+    if (options.backend == "all") {
+        backends = {"default", "mmap", "posix", "memory"};
+    } else {
+        backends.push_back(options.backend);
+    }
+
+    bool ok = true;
+    for (const std::string& backend : backends) {
+        ok = run_backend(backend, options) && ok;
+    }
+
+    return ok ? 0 : 1;
+}
+
+#else
+
+int main(int, char** argv) {
+    std::fprintf(stderr, "%s: selectable disk I/O requires libtorrent 2.0\n", argv[0]);
+    return 1;
+}
+
+#endif
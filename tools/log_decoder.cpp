@@ -0,0 +1,160 @@
+// torrent_log_decoder - Convert binary TorrentLogger files back to text
+//
+// Usage: torrent_log_decoder [--json] <file.gtlog> [more files...]
+//
+// Rotated files (log.gtlog.1, log.gtlog.2, ...) are self-contained and can be
+// passed in any order; pass them oldest first to get a chronological stream.
+
+#include "binary_log_format.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+std::string json_escape(const std::string& value) {
+    std::string out;
+    out.reserve(value.size() + 2);
+    for (char c : value) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    out += buffer;
+                } else {
+                    out.push_back(c);
+                }
+        }
+    }
+    return out;
+}
+
+bool decode_file(const char* path, bool json) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::fprintf(stderr, "error: cannot open %s\n", path);
+        return false;
+    }
+
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    uint64_t timestamp = 0;
+    if (!binary_log::read_file_header(data.data(), data.size(), timestamp)) {
+        std::fprintf(stderr, "error: %s is not a binary torrent log (or unsupported version)\n", path);
+        return false;
+    }
+
+    std::unordered_map<uint64_t, std::string> strings;
+    std::vector<binary_log::DecodedArg> args;
+
+    const uint8_t* cursor = data.data() + binary_log::HEADER_SIZE;
+    const uint8_t* end = data.data() + data.size();
+
+    while (cursor < end) {
+        uint8_t tag = *cursor++;
+
+        if (tag == binary_log::TAG_STRING) {
+            uint64_t id, length;
+            if (!binary_log::read_varint(cursor, end, id) ||
+                    !binary_log::read_varint(cursor, end, length) ||
+                    length > static_cast<uint64_t>(end - cursor)) {
+                break;
+            }
+            strings[id].assign(reinterpret_cast<const char*>(cursor), length);
+            cursor += length;
+        } else if (tag == binary_log::TAG_RECORD) {
+            uint64_t delta, category_id, format_id, payload_length;
+            if (!binary_log::read_varint(cursor, end, delta) || cursor >= end) {
+                break;
+            }
+            uint8_t level_flags = *cursor++;
+            if (!binary_log::read_varint(cursor, end, category_id) ||
+                    !binary_log::read_varint(cursor, end, format_id) || cursor >= end) {
+                break;
+            }
+            uint8_t argc = *cursor++;
+            if (!binary_log::read_varint(cursor, end, payload_length) ||
+                    payload_length > static_cast<uint64_t>(end - cursor)) {
+                break;
+            }
+
+            timestamp += binary_log::zigzag_decode(delta);
+
+            if (!binary_log::decode_args(cursor, payload_length, argc, args)) {
+                std::fprintf(stderr, "warning: %s: malformed record arguments\n", path);
+            }
+            cursor += payload_length;
+
+            std::string message = binary_log::format_message(strings[format_id], args);
+            if (level_flags & binary_log::FLAG_TRUNCATED) {
+                message += "...";
+            }
+            const std::string& category = strings[category_id];
+
+            if (json) {
+                std::printf("{\"time_usec\":%llu,\"level\":\"%s\",\"category\":\"%s\",\"message\":\"%s\"}\n",
+                    static_cast<unsigned long long>(timestamp),
+                    binary_log::level_name(level_flags),
+                    json_escape(category).c_str(),
+                    json_escape(message).c_str());
+            } else if (category.empty()) {
+                std::printf("[%s] [%s] %s\n", binary_log::format_timestamp(timestamp).c_str(),
+                    binary_log::level_name(level_flags), message.c_str());
+            } else {
+                std::printf("[%s] [%s] [%s] %s\n", binary_log::format_timestamp(timestamp).c_str(),
+                    binary_log::level_name(level_flags), category.c_str(), message.c_str());
+            }
+        } else {
+            std::fprintf(stderr, "error: %s: unknown entry tag 0x%02x\n", path, tag);
+            return false;
+        }
+    }
+
+    if (cursor < end) {
+        // A partially written tail is expected if the process was killed
+        std::fprintf(stderr, "warning: %s: truncated entry at end of file\n", path);
+    }
+
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool json = false;
+    std::vector<const char*> files;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
+            std::printf("Usage: %s [--json] <file.gtlog> [more files...]\n", argv[0]);
+            return 0;
+        } else {
+            files.push_back(argv[i]);
+        }
+    }
+
+    if (files.empty()) {
+        std::fprintf(stderr, "Usage: %s [--json] <file.gtlog> [more files...]\n", argv[0]);
+        return 2;
+    }
+
+    bool ok = true;
+    for (const char* path : files) {
+        ok = decode_file(path, json) && ok;
+    }
+
+    return ok ? 0 : 1;
+}
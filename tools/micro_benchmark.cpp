@@ -0,0 +1,405 @@
+// torrent_micro_benchmark - Native cost of the hot TorrentSession/TorrentHandle calls
+//
+// Usage: torrent_micro_benchmark [--iterations N] [--files N] [--filter NAME]
+//
+// Runs the libtorrent work behind each frequently polled binding without the
+// Godot engine, so only the native side is measured: alert popping and
+// conversion, status refresh, peer list copies, file enumeration and
+// .torrent parsing. benchmark/binding_overhead.gd times the same operations
+// through the bindings under headless Godot, using the same result names;
+// the difference between the two is the binding (Variant/Dictionary) cost.
+//
+// Prints a single JSON object. Per-iteration timings are summarised as mean,
+// median and p99 in microseconds; per_item_ns divides the mean by the number
+// of items (alerts, files, peers) handled per iteration.
+
+#include <libtorrent/session.hpp>
+#include <libtorrent/settings_pack.hpp>
+#include <libtorrent/add_torrent_params.hpp>
+#include <libtorrent/alert_types.hpp>
+#include <libtorrent/torrent_info.hpp>
+#include <libtorrent/torrent_status.hpp>
+#include <libtorrent/create_torrent.hpp>
+#include <libtorrent/file_storage.hpp>
+#include <libtorrent/peer_info.hpp>
+#include <libtorrent/bencode.hpp>
+#include <libtorrent/address.hpp>
+#include <libtorrent/socket.hpp>
+#include <libtorrent/hex.hpp>
+#include <libtorrent/version.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace lt = libtorrent;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    int iterations = 200;
+    int files = 100000;
+    std::string filter;
+};
+
+struct Result {
+    std::string name;
+    int iterations = 0;
+    int64_t items = 0;
+    double mean_us = 0.0;
+    double median_us = 0.0;
+    double p99_us = 0.0;
+};
+
+std::vector<Result> g_results;
+
+// Conversions feed this so the compiler cannot drop them
+volatile size_t g_sink = 0;
+
+bool selected(const Options& options, const char* name) {
+    return options.filter.empty() || std::strstr(name, options.filter.c_str()) != nullptr;
+}
+
+// Times `body` once per iteration; `setup` runs before each iteration and is
+// not included. `body` returns the number of items it handled.
+void measure(const Options& options, const char* name, int iterations,
+        const std::function<void()>& setup, const std::function<int64_t()>& body) {
+    if (!selected(options, name)) {
+        return;
+    }
+
+    std::vector<double> samples;
+    samples.reserve(static_cast<size_t>(iterations));
+    int64_t items = 0;
+
+    for (int i = 0; i < iterations; i++) {
+        if (setup) {
+            setup();
+        }
+        Clock::time_point start = Clock::now();
+        items += body();
+        samples.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+
+    Result result;
+    result.name = name;
+    result.iterations = iterations;
+    result.items = iterations > 0 ? items / iterations : 0;
+
+    double total = 0.0;
+    for (double sample : samples) {
+        total += sample;
+    }
+    std::sort(samples.begin(), samples.end());
+    result.mean_us = iterations > 0 ? total / iterations : 0.0;
+    result.median_us = iterations > 0 ? samples[samples.size() / 2] : 0.0;
+    result.p99_us = iterations > 0 ? samples[std::min(samples.size() - 1, samples.size() * 99 / 100)] : 0.0;
+
+    g_results.push_back(result);
+    std::fprintf(stderr, "%-28s %10.2f us/call\n", name, result.mean_us);
+}
+
+std::string info_hash_hex(const lt::torrent_status& status) {
+#if LIBTORRENT_VERSION_NUM >= 20000
+    return lt::aux::to_hex(status.info_hashes.get_best());
+#else
+    return lt::aux::to_hex(status.info_hash);
+#endif
+}
+
+// v1 torrent with dummy piece hashes; the name makes the info hash unique
+std::vector<char> make_torrent(const std::string& name, int num_files, int64_t file_size) {
+    lt::file_storage files;
+    for (int i = 0; i < num_files; i++) {
+        files.add_file(name + "/dir_" + std::to_string(i / 1000) + "/file_" + std::to_string(i) + ".dat", file_size);
+    }
+
+#if LIBTORRENT_VERSION_NUM >= 20000
+    lt::create_torrent creator(files, 64 * 1024, lt::create_torrent::v1_only);
+#else
+    lt::create_torrent creator(files, 64 * 1024);
+#endif
+
+    lt::sha1_hash hash;
+    for (int piece = 0; piece < creator.num_pieces(); piece++) {
+        creator.set_hash(lt::piece_index_t(piece), hash);
+    }
+
+    std::vector<char> buffer;
+    lt::bencode(std::back_inserter(buffer), creator.generate());
+    return buffer;
+}
+
+std::shared_ptr<lt::torrent_info> parse_torrent(const std::vector<char>& buffer) {
+    lt::error_code ec;
+    auto info = std::make_shared<lt::torrent_info>(buffer.data(), static_cast<int>(buffer.size()), ec);
+    if (ec) {
+        std::fprintf(stderr, "error: failed to parse generated torrent: %s\n", ec.message().c_str());
+        std::exit(1);
+    }
+    return info;
+}
+
+lt::add_torrent_params paused_params(std::shared_ptr<lt::torrent_info> info) {
+    lt::add_torrent_params params;
+    params.ti = std::move(info);
+    params.save_path = "micro_benchmark_data";
+    params.flags &= ~lt::torrent_flags::auto_managed;
+    params.flags |= lt::torrent_flags::paused;
+    return params;
+}
+
+// The per-alert work TorrentSession::get_alerts does before building Variants
+int64_t convert_alerts(lt::session& session) {
+    std::vector<lt::alert*> alerts;
+    session.pop_alerts(&alerts);
+
+    size_t sink = 0;
+    for (lt::alert* alert : alerts) {
+        std::string message = alert->message();
+        sink += message.size() + static_cast<size_t>(alert->type()) + std::strlen(alert->what());
+
+        if (auto* update = lt::alert_cast<lt::state_update_alert>(alert)) {
+            for (const lt::torrent_status& status : update->status) {
+                sink += info_hash_hex(status).size();
+                sink += static_cast<size_t>(status.state) + static_cast<size_t>(status.num_peers);
+                sink += static_cast<size_t>(status.total_done);
+            }
+        }
+    }
+
+    g_sink = g_sink + sink;
+    return static_cast<int64_t>(alerts.size());
+}
+
+void settle(lt::session& session) {
+    // Alerts are posted from the network thread; give it time to catch up
+    session.wait_for_alert(lt::milliseconds(100));
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+}
+
+void bench_alerts(const Options& options, lt::session& session, std::vector<lt::torrent_handle>& handles) {
+    bool paused = true;
+
+    auto toggle = [&]() {
+        for (lt::torrent_handle& handle : handles) {
+            if (paused) {
+                handle.resume();
+            } else {
+                handle.pause();
+            }
+        }
+        paused = !paused;
+    };
+
+    // Drop whatever adding the torrents produced
+    settle(session);
+    convert_alerts(session);
+
+    measure(options, "get_alerts_session_stats", options.iterations,
+        [&]() { session.post_session_stats(); settle(session); },
+        [&]() { return convert_alerts(session); });
+
+    measure(options, "get_alerts_state_updates", options.iterations,
+        [&]() { toggle(); session.post_torrent_updates(); settle(session); },
+        [&]() { return convert_alerts(session); });
+
+    measure(options, "get_alerts_mixed", options.iterations,
+        [&]() { toggle(); session.post_torrent_updates(); session.post_session_stats(); settle(session); },
+        [&]() { return convert_alerts(session); });
+
+    measure(options, "get_alerts_empty", options.iterations * 10, nullptr,
+        [&]() { return convert_alerts(session); });
+}
+
+void bench_status(const Options& options, lt::torrent_handle& handle) {
+    measure(options, "torrent_status", options.iterations * 10, nullptr, [&]() {
+        lt::torrent_status status = handle.status(lt::status_flags_t{});
+        // TorrentHandle::get_status keeps a heap copy for TorrentStatus
+        std::unique_ptr<lt::torrent_status> copy(new lt::torrent_status(status));
+        return static_cast<int64_t>(copy->state != lt::torrent_status::checking_files);
+    });
+}
+
+void bench_peers(const Options& options, lt::torrent_handle& handle) {
+    std::vector<lt::peer_info> synthetic(200);
+    for (size_t i = 0; i < synthetic.size(); i++) {
+        synthetic[i].ip = lt::tcp::endpoint(lt::make_address_v4("10.0.0.1"), static_cast<unsigned short>(6881 + i));
+        synthetic[i].client = "libtorrent/2.0.0.0";
+        synthetic[i].progress = 0.5f;
+    }
+
+    // Round trip to the network thread (the torrent has no peers)
+    measure(options, "get_peer_info_call", options.iterations * 10, nullptr, [&]() {
+        std::vector<lt::peer_info> peers;
+        handle.get_peer_info(peers);
+        return static_cast<int64_t>(peers.size());
+    });
+
+    // Per-peer work of TorrentHandle::get_peer_info plus the common PeerInfo getters
+    measure(options, "get_peer_info_200", options.iterations, nullptr, [&]() {
+        size_t sink = 0;
+        for (const lt::peer_info& peer : synthetic) {
+            auto copy = std::make_shared<lt::peer_info>(peer);
+            sink += copy->ip.address().to_string().size() + copy->client.size();
+        }
+        g_sink = g_sink + sink;
+        return static_cast<int64_t>(synthetic.size());
+    });
+}
+
+void bench_files(const Options& options, const lt::torrent_info& info) {
+    measure(options, "get_files_100k", std::max(1, options.iterations / 20), nullptr, [&]() {
+        lt::file_storage const& fs = info.files();
+        size_t sink = 0;
+        for (int i = 0; i < fs.num_files(); i++) {
+            lt::file_index_t index(i);
+            sink += fs.file_path(index).size();
+            sink += static_cast<size_t>(fs.file_size(index) + fs.file_offset(index));
+            sink += fs.pad_file_at(index) ? 1 : 0;
+            sink += static_cast<bool>(fs.file_flags(index) & lt::file_storage::flag_hidden) ? 1 : 0;
+        }
+        g_sink = g_sink + sink;
+        return static_cast<int64_t>(fs.num_files());
+    });
+}
+
+void bench_parse(const Options& options, lt::session& session,
+        const std::vector<char>& small_torrent, const std::vector<char>& large_torrent) {
+    measure(options, "parse_torrent_small", options.iterations * 10, nullptr, [&]() {
+        return static_cast<int64_t>(parse_torrent(small_torrent)->num_files());
+    });
+
+    measure(options, "parse_torrent_100k", std::max(1, options.iterations / 20), nullptr, [&]() {
+        return static_cast<int64_t>(parse_torrent(large_torrent)->num_files());
+    });
+
+    // Parse plus the synchronous add, as add_torrent_file does
+    lt::torrent_handle added;
+    measure(options, "add_torrent_file_small", options.iterations,
+        [&]() {
+            if (added.is_valid()) {
+                session.remove_torrent(added);
+                added = lt::torrent_handle();
+            }
+        },
+        [&]() {
+            lt::error_code ec;
+            added = session.add_torrent(paused_params(parse_torrent(small_torrent)), ec);
+            return static_cast<int64_t>(!ec);
+        });
+    if (added.is_valid()) {
+        session.remove_torrent(added);
+    }
+}
+
+void print_json(const Options& options) {
+    std::printf("{\"benchmark\":\"micro\",\"libtorrent\":\"%s\",\"iterations\":%d,\"files\":%d,\"results\":[",
+        LIBTORRENT_VERSION, options.iterations, options.files);
+
+    for (size_t i = 0; i < g_results.size(); i++) {
+        const Result& result = g_results[i];
+        double per_item_ns = result.items > 0 ? result.mean_us * 1000.0 / static_cast<double>(result.items) : 0.0;
+
+        std::printf("%s{\"name\":\"%s\",\"iterations\":%d,\"items\":%lld,\"mean_us\":%.3f,"
+            "\"median_us\":%.3f,\"p99_us\":%.3f,\"per_item_ns\":%.1f}",
+            i == 0 ? "" : ",", result.name.c_str(), result.iterations,
+            static_cast<long long>(result.items), result.mean_us, result.median_us,
+            result.p99_us, per_item_ns);
+    }
+
+    std::printf("]}\n");
+}
+
+bool parse_int(const char* value, int& out) {
+    char* end = nullptr;
+    long parsed = std::strtol(value, &end, 10);
+    if (!end || *end != '\0' || parsed <= 0) {
+        return false;
+    }
+    out = static_cast<int>(parsed);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "--help" || arg == "-h") {
+            std::printf("Usage: %s [--iterations N] [--files N] [--filter NAME]\n", argv[0]);
+            return 0;
+        }
+
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "error: %s needs a value\n", arg.c_str());
+            return 2;
+        }
+        const char* value = argv[++i];
+
+        bool ok = true;
+        if (arg == "--filter") {
+            options.filter = value;
+        } else if (arg == "--iterations") {
+            ok = parse_int(value, options.iterations);
+        } else if (arg == "--files") {
+            ok = parse_int(value, options.files);
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            std::fprintf(stderr, "error: invalid option %s %s\n", arg.c_str(), value);
+            return 2;
+        }
+    }
+
+    lt::settings_pack settings;
+    settings.set_str(lt::settings_pack::listen_interfaces, "127.0.0.1:0");
+    settings.set_bool(lt::settings_pack::enable_dht, false);
+    settings.set_bool(lt::settings_pack::enable_lsd, false);
+    settings.set_bool(lt::settings_pack::enable_upnp, false);
+    settings.set_bool(lt::settings_pack::enable_natpmp, false);
+    settings.set_int(lt::settings_pack::alert_mask,
+        lt::alert_category::error | lt::alert_category::status | lt::alert_category::stats);
+    settings.set_int(lt::settings_pack::alert_queue_size, 100000);
+
+    lt::session session(settings);
+
+    std::fprintf(stderr, "generating torrents...\n");
+    std::vector<char> small_torrent = make_torrent("small", 1, 16 * 1024 * 1024);
+    std::vector<char> large_torrent = make_torrent("large", options.files, 1024);
+
+    // 100 paused torrents give state updates a realistic size
+    std::vector<lt::torrent_handle> handles;
+    for (int i = 0; i < 100; i++) {
+        auto info = parse_torrent(make_torrent("torrent_" + std::to_string(i), 4, 256 * 1024));
+        handles.push_back(session.add_torrent(paused_params(info)));
+    }
+
+    bench_alerts(options, session, handles);
+    bench_status(options, handles.front());
+    bench_peers(options, handles.front());
+    bench_files(options, *parse_torrent(large_torrent));
+    bench_parse(options, session, small_torrent, large_torrent);
+
+    for (lt::torrent_handle& handle : handles) {
+        session.remove_torrent(handle);
+    }
+
+    print_json(options);
+    return 0;
+}